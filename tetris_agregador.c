@@ -0,0 +1,372 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+// Se estivermos no windows, vamos incluir usar uma saída de console com padrão adequado para utf-8.
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "tetris_colunas.h"
+#include "tetris_memoria.h"
+#include "tetris_metricas.h"
+#include "tetris_tempo.h"
+
+// Desafio Tetris Stack
+// Agregador das colunas exportadas(tetris_colunas.h): contagens e histogramas sobre todas as linhas.
+//
+// As colunas são lidas em blocos de LINHAS_POR_BLOCO_AGREGADOR linhas. Para cada bloco, laços simples(sem
+// desvios, vetorizáveis) combinam as colunas em chaves de 1 byte, e cada chave é contada em um histograma
+// de TOTAL_CHAVES posições. A contagem divide o bloco entre as threads(OpenMP), cada uma com os seus
+// histogramas locais, somados ao final. As estatísticas:
+//   ação x resultado: quantas ações de cada tipo foram efetuadas ou abortadas, e por quê(ex: reservas
+//                     abortadas com a pilha cheia).
+//   tipos por ação:   frequência dos tipos das peças nas ações efetuadas.
+//   ocupação:         distribuição conjunta da ocupação da fila e da pilha após as ações.
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de linhas lidas de cada coluna por bloco.
+#define LINHAS_POR_BLOCO_AGREGADOR (1 << 20)
+
+/// @brief Quantidade de posições de cada histograma(chaves de 6 bits).
+#define TOTAL_CHAVES 64
+
+/// @brief Histogramas locais de cada thread, contados alternadamente: incrementos consecutivos da mesma
+/// chave não dependem um do outro.
+#define TOTAL_HISTOGRAMAS_LOCAIS 4
+
+/// @brief Índice dos tipos nas chaves(na ordem de TIPOS_PECA), e o índice das linhas sem peça.
+#define TOTAL_INDICES_TIPO 5
+
+/// @brief Ocupações possíveis da fila e da pilha(de 0 à capacidade).
+#define TOTAL_OCUPACOES_FILA (TAM_MAX_FILA + 1)
+#define TOTAL_OCUPACOES_PILHA (TAM_MAX_PILHA + 1)
+
+// **** Declarações de estruturas. ****
+
+/// @brief Blocos das colunas lidas, e das chaves calculadas.
+typedef struct {
+	uint8_t* colunas[TOTAL_COLUNAS];
+	uint8_t* chavesResultado;
+	uint8_t* chavesTipo;
+	uint8_t* chavesOcupacao;
+} BlocosAgregador;
+
+/// @brief Totais acumulados de todas as linhas.
+typedef struct {
+	uint64_t resultados[TOTAL_CHAVES];
+	uint64_t tipos[TOTAL_CHAVES];
+	uint64_t ocupacoes[TOTAL_CHAVES];
+	uint64_t linhas;
+	int64_t menorId;
+	int64_t maiorId;
+} Agregados;
+
+// **** Declarações das funções. ****
+
+/// @brief Calcula as chaves de um bloco: ação x resultado, ação x tipo(somente as efetuadas) e fila x pilha.
+/// @param BlocosAgregador. Ponteiro via referência, com as colunas lidas e as chaves a serem preenchidas.
+/// @param Inteiro. Quantidade de linhas do bloco.
+void calcularChaves(BlocosAgregador* blocos, int64_t linhas);
+/// @brief Conta as chaves de um bloco e acumula no histograma, com as linhas divididas entre as threads.
+/// @param Inteiro. Chaves do bloco(menores que TOTAL_CHAVES). Somente leitura.
+/// @param Inteiro. Quantidade de linhas do bloco.
+/// @param Inteiro. Histograma de TOTAL_CHAVES posições, a ser acumulado.
+void contarChaves(const uint8_t* chaves, int64_t linhas, uint64_t* histograma);
+/// @brief Acumula o menor e o maior id das linhas com peça.
+/// @param Inteiro. Coluna id do bloco(8 bytes por linha, little-endian). Somente leitura.
+/// @param Inteiro. Quantidade de linhas do bloco.
+/// @param Agregados. Ponteiro via referência, com a faixa de ids a ser atualizada.
+void acumularFaixaIds(const uint8_t* ids, int64_t linhas, Agregados* agregados);
+/// @brief Exibe as estatísticas agregadas.
+/// @param Agregados. Ponteiro dos totais. Somente leitura.
+void mostrarAgregados(const Agregados* agregados);
+
+/// @brief Ponto de entrada do programa.
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: PREFIXO(das colunas exportadas por tetris_mestre --colunas).
+/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, em caso de falha. Ex: EXIT_FAILURE.
+int main(int argc, char* argv[]);
+
+// **** Implementações das funções. ****
+
+int main(int argc, char* argv[]) {
+
+	// Configurações de caracteres para ajuste de ortografia para saída do console(UTF-8).
+#ifdef _WIN32
+	// Plataforma Windows.
+	SetConsoleOutputCP(CP_UTF8);
+#endif
+
+	if (argc != 2)
+	{
+		printf("Uso: %s PREFIXO\n", argv[0]);
+		printf("Ex: %s partidas(lê partidas.acao, partidas.resultado, partidas.tipo, ...)\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	const char* prefixo = argv[1];
+
+	LeitorColuna leitores[TOTAL_COLUNAS];
+	for (int c = 0; c < TOTAL_COLUNAS; c++)
+	{
+		if (!abrirLeitorColuna(&leitores[c], prefixo, (CodigoColuna)c))
+		{
+			printf("\n==== ⚠️  Coluna inválida ou inexistente: %s.%s. ====\n", prefixo, nomeColuna((CodigoColuna)c));
+			return EXIT_FAILURE;
+		}
+		if (leitores[c].totalLinhas != leitores[COLUNA_ACAO].totalLinhas)
+		{
+			printf("\n==== ⚠️  As colunas de %s têm quantidades de linhas diferentes. ====\n", prefixo);
+			return EXIT_FAILURE;
+		}
+	}
+
+	BlocosAgregador blocos;
+	bool alocados = true;
+	for (int c = 0; c < TOTAL_COLUNAS; c++)
+	{
+		blocos.colunas[c] = alocarMemoria((size_t)LINHAS_POR_BLOCO_AGREGADOR * (size_t)larguraColuna((CodigoColuna)c));
+		alocados = alocados && blocos.colunas[c] != NULL;
+	}
+	blocos.chavesResultado = alocarMemoria(LINHAS_POR_BLOCO_AGREGADOR);
+	blocos.chavesTipo = alocarMemoria(LINHAS_POR_BLOCO_AGREGADOR);
+	blocos.chavesOcupacao = alocarMemoria(LINHAS_POR_BLOCO_AGREGADOR);
+	if (!alocados || blocos.chavesResultado == NULL || blocos.chavesTipo == NULL || blocos.chavesOcupacao == NULL)
+	{
+		printf("\n==== ⚠️  Memória insuficiente para os blocos das colunas. ====\n");
+		return EXIT_FAILURE;
+	}
+
+	int threads = 1;
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#endif
+
+	Agregados agregados;
+	memset(&agregados, 0, sizeof(agregados));
+	agregados.menorId = INT64_MAX;
+	agregados.maiorId = 0;
+
+	int64_t inicioNs = relogioMonotonicoNs();
+	int64_t leituraNs = 0;
+	bool sucesso = true;
+	for (;;)
+	{
+		int64_t inicioLeituraNs = relogioMonotonicoNs();
+		int64_t linhas = lerColuna(&leitores[COLUNA_ACAO], blocos.colunas[COLUNA_ACAO], LINHAS_POR_BLOCO_AGREGADOR);
+		for (int c = 1; c < TOTAL_COLUNAS && linhas > 0; c++)
+		{
+			sucesso = lerColuna(&leitores[c], blocos.colunas[c], linhas) == linhas;
+			linhas = sucesso ? linhas : -1;
+		}
+		leituraNs += relogioMonotonicoNs() - inicioLeituraNs;
+		if (linhas <= 0)
+		{
+			sucesso = linhas == 0;
+			break;
+		}
+
+		calcularChaves(&blocos, linhas);
+		contarChaves(blocos.chavesResultado, linhas, agregados.resultados);
+		contarChaves(blocos.chavesTipo, linhas, agregados.tipos);
+		contarChaves(blocos.chavesOcupacao, linhas, agregados.ocupacoes);
+		acumularFaixaIds(blocos.colunas[COLUNA_ID], linhas, &agregados);
+		agregados.linhas += (uint64_t)linhas;
+	}
+	int64_t duracaoNs = relogioMonotonicoNs() - inicioNs;
+
+	if (!sucesso)
+	{
+		printf("\n==== ⚠️  Falha na leitura das colunas de %s(arquivo truncado?). ====\n", prefixo);
+	}
+	else
+	{
+		printf("==== Agregador: %llu linhas, %d threads. ====\n", (unsigned long long)agregados.linhas, threads);
+		mostrarAgregados(&agregados);
+
+		int64_t contagemNs = duracaoNs - leituraNs;
+		printf("\nDuração: %.3f s(leitura %.3f s, contagem %.3f s). Contagem: %.0f milhões de linhas por segundo.\n",
+			duracaoNs / 1e9, leituraNs / 1e9, contagemNs / 1e9,
+			contagemNs > 0 ? agregados.linhas * 1e3 / contagemNs : 0.0);
+	}
+
+	for (int c = 0; c < TOTAL_COLUNAS; c++)
+	{
+		fecharLeitorColuna(&leitores[c]);
+		liberarMemoria(blocos.colunas[c]);
+	}
+	liberarMemoria(blocos.chavesResultado);
+	liberarMemoria(blocos.chavesTipo);
+	liberarMemoria(blocos.chavesOcupacao);
+	return sucesso ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void calcularChaves(BlocosAgregador* blocos, int64_t linhas)
+{
+	const uint8_t* acoes = blocos->colunas[COLUNA_ACAO];
+	const uint8_t* resultados = blocos->colunas[COLUNA_RESULTADO];
+	const uint8_t* tipos = blocos->colunas[COLUNA_TIPO];
+	const uint8_t* filas = blocos->colunas[COLUNA_FILA];
+	const uint8_t* pilhas = blocos->colunas[COLUNA_PILHA];
+	uint8_t* chavesResultado = blocos->chavesResultado;
+	uint8_t* chavesTipo = blocos->chavesTipo;
+	uint8_t* chavesOcupacao = blocos->chavesOcupacao;
+
+	// Somente comparações, deslocamentos e máscaras: os laços são vetorizados pelo compilador.
+	for (int64_t i = 0; i < linhas; i++)
+	{
+		chavesResultado[i] = (uint8_t)(((acoes[i] << 3) | resultados[i]) & (TOTAL_CHAVES - 1));
+	}
+	for (int64_t i = 0; i < linhas; i++)
+	{
+		uint8_t tipo = tipos[i];
+		uint8_t indice = (uint8_t)((tipo == 'O') + 2 * (tipo == 'T') + 3 * (tipo == 'L') + 4 * (tipo == 0));
+		// As ações abortadas vão para a chave 0(ação 0 não é exportada), descartada na exibição.
+		uint8_t efetuada = (uint8_t)(resultados[i] == RESULTADO_SUCESSO);
+		chavesTipo[i] = (uint8_t)((((acoes[i] << 3) | indice) & (TOTAL_CHAVES - 1)) * efetuada);
+	}
+	for (int64_t i = 0; i < linhas; i++)
+	{
+		chavesOcupacao[i] = (uint8_t)(((filas[i] << 2) | (pilhas[i] & 3)) & (TOTAL_CHAVES - 1));
+	}
+}
+
+void contarChaves(const uint8_t* chaves, int64_t linhas, uint64_t* histograma)
+{
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	{
+		uint32_t locais[TOTAL_HISTOGRAMAS_LOCAIS][TOTAL_CHAVES] = { { 0 } };
+
+		// Contadores de 32 bits bastam: cada thread conta no máximo LINHAS_POR_BLOCO_AGREGADOR linhas.
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+		for (int64_t i = 0; i < linhas / TOTAL_HISTOGRAMAS_LOCAIS; i++)
+		{
+			const uint8_t* grupo = &chaves[i * TOTAL_HISTOGRAMAS_LOCAIS];
+			locais[0][grupo[0]]++;
+			locais[1][grupo[1]]++;
+			locais[2][grupo[2]]++;
+			locais[3][grupo[3]]++;
+		}
+
+#ifdef _OPENMP
+#pragma omp critical(histogramaAgregador)
+#endif
+		for (int k = 0; k < TOTAL_CHAVES; k++)
+		{
+			histograma[k] += (uint64_t)locais[0][k] + locais[1][k] + locais[2][k] + locais[3][k];
+		}
+	}
+
+	// Linhas restantes do bloco(menos que TOTAL_HISTOGRAMAS_LOCAIS).
+	for (int64_t i = linhas - linhas % TOTAL_HISTOGRAMAS_LOCAIS; i < linhas; i++)
+	{
+		histograma[chaves[i]]++;
+	}
+}
+
+void acumularFaixaIds(const uint8_t* ids, int64_t linhas, Agregados* agregados)
+{
+	int64_t menor = agregados->menorId, maior = agregados->maiorId;
+	for (int64_t i = 0; i < linhas; i++)
+	{
+		const uint8_t* b = &ids[8 * i];
+		int64_t id = (int64_t)((uint64_t)b[0] | (uint64_t)b[1] << 8 | (uint64_t)b[2] << 16 | (uint64_t)b[3] << 24
+			| (uint64_t)b[4] << 32 | (uint64_t)b[5] << 40 | (uint64_t)b[6] << 48 | (uint64_t)b[7] << 56);
+		// Linhas sem peça(id 0) não alteram o menor id.
+		int64_t candidato = id != 0 ? id : INT64_MAX;
+		menor = candidato < menor ? candidato : menor;
+		maior = id > maior ? id : maior;
+	}
+	agregados->menorId = menor;
+	agregados->maiorId = maior;
+}
+
+void mostrarAgregados(const Agregados* agregados)
+{
+	double totalLinhas = agregados->linhas > 0 ? (double)agregados->linhas : 1.0;
+
+	printf("\n==== Ações x resultados ====\n");
+	printf("%-27s %12s %9s", "Ação", "Total", "Êxito");
+	for (int r = 1; r < TOTAL_RESULTADOS - 1; r++)
+	{
+		printf(" %20s", nomeResultado((ResultadoAcao)r));
+	}
+	printf("\n");
+	uint64_t totaisAcao[TOTAL_ACOES] = { 0 };
+	for (int a = ACAO_JOGAR_PECA; a < TOTAL_ACOES; a++)
+	{
+		for (int r = 0; r < TOTAL_RESULTADOS; r++)
+		{
+			totaisAcao[a] += agregados->resultados[(a << 3) | r];
+		}
+		double total = totaisAcao[a] > 0 ? (double)totaisAcao[a] : 1.0;
+		// Nome com acentos: o alinhamento usa a largura em bytes, como na tabela de estatísticas do Mestre.
+		printf("%-25s %12llu %7.2f%%", nomeMetrica((CodigoMetrica)(a - ACAO_JOGAR_PECA)),
+			(unsigned long long)totaisAcao[a], 100.0 * agregados->resultados[a << 3] / total);
+		for (int r = 1; r < TOTAL_RESULTADOS - 1; r++)
+		{
+			printf(" %19.2f%%", 100.0 * agregados->resultados[(a << 3) | r] / total);
+		}
+		printf("\n");
+	}
+
+	uint64_t reservas = totaisAcao[ACAO_RESERVAR_PECA];
+	uint64_t reservasPilhaCheia = agregados->resultados[(ACAO_RESERVAR_PECA << 3) | RESULTADO_PILHA_CHEIA];
+	uint64_t trocas = agregados->resultados[ACAO_TROCAR_PECA_RESERVADA << 3];
+	uint64_t trocasGrupo = agregados->resultados[ACAO_TROCAR_PECAS_RESERVADAS << 3];
+	printf("\nReservas abortadas com a pilha cheia: %llu de %llu reservas(%.2f%%).\n",
+		(unsigned long long)reservasPilhaCheia, (unsigned long long)reservas,
+		reservas > 0 ? 100.0 * reservasPilhaCheia / reservas : 0.0);
+	printf("Trocas efetuadas: %llu simples(%.2f%% das ações) e %llu em grupo(%.2f%% das ações).\n",
+		(unsigned long long)trocas, 100.0 * trocas / totalLinhas,
+		(unsigned long long)trocasGrupo, 100.0 * trocasGrupo / totalLinhas);
+
+	printf("\n==== Tipos das peças nas ações efetuadas ====\n");
+	printf("%-27s", "Ação");
+	for (int t = 0; t < TOTAL_INDICES_TIPO - 1; t++)
+	{
+		printf(" %8c", TIPOS_PECA[t]);
+	}
+	printf("\n");
+	for (int a = ACAO_JOGAR_PECA; a < TOTAL_ACOES; a++)
+	{
+		uint64_t efetuadas = agregados->resultados[a << 3];
+		printf("%-25s", nomeMetrica((CodigoMetrica)(a - ACAO_JOGAR_PECA)));
+		for (int t = 0; t < TOTAL_INDICES_TIPO - 1; t++)
+		{
+			printf(" %7.2f%%", efetuadas > 0 ? 100.0 * agregados->tipos[(a << 3) | t] / efetuadas : 0.0);
+		}
+		printf("\n");
+	}
+
+	printf("\n==== Ocupação após as ações(linhas: fila, colunas: pilha) ====\n");
+	printf("%6s", "");
+	for (int p = 0; p < TOTAL_OCUPACOES_PILHA; p++)
+	{
+		printf(" %8d", p);
+	}
+	printf("\n");
+	for (int f = 0; f < TOTAL_OCUPACOES_FILA; f++)
+	{
+		printf("%6d", f);
+		for (int p = 0; p < TOTAL_OCUPACOES_PILHA; p++)
+		{
+			printf(" %7.2f%%", 100.0 * agregados->ocupacoes[(f << 2) | p] / totalLinhas);
+		}
+		printf("\n");
+	}
+
+	if (agregados->maiorId > 0)
+	{
+		printf("\nIds das peças: de %" PRId64 " a %" PRId64 ".\n", agregados->menorId, agregados->maiorId);
+	}
+}
@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_ambiente.h"
+#include "tetris_memoria.h"
+#include "tetris_rastro.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Constante ímpar usada para derivar a semente de cada ambiente a partir da semente base.
+#define PASSO_SEMENTE_AMBIENTE 0xD1B54A32D192ED03ULL
+
+/// @brief Recompensa de cada ação efetuada com sucesso, indexada por CodigoAcao.
+static const float recompensaAcao[TOTAL_ACOES] = {
+	0.0f,                       // Sair(nunca efetuada).
+	RECOMPENSA_PECA_UTILIZADA,  // Jogar.
+	0.0f,                       // Reservar.
+	RECOMPENSA_PECA_UTILIZADA,  // Usar.
+	0.0f,                       // Trocar.
+	0.0f                        // Trocar grupos.
+};
+
+// **** Implementações das funções. ****
+
+/// @brief Sorteia uma nova peça para o ambiente, na posição informada da fila.
+static inline void reporPeca(Ambientes* a, int ambiente, int posicao)
+{
+	a->filaTipo[ambiente * TAM_MAX_FILA + posicao] = (uint8_t)sortearCodigoPeca(&a->geradores[ambiente]);
+	a->filaId[ambiente * TAM_MAX_FILA + posicao] = alocarIdPeca(&a->ids[ambiente]);
+}
+
+/// @brief Reinicia um ambiente: fila cheia com novas peças, pilha vazia. A sequência de peças
+/// e as identificações continuam.
+static void reiniciarAmbiente(Ambientes* a, int ambiente)
+{
+	a->filaInicio[ambiente] = 0;
+	for (int i = 0; i < TAM_MAX_FILA; i++)
+	{
+		reporPeca(a, ambiente, i);
+	}
+	a->pilhaTopo[ambiente] = -1;
+	a->trocou[ambiente] = 0;
+	a->passos[ambiente] = 0;
+	inicializarPontuacao(&a->pontuacoes[ambiente]);
+}
+
+/// @brief Escreve a observação de um ambiente.
+static inline void observarAmbiente(const Ambientes* a, int ambiente, uint8_t* observacao)
+{
+	const uint8_t* fila = &a->filaTipo[ambiente * TAM_MAX_FILA];
+	const uint8_t* pilha = &a->pilhaTipo[ambiente * TAM_MAX_PILHA];
+	int inicio = a->filaInicio[ambiente];
+	int topo = a->pilhaTopo[ambiente];
+
+	for (int i = 0; i < TAM_MAX_FILA; i++)
+	{
+		int idx = inicio + i;
+		observacao[i] = fila[idx < TAM_MAX_FILA ? idx : idx - TAM_MAX_FILA];
+	}
+	// Sem desvio: as posições acima do topo são zeradas pela máscara.
+	for (int i = 0; i < TAM_MAX_PILHA; i++)
+	{
+		uint8_t ocupada = (uint8_t)-(i <= topo);
+		observacao[TAM_MAX_FILA + i] = (uint8_t)((pilha[i] + 1) & ocupada);
+	}
+	observacao[TAM_MAX_FILA + TAM_MAX_PILHA] = a->trocou[ambiente];
+}
+
+/// @brief Aplica uma ação a um ambiente.
+/// @returns float. Recompensa da ação.
+static inline float aplicarAcaoAmbiente(Ambientes* a, int ambiente, int acao)
+{
+	int32_t pontos = 0;
+	int topo = a->pilhaTopo[ambiente];
+	int inicio = a->filaInicio[ambiente];
+
+	// Validade de todas as ações, sem desvios. A fila está sempre cheia.
+	bool valida = (acao == ACAO_JOGAR_PECA)
+		| ((acao == ACAO_RESERVAR_PECA) & (topo < TAM_MAX_PILHA - 1))
+		| (((acao == ACAO_USAR_PECA_RESERVADA) | (acao == ACAO_TROCAR_PECA_RESERVADA)) & (topo >= 0))
+		| ((acao == ACAO_TROCAR_PECAS_RESERVADAS) & (topo == TAM_MAX_PILHA - 1));
+
+	if (!valida)
+	{
+		return RECOMPENSA_ACAO_CANCELADA;
+	}
+
+	uint8_t* filaTipo = &a->filaTipo[ambiente * TAM_MAX_FILA];
+	int64_t* filaId = &a->filaId[ambiente * TAM_MAX_FILA];
+	uint8_t* pilhaTipo = &a->pilhaTipo[ambiente * TAM_MAX_PILHA];
+	int64_t* pilhaId = &a->pilhaId[ambiente * TAM_MAX_PILHA];
+	int proximo = inicio + 1 < TAM_MAX_FILA ? inicio + 1 : 0;
+
+	switch (acao)
+	{
+	case ACAO_RESERVAR_PECA:
+		// A peça da frente vai para a pilha e, como em jogar, é reposta no fim(mesma posição do anel, pois a fila está cheia).
+		pilhaTipo[topo + 1] = filaTipo[inicio];
+		pilhaId[topo + 1] = filaId[inicio];
+		a->pilhaTopo[ambiente] = (int8_t)(topo + 1);
+		a->trocou[ambiente] = 0;
+		reporPeca(a, ambiente, inicio);
+		a->filaInicio[ambiente] = (uint8_t)proximo;
+		break;
+	case ACAO_JOGAR_PECA:
+		pontos = pontuarColocacao(&a->pontuacoes[ambiente], TIPOS_PECA[filaTipo[inicio]], false);
+		reporPeca(a, ambiente, inicio);
+		a->filaInicio[ambiente] = (uint8_t)proximo;
+		break;
+	case ACAO_USAR_PECA_RESERVADA:
+		pontos = pontuarColocacao(&a->pontuacoes[ambiente], TIPOS_PECA[pilhaTipo[topo]], true);
+		a->pilhaTopo[ambiente] = (int8_t)(topo - 1);
+		break;
+	case ACAO_TROCAR_PECA_RESERVADA:
+	{
+		uint8_t tipo = filaTipo[inicio];
+		int64_t id = filaId[inicio];
+		filaTipo[inicio] = pilhaTipo[topo];
+		filaId[inicio] = pilhaId[topo];
+		pilhaTipo[topo] = tipo;
+		pilhaId[topo] = id;
+		break;
+	}
+	default:
+	{
+		// Troca em grupo, com a mesma regra de inversão do núcleo(ver trocarPecasReservadas).
+		uint8_t tiposFila[TAM_MAX_PILHA], tiposPilha[TAM_MAX_PILHA];
+		int64_t idsFila[TAM_MAX_PILHA], idsPilha[TAM_MAX_PILHA];
+		int trocou = a->trocou[ambiente];
+
+		for (int i = 0, idx = inicio; i < TAM_MAX_PILHA; i++, idx = idx + 1 < TAM_MAX_FILA ? idx + 1 : 0)
+		{
+			tiposFila[i] = filaTipo[idx];
+			idsFila[i] = filaId[idx];
+			tiposPilha[i] = pilhaTipo[i];
+			idsPilha[i] = pilhaId[i];
+		}
+		for (int i = 0, idx = inicio; i < TAM_MAX_PILHA; i++, idx = idx + 1 < TAM_MAX_FILA ? idx + 1 : 0)
+		{
+			int origem = trocou ? TAM_MAX_PILHA - 1 - i : i;
+			filaTipo[idx] = tiposPilha[TAM_MAX_PILHA - 1 - i];
+			filaId[idx] = idsPilha[TAM_MAX_PILHA - 1 - i];
+			pilhaTipo[i] = tiposFila[origem];
+			pilhaId[i] = idsFila[origem];
+		}
+		a->trocou[ambiente] = 1;
+		break;
+	}
+	}
+
+	// Os pontos de uma colocação cabem na mantissa do float(muito abaixo de 2^24).
+	return a->modoRecompensa == RECOMPENSA_POR_PONTOS ? (float)pontos : recompensaAcao[acao];
+}
+
+bool criarAmbientes(Ambientes* ambientes, int total, uint64_t semente, int limiteEpisodio,
+	const uint16_t pesos[TOTAL_TIPOS_PECA])
+{
+	memset(ambientes, 0, sizeof(*ambientes));
+	// Pesos inválidos(todos zero) são recusados antes das alocações.
+	GeradorPecas validacao;
+	if (total <= 0 || limiteEpisodio <= 0 || !definirPesosGerador(&validacao, pesos))
+	{
+		return false;
+	}
+
+	size_t n = (size_t)total;
+	ambientes->total = total;
+	ambientes->limiteEpisodio = limiteEpisodio;
+	ambientes->modoRecompensa = RECOMPENSA_POR_PECA;
+	ambientes->filaTipo = alocarMemoria(n * TAM_MAX_FILA * sizeof(uint8_t));
+	ambientes->filaId = alocarMemoria(n * TAM_MAX_FILA * sizeof(int64_t));
+	ambientes->filaInicio = alocarMemoria(n * sizeof(uint8_t));
+	ambientes->pilhaTipo = alocarMemoria(n * TAM_MAX_PILHA * sizeof(uint8_t));
+	ambientes->pilhaId = alocarMemoria(n * TAM_MAX_PILHA * sizeof(int64_t));
+	ambientes->pilhaTopo = alocarMemoria(n * sizeof(int8_t));
+	ambientes->ids = alocarMemoria(n * sizeof(AlocadorIds));
+	ambientes->trocou = alocarMemoria(n * sizeof(uint8_t));
+	ambientes->passos = alocarMemoria(n * sizeof(int32_t));
+	ambientes->geradores = alocarMemoria(n * sizeof(GeradorPecas));
+	ambientes->pontuacoes = alocarMemoria(n * sizeof(Pontuacao));
+
+	if (ambientes->filaTipo == NULL || ambientes->filaId == NULL || ambientes->filaInicio == NULL
+		|| ambientes->pilhaTipo == NULL || ambientes->pilhaId == NULL || ambientes->pilhaTopo == NULL
+		|| ambientes->ids == NULL || ambientes->trocou == NULL || ambientes->passos == NULL
+		|| ambientes->geradores == NULL || ambientes->pontuacoes == NULL)
+	{
+		destruirAmbientes(ambientes);
+		return false;
+	}
+
+	// Posições vazias da pilha zeradas, para observações determinísticas.
+	memset(ambientes->pilhaTipo, 0, n * TAM_MAX_PILHA * sizeof(uint8_t));
+	memset(ambientes->pilhaId, 0, n * TAM_MAX_PILHA * sizeof(int64_t));
+
+	for (int i = 0; i < total; i++)
+	{
+		inicializarGerador(&ambientes->geradores[i], semente + (uint64_t)i * PASSO_SEMENTE_AMBIENTE);
+		definirPesosGerador(&ambientes->geradores[i], pesos);
+		inicializarAlocadorIds(&ambientes->ids[i]);
+		reiniciarAmbiente(ambientes, i);
+	}
+
+	return true;
+}
+
+void destruirAmbientes(Ambientes* ambientes)
+{
+	liberarMemoria(ambientes->filaTipo);
+	liberarMemoria(ambientes->filaId);
+	liberarMemoria(ambientes->filaInicio);
+	liberarMemoria(ambientes->pilhaTipo);
+	liberarMemoria(ambientes->pilhaId);
+	liberarMemoria(ambientes->pilhaTopo);
+	liberarMemoria(ambientes->ids);
+	liberarMemoria(ambientes->trocou);
+	liberarMemoria(ambientes->passos);
+	liberarMemoria(ambientes->geradores);
+	liberarMemoria(ambientes->pontuacoes);
+	memset(ambientes, 0, sizeof(*ambientes));
+}
+
+void observarAmbientes(const Ambientes* ambientes, int quantidade, uint8_t* observacoes)
+{
+	if (quantidade > ambientes->total)
+	{
+		quantidade = ambientes->total;
+	}
+	for (int i = 0; i < quantidade; i++)
+	{
+		observarAmbiente(ambientes, i, &observacoes[(size_t)i * TAM_OBSERVACAO_AMBIENTE]);
+	}
+}
+
+void avancarAmbientes(Ambientes* ambientes, const uint8_t* acoes, int quantidade,
+	uint8_t* observacoes, float* recompensas, uint8_t* terminados)
+{
+	if (quantidade > ambientes->total)
+	{
+		quantidade = ambientes->total;
+	}
+
+	iniciarRastro("avancarAmbientes");
+
+	// Cada ambiente é independente: as threads dividem os ambientes em faixas contíguas.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (quantidade >= MIN_AMBIENTES_PARALELO)
+#endif
+	for (int i = 0; i < quantidade; i++)
+	{
+		int acao = acoes[i] < TOTAL_ACOES ? acoes[i] : ACAO_SAIR;
+		recompensas[i] = aplicarAcaoAmbiente(ambientes, i, acao);
+
+		int passos = ++ambientes->passos[i];
+		uint8_t terminado = (uint8_t)(passos >= ambientes->limiteEpisodio);
+		terminados[i] = terminado;
+		if (terminado)
+		{
+			reiniciarAmbiente(ambientes, i);
+		}
+
+		observarAmbiente(ambientes, i, &observacoes[(size_t)i * TAM_OBSERVACAO_AMBIENTE]);
+	}
+
+	finalizarRastro("avancarAmbientes");
+}
@@ -0,0 +1,101 @@
+#ifndef TETRIS_AMBIENTE_H
+#define TETRIS_AMBIENTE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Ambientes vetorizados para treinamento por reforço: N sessões do nível Mestre avançam juntas,
+// uma ação por ambiente a cada passo. Os conteúdos das filas e pilhas ficam em estrutura de vetores
+// (um vetor por campo, para todos os ambientes), e as observações são escritas em buffers contíguos
+// do chamador. Os ambientes usam o gerador de peças em lote(determinístico pela semente), e são
+// reiniciados automaticamente ao final de cada episódio. A recompensa de cada passo é a peça utilizada,
+// ou os pontos ganhos na pontuação(ver ModoRecompensa). Com OpenMP, os ambientes são divididos entre as threads.
+//
+// As regras são as mesmas do núcleo, aproveitando que, no nível Mestre, a fila está sempre cheia:
+// jogar e reservar sempre repõem a peça removida. O teste tetris_teste_ambientes avança cada ambiente em passo
+// com uma sessão(aplicarAcao): uma mudança de regra no núcleo deve ser repetida em aplicarAcaoAmbiente.
+
+// **** Definições de constantes. ****
+
+/// @brief Tamanho da observação de cada ambiente, em bytes: os tipos da fila(da frente para o fim,
+/// códigos de 0 a 3), os tipos da pilha(da base para o topo, código + 1, ou 0 se vazio) e a flag de troca.
+#define TAM_OBSERVACAO_AMBIENTE (TAM_MAX_FILA + TAM_MAX_PILHA + 1)
+
+/// @brief Recompensa por peça utilizada(jogada da fila, ou usada da pilha).
+#define RECOMPENSA_PECA_UTILIZADA 1.0f
+
+/// @brief Recompensa(penalidade) por ação cancelada ou inválida.
+#define RECOMPENSA_ACAO_CANCELADA -1.0f
+
+/// @brief Quantidade mínima de ambientes por passo para a divisão entre threads.
+#define MIN_AMBIENTES_PARALELO 1024
+
+// **** Declarações de estruturas. ****
+
+/// @brief Recompensa dos passos. Em ambos os modos, uma ação cancelada ou inválida vale RECOMPENSA_ACAO_CANCELADA.
+typedef enum {
+	/// @brief RECOMPENSA_PECA_UTILIZADA por peça jogada ou usada, e zero nas demais ações.
+	RECOMPENSA_POR_PECA = 0,
+	/// @brief Pontos ganhos pela colocação(pontuarColocacao), e zero nas ações sem colocação.
+	RECOMPENSA_POR_PONTOS
+} ModoRecompensa;
+
+/// @brief Conjunto de ambientes, em estrutura de vetores. Cada vetor possui um elemento por ambiente,
+/// exceto os itens da fila e da pilha, com TAM_MAX_FILA e TAM_MAX_PILHA elementos por ambiente.
+typedef struct {
+	int total;
+	/// @brief Quantidade de passos de cada episódio.
+	int limiteEpisodio;
+	/// @brief Recompensa dos passos(RECOMPENSA_POR_PECA após criarAmbientes). Pode ser alterada entre os passos.
+	ModoRecompensa modoRecompensa;
+	/// @brief Fila circular(sempre cheia): códigos dos tipos, ids e início.
+	uint8_t* filaTipo;
+	int64_t* filaId;
+	uint8_t* filaInicio;
+	/// @brief Pilha: códigos dos tipos, ids e topo(-1 se vazia).
+	uint8_t* pilhaTipo;
+	int64_t* pilhaId;
+	int8_t* pilhaTopo;
+	/// @brief Alocador das identificações únicas das peças de cada ambiente, mantido entre os episódios.
+	AlocadorIds* ids;
+	uint8_t* trocou;
+	int32_t* passos;
+	GeradorPecas* geradores;
+	/// @brief Pontuação do episódio atual de cada ambiente(ver tetris_pontuacao.h).
+	Pontuacao* pontuacoes;
+} Ambientes;
+
+// **** Declarações das funções. ****
+
+/// @brief Cria e reinicia os ambientes.
+/// @param Ambientes. Ponteiro via referência, para efetuar a inicialização.
+/// @param Inteiro. Quantidade de ambientes.
+/// @param Inteiro. Semente base. Cada ambiente deriva a sua própria sequência de peças.
+/// @param Inteiro. Quantidade de passos de cada episódio.
+/// @param Inteiro. Pesos dos tipos de peça de todos os ambientes(vetor de TOTAL_TIPOS_PECA, ver
+/// definirPesosGerador), ou NULL, para a distribuição uniforme.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória ou se todos os pesos forem zero.
+bool criarAmbientes(Ambientes* ambientes, int total, uint64_t semente, int limiteEpisodio,
+	const uint16_t pesos[TOTAL_TIPOS_PECA]);
+/// @brief Libera a memória dos ambientes.
+/// @param Ambientes. Ponteiro via referência, a ser finalizado.
+void destruirAmbientes(Ambientes* ambientes);
+/// @brief Escreve as observações atuais dos ambientes.
+/// @param Ambientes. Ponteiro usado na leitura. Somente leitura.
+/// @param Inteiro. Quantidade de ambientes observados(os primeiros), até o total.
+/// @param Inteiro. Buffer com TAM_OBSERVACAO_AMBIENTE bytes por ambiente.
+void observarAmbientes(const Ambientes* ambientes, int quantidade, uint8_t* observacoes);
+/// @brief Aplica uma ação a cada um dos primeiros ambientes, e escreve as observações, recompensas e
+/// finais de episódio. Um ambiente cujo episódio terminou é reiniciado, e a sua observação já é a do novo episódio.
+/// @param Ambientes. Ponteiro via referência, dos ambientes.
+/// @param CodigoAcao. Uma ação por ambiente(byte, de 1 a 5). Outros valores são ações inválidas.
+/// @param Inteiro. Quantidade de ambientes a avançar(os primeiros), até o total.
+/// @param Inteiro. Buffer com TAM_OBSERVACAO_AMBIENTE bytes por ambiente.
+/// @param float. Buffer com uma recompensa por ambiente, conforme o modoRecompensa.
+/// @param Inteiro. Buffer com um byte por ambiente: 1 se o episódio terminou neste passo. Caso contrário, 0.
+void avancarAmbientes(Ambientes* ambientes, const uint8_t* acoes, int quantidade,
+	uint8_t* observacoes, float* recompensas, uint8_t* terminados);
+
+#endif // TETRIS_AMBIENTE_H
@@ -0,0 +1,210 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_colunas.h"
+#include "tetris_memoria.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Tamanho máximo do caminho de cada arquivo de coluna.
+#define TAM_MAX_CAMINHO_COLUNA 1024
+
+// **** Variáveis internas. ****
+
+/// @brief Nome(extensão do arquivo) de cada coluna.
+static const char* const nomesColunas[TOTAL_COLUNAS] = { "acao", "resultado", "tipo", "id", "fila", "pilha" };
+
+/// @brief Largura de cada coluna, em bytes.
+static const int largurasColunas[TOTAL_COLUNAS] = { 1, 1, 1, 8, 1, 1 };
+
+// **** Implementações das funções. ****
+
+const char* nomeColuna(CodigoColuna coluna)
+{
+	return nomesColunas[coluna];
+}
+
+int larguraColuna(CodigoColuna coluna)
+{
+	return largurasColunas[coluna];
+}
+
+/// @brief Monta o caminho do arquivo de uma coluna(PREFIXO.nome).
+/// @returns Verdadeiro(true), se o caminho coube no destino. Caso contrário, Falso(false).
+static bool montarCaminhoColuna(char caminho[TAM_MAX_CAMINHO_COLUNA], const char* prefixo, CodigoColuna coluna)
+{
+	int tamanho = snprintf(caminho, TAM_MAX_CAMINHO_COLUNA, "%s.%s", prefixo, nomesColunas[coluna]);
+	return tamanho > 0 && tamanho < TAM_MAX_CAMINHO_COLUNA;
+}
+
+/// @brief Codifica o cabeçalho de uma coluna.
+static void codificarCabecalhoColuna(uint8_t cabecalho[TAM_CABECALHO_COLUNA], CodigoColuna coluna, uint64_t totalLinhas)
+{
+	memcpy(cabecalho, "TTCL", 4);
+	cabecalho[4] = VERSAO_COLUNAS;
+	cabecalho[5] = (uint8_t)largurasColunas[coluna];
+	cabecalho[6] = (uint8_t)coluna;
+	cabecalho[7] = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		cabecalho[8 + i] = (uint8_t)(totalLinhas >> (8 * i));
+	}
+}
+
+// **** Exportação ****
+
+/// @brief Escreve o bloco atual de todas as colunas.
+static void escreverBlocoColunas(ExportadorColunas* exportador)
+{
+	for (int c = 0; c < TOTAL_COLUNAS && exportador->linhasBloco > 0; c++)
+	{
+		size_t tamanho = (size_t)exportador->linhasBloco * (size_t)largurasColunas[c];
+		if (fwrite(exportador->blocos[c], 1, tamanho, exportador->arquivos[c]) != tamanho)
+		{
+			exportador->falhou = true;
+		}
+	}
+	exportador->linhasBloco = 0;
+}
+
+bool abrirColunas(ExportadorColunas* exportador, const char* prefixo)
+{
+	memset(exportador, 0, sizeof(*exportador));
+	bool sucesso = true;
+	for (int c = 0; c < TOTAL_COLUNAS && sucesso; c++)
+	{
+		char caminho[TAM_MAX_CAMINHO_COLUNA];
+		uint8_t cabecalho[TAM_CABECALHO_COLUNA];
+		codificarCabecalhoColuna(cabecalho, (CodigoColuna)c, 0);
+		exportador->blocos[c] = alocarMemoria((size_t)LINHAS_POR_BLOCO_COLUNAS * (size_t)largurasColunas[c]);
+		exportador->arquivos[c] = montarCaminhoColuna(caminho, prefixo, (CodigoColuna)c) ? fopen(caminho, "wb") : NULL;
+		sucesso = exportador->blocos[c] != NULL && exportador->arquivos[c] != NULL
+			&& fwrite(cabecalho, 1, sizeof(cabecalho), exportador->arquivos[c]) == sizeof(cabecalho);
+	}
+	if (!sucesso)
+	{
+		for (int c = 0; c < TOTAL_COLUNAS; c++)
+		{
+			liberarMemoria(exportador->blocos[c]);
+			if (exportador->arquivos[c] != NULL)
+			{
+				fclose(exportador->arquivos[c]);
+			}
+		}
+		memset(exportador, 0, sizeof(*exportador));
+	}
+	return sucesso;
+}
+
+void registrarColunas(ExportadorColunas* exportador, const Sessao* sessao, CodigoAcao acao, ResultadoAcao resultado,
+	const RegistroAcao* registro)
+{
+	// Peça da ação: a removida, a primeira movida para a pilha(trocas) ou, se abortada, a da frente da fila.
+	Peca peca = { 0 };
+	if (resultado != RESULTADO_SUCESSO)
+	{
+		if (sessao->fila.total > 0)
+		{
+			peca = sessao->fila.itens[sessao->fila.inicio];
+		}
+	}
+	else if (acao == ACAO_TROCAR_PECA_RESERVADA || acao == ACAO_TROCAR_PECAS_RESERVADAS)
+	{
+		peca = registro->paraPilha[0];
+	}
+	else
+	{
+		peca = registro->removida;
+	}
+
+	uint32_t linha = exportador->linhasBloco;
+	exportador->blocos[COLUNA_ACAO][linha] = (uint8_t)acao;
+	exportador->blocos[COLUNA_RESULTADO][linha] = (uint8_t)resultado;
+	exportador->blocos[COLUNA_TIPO][linha] = (uint8_t)peca.tipo;
+	uint8_t* id = &exportador->blocos[COLUNA_ID][8 * (size_t)linha];
+	for (int i = 0; i < 8; i++)
+	{
+		id[i] = (uint8_t)((uint64_t)peca.id >> (8 * i));
+	}
+	exportador->blocos[COLUNA_FILA][linha] = (uint8_t)sessao->fila.total;
+	exportador->blocos[COLUNA_PILHA][linha] = (uint8_t)(sessao->pilha.topo + 1);
+
+	exportador->totalLinhas++;
+	if (++exportador->linhasBloco == LINHAS_POR_BLOCO_COLUNAS)
+	{
+		escreverBlocoColunas(exportador);
+	}
+}
+
+bool fecharColunas(ExportadorColunas* exportador)
+{
+	escreverBlocoColunas(exportador);
+
+	bool sucesso = !exportador->falhou;
+	for (int c = 0; c < TOTAL_COLUNAS; c++)
+	{
+		// O total de linhas só é gravado ao final: um arquivo interrompido é identificado pelo leitor.
+		uint8_t cabecalho[TAM_CABECALHO_COLUNA];
+		codificarCabecalhoColuna(cabecalho, (CodigoColuna)c, exportador->totalLinhas);
+		sucesso = fseek(exportador->arquivos[c], 0, SEEK_SET) == 0
+			&& fwrite(cabecalho, 1, sizeof(cabecalho), exportador->arquivos[c]) == sizeof(cabecalho) && sucesso;
+		sucesso = fclose(exportador->arquivos[c]) == 0 && sucesso;
+		liberarMemoria(exportador->blocos[c]);
+	}
+	memset(exportador, 0, sizeof(*exportador));
+	return sucesso;
+}
+
+// **** Leitura ****
+
+bool abrirLeitorColuna(LeitorColuna* leitor, const char* prefixo, CodigoColuna coluna)
+{
+	memset(leitor, 0, sizeof(*leitor));
+	char caminho[TAM_MAX_CAMINHO_COLUNA];
+	if (!montarCaminhoColuna(caminho, prefixo, coluna) || (leitor->arquivo = fopen(caminho, "rb")) == NULL)
+	{
+		return false;
+	}
+
+	uint8_t cabecalho[TAM_CABECALHO_COLUNA];
+	bool valido = fread(cabecalho, 1, sizeof(cabecalho), leitor->arquivo) == sizeof(cabecalho)
+		&& memcmp(cabecalho, "TTCL", 4) == 0 && cabecalho[4] == VERSAO_COLUNAS
+		&& cabecalho[5] == largurasColunas[coluna] && cabecalho[6] == (uint8_t)coluna;
+	if (!valido)
+	{
+		fclose(leitor->arquivo);
+		leitor->arquivo = NULL;
+		return false;
+	}
+
+	leitor->largura = largurasColunas[coluna];
+	for (int i = 0; i < 8; i++)
+	{
+		leitor->totalLinhas |= (uint64_t)cabecalho[8 + i] << (8 * i);
+	}
+	return true;
+}
+
+int64_t lerColuna(LeitorColuna* leitor, void* destino, int64_t linhas)
+{
+	uint64_t restantes = leitor->totalLinhas - leitor->linhasLidas;
+	size_t quantidade = (uint64_t)linhas < restantes ? (size_t)linhas : (size_t)restantes;
+	if (quantidade == 0)
+	{
+		return 0;
+	}
+	if (fread(destino, (size_t)leitor->largura, quantidade, leitor->arquivo) != quantidade)
+	{
+		return -1;
+	}
+	leitor->linhasLidas += quantidade;
+	return (int64_t)quantidade;
+}
+
+void fecharLeitorColuna(LeitorColuna* leitor)
+{
+	if (leitor->arquivo != NULL)
+	{
+		fclose(leitor->arquivo);
+	}
+	memset(leitor, 0, sizeof(*leitor));
+}
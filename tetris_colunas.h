@@ -0,0 +1,116 @@
+#ifndef TETRIS_COLUNAS_H
+#define TETRIS_COLUNAS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Exportação em colunas do histórico das sessões: cada ação aplicada é uma linha, e cada campo da linha é
+// gravado em um arquivo próprio(PREFIXO.acao, PREFIXO.resultado, ...), com largura fixa. Assim, uma
+// agregação lê somente as colunas de que precisa, em laços simples sobre vetores contíguos.
+//
+// Colunas(uma linha por ação, mesma ordem em todos os arquivos):
+//   acao:      código da ação(1 byte, de 1 a 5).
+//   resultado: resultado da ação(1 byte, ResultadoAcao).
+//   tipo:      tipo da peça da ação(1 byte, caractere de TIPOS_PECA): a removida(jogar, reservar e usar), ou a
+//              primeira movida da fila para a pilha(trocas). Nas ações abortadas, a peça da frente da fila.
+//   id:        identificação dessa peça(8 bytes).
+//   fila:      quantidade de peças na fila, após a ação(1 byte).
+//   pilha:     quantidade de peças na pilha, após a ação(1 byte).
+//
+// Leiaute de cada arquivo(inteiros em little-endian):
+//   cabeçalho: "TTCL", versão(1 byte), largura(1 byte), código da coluna(1 byte), 1 byte reservado,
+//              total de linhas(8 bytes, gravado ao fechar).
+//   valores:   total de linhas * largura bytes.
+
+// **** Definições de constantes. ****
+
+/// @brief Versão do formato gravada no cabeçalho.
+#define VERSAO_COLUNAS 1
+
+/// @brief Tamanho do cabeçalho de cada arquivo de coluna, em bytes.
+#define TAM_CABECALHO_COLUNA 16
+
+/// @brief Quantidade de linhas acumuladas em memória antes de cada escrita.
+#define LINHAS_POR_BLOCO_COLUNAS 65536
+
+// **** Declarações de estruturas. ****
+
+/// @brief Colunas exportadas.
+typedef enum {
+	COLUNA_ACAO = 0,
+	COLUNA_RESULTADO,
+	COLUNA_TIPO,
+	COLUNA_ID,
+	COLUNA_FILA,
+	COLUNA_PILHA,
+	TOTAL_COLUNAS
+} CodigoColuna;
+
+/// @brief Exportador das colunas. Os valores de cada coluna são acumulados em blocos de
+/// LINHAS_POR_BLOCO_COLUNAS linhas, e escritos de uma vez.
+typedef struct {
+	FILE* arquivos[TOTAL_COLUNAS];
+	uint8_t* blocos[TOTAL_COLUNAS];
+	/// @brief Linhas acumuladas no bloco atual.
+	uint32_t linhasBloco;
+	uint64_t totalLinhas;
+	bool falhou;
+} ExportadorColunas;
+
+/// @brief Leitor de um arquivo de coluna.
+typedef struct {
+	FILE* arquivo;
+	int largura;
+	uint64_t totalLinhas;
+	uint64_t linhasLidas;
+} LeitorColuna;
+
+// **** Declarações das funções. ****
+
+/// @brief Obtém o nome de uma coluna, usado como extensão do arquivo. Ex: "acao".
+/// @param CodigoColuna. Coluna.
+/// @returns Texto. Nome da coluna.
+const char* nomeColuna(CodigoColuna coluna);
+/// @brief Obtém a largura de uma coluna, em bytes.
+/// @param CodigoColuna. Coluna.
+/// @returns Inteiro. Largura(1 ou 8).
+int larguraColuna(CodigoColuna coluna);
+
+/// @brief Cria os arquivos de todas as colunas(PREFIXO.acao, PREFIXO.resultado, ...).
+/// @param ExportadorColunas. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Prefixo dos caminhos dos arquivos.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool abrirColunas(ExportadorColunas* exportador, const char* prefixo);
+/// @brief Acrescenta a linha de uma ação aplicada à sessão(com sucesso ou não).
+/// @param ExportadorColunas. Ponteiro via referência, usado na exportação.
+/// @param Sessao. Ponteiro da sessão, após a ação. Somente leitura.
+/// @param CodigoAcao. Ação aplicada.
+/// @param ResultadoAcao. Resultado da ação.
+/// @param RegistroAcao. Detalhes da ação(preenchidos somente com sucesso). Somente leitura.
+void registrarColunas(ExportadorColunas* exportador, const Sessao* sessao, CodigoAcao acao, ResultadoAcao resultado,
+	const RegistroAcao* registro);
+/// @brief Escreve as linhas pendentes, grava o total de linhas nos cabeçalhos e fecha os arquivos.
+/// @param ExportadorColunas. Ponteiro via referência, a ser finalizado.
+/// @returns Verdadeiro(true), se todas as linhas foram escritas. Caso contrário, Falso(false).
+bool fecharColunas(ExportadorColunas* exportador);
+
+/// @brief Abre o arquivo de uma coluna, e valida o cabeçalho.
+/// @param LeitorColuna. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Prefixo dos caminhos dos arquivos.
+/// @param CodigoColuna. Coluna a ser lida.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o arquivo não existir ou for inválido.
+bool abrirLeitorColuna(LeitorColuna* leitor, const char* prefixo, CodigoColuna coluna);
+/// @brief Lê os próximos valores da coluna, sem conversão(largura bytes por linha, em little-endian).
+/// @param LeitorColuna. Ponteiro via referência, do leitor.
+/// @param void. Destino dos valores, com capacidade para a quantidade de linhas informada.
+/// @param Inteiro. Quantidade máxima de linhas.
+/// @returns Inteiro. Quantidade de linhas lidas(0 ao final da coluna), ou -1 em caso de falha de leitura.
+int64_t lerColuna(LeitorColuna* leitor, void* destino, int64_t linhas);
+/// @brief Fecha o arquivo da coluna.
+/// @param LeitorColuna. Ponteiro via referência, a ser finalizado.
+void fecharLeitorColuna(LeitorColuna* leitor);
+
+#endif // TETRIS_COLUNAS_H
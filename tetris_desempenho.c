@@ -0,0 +1,589 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+// Se estivermos no windows, vamos incluir usar uma saída de console com padrão adequado para utf-8.
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include "tetris_memoria.h"
+#include "tetris_metricas.h"
+#include "tetris_nucleo.h"
+#include "tetris_tempo.h"
+
+// Desafio Tetris Stack
+// Regressão de desempenho de ponta a ponta: sessões completas, com semente fixa, pela lógica de cada
+// nível(Novato: somente jogar; Aventureiro: jogar, reservar e usar; Mestre: todas as ações, com as trocas),
+// sem interface. Cada cenário mede a vazão(ações por segundo, melhor de N repetições, sem instrumentação),
+// os percentis de latência por ação(histogramas de tetris_metricas.h, em uma execução à parte) e o pico
+// de memória. Fora do Windows, cada cenário é executado em um processo filho, e o pico é o do filho: o pico
+// do processo só cresce, e um cenário seria medido com o pico dos anteriores. Os resultados são gravados em
+// JSON, e comparados com uma referência gravada anteriormente: o programa falha se algum cenário piorar além
+// do limite(regressão), ou se a referência existir e não puder ser lida.
+
+// **** Definições de constantes. ****
+
+/// @brief Valores padrão das opções.
+#define ACOES_PADRAO 1000000
+#define SEMENTE_PADRAO 1
+#define REPETICOES_PADRAO 3
+/// @brief Piora máxima tolerada da vazão e da memória, em porcentagem.
+#define LIMITE_PADRAO 10.0
+/// @brief Piora máxima tolerada do p99 da latência, em porcentagem. Maior que o limite da vazão: as faixas
+/// do histograma têm ~25% de largura, e um p99 na fronteira entre duas faixas oscila entre elas.
+#define LIMITE_LATENCIA_PADRAO 50.0
+
+/// @brief Quantidade de cenários(um por nível).
+#define TOTAL_CENARIOS 3
+
+/// @brief Tamanho máximo aceito para o arquivo de referência.
+#define TAM_MAX_REFERENCIA 65536
+
+// **** Declarações de estruturas. ****
+
+/// @brief Cenário de regressão: as ações sorteadas, com a mesma probabilidade, a cada passo da sessão.
+typedef struct {
+	const char* nome;
+	int totalAcoes;
+	CodigoAcao acoes[TOTAL_ACOES];
+} Cenario;
+
+/// @brief Medições de um cenário.
+typedef struct {
+	double acoesPorSegundo;
+	/// @brief Ações efetuadas com sucesso(determinístico pela semente: identifica a carga executada).
+	uint64_t sucessos;
+	uint64_t p50Ns;
+	uint64_t p90Ns;
+	uint64_t p99Ns;
+	uint64_t p999Ns;
+	uint64_t maximoNs;
+	/// @brief Pico de memória do cenário, em KiB: o do processo filho(ou, no Windows, o do processo até o cenário).
+	uint64_t memoriaPicoKb;
+} MedicaoCenario;
+
+// **** Variáveis globais. ****
+
+/// @brief Cenários, na ordem de execução.
+static const Cenario cenarios[TOTAL_CENARIOS] = {
+	{ "novato", 1, { ACAO_JOGAR_PECA } },
+	{ "aventureiro", 3, { ACAO_JOGAR_PECA, ACAO_RESERVAR_PECA, ACAO_USAR_PECA_RESERVADA } },
+	{ "mestre", 5, { ACAO_JOGAR_PECA, ACAO_RESERVAR_PECA, ACAO_USAR_PECA_RESERVADA,
+		ACAO_TROCAR_PECA_RESERVADA, ACAO_TROCAR_PECAS_RESERVADAS } },
+};
+
+// **** Declarações das funções. ****
+
+/// @brief Sorteia a sequência de ações de um cenário. A sequência depende somente da semente e do cenário.
+/// @param Cenario. Ponteiro do cenário. Somente leitura.
+/// @param Inteiro. Semente da sequência.
+/// @param uint8_t. Vetor de destino, com uma posição por ação.
+/// @param Inteiro. Quantidade de ações.
+void sortearAcoes(const Cenario* cenario, uint64_t semente, uint8_t* acoes, int64_t quantidade);
+/// @brief Executa uma sessão completa, com as ações informadas.
+/// @param Inteiro. Semente do gerador de peças.
+/// @param uint8_t. Vetor das ações. Somente leitura.
+/// @param Inteiro. Quantidade de ações.
+/// @returns Inteiro. Quantidade de ações efetuadas com sucesso.
+uint64_t executarSessao(uint64_t semente, const uint8_t* acoes, int64_t quantidade);
+/// @brief Mede um cenário: a vazão, os percentis de latência e o pico de memória.
+/// @param Cenario. Ponteiro do cenário. Somente leitura.
+/// @param Inteiro. Semente das ações e das peças.
+/// @param Inteiro. Quantidade de ações por sessão.
+/// @param Inteiro. Quantidade de repetições da medição de vazão.
+/// @param MedicaoCenario. Ponteiro via referência, para conter as medições.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória.
+bool medirCenario(const Cenario* cenario, uint64_t semente, int64_t quantidade, int repeticoes, MedicaoCenario* medicao);
+/// @brief Mede um cenário em um processo filho(fork), com o pico de memória somente do cenário(wait4).
+/// No Windows, ou se o processo filho não puder ser criado, mede no próprio processo(medirCenario).
+/// @param Cenario. Ponteiro do cenário. Somente leitura.
+/// @param Inteiro. Semente das ações e das peças.
+/// @param Inteiro. Quantidade de ações por sessão.
+/// @param Inteiro. Quantidade de repetições da medição de vazão.
+/// @param MedicaoCenario. Ponteiro via referência, para conter as medições.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória.
+bool medirCenarioIsolado(const Cenario* cenario, uint64_t semente, int64_t quantidade, int repeticoes,
+	MedicaoCenario* medicao);
+/// @brief Recupera o pico de memória residente do processo(high-water mark).
+/// @returns Inteiro. Pico de memória, em KiB. Zero, se não disponível.
+uint64_t memoriaPicoKb(void);
+/// @brief Escreve as medições em formato JSON(o mesmo formato lido como referência).
+/// @param FILE. Arquivo de destino.
+/// @param Inteiro. Semente das sessões.
+/// @param Inteiro. Quantidade de ações por sessão.
+/// @param MedicaoCenario. Vetor com as medições de todos os cenários. Somente leitura.
+void escreverDesempenhoJson(FILE* arquivo, uint64_t semente, int64_t quantidade, const MedicaoCenario medicoes[TOTAL_CENARIOS]);
+/// @brief Lê as medições de um arquivo escrito por escreverDesempenhoJson.
+/// @param Texto. Caminho do arquivo.
+/// @param MedicaoCenario. Vetor de destino, com as medições de todos os cenários.
+/// @returns Verdadeiro(true), se todos os cenários foram encontrados. Caso contrário, Falso(false).
+bool lerReferencia(const char* caminho, MedicaoCenario referencias[TOTAL_CENARIOS]);
+/// @brief Compara as medições com a referência, exibindo a variação de cada grandeza.
+/// @param MedicaoCenario. Vetor com as medições atuais. Somente leitura.
+/// @param MedicaoCenario. Vetor com as medições de referência. Somente leitura.
+/// @param double. Piora máxima tolerada da vazão e da memória, em porcentagem.
+/// @param double. Piora máxima tolerada do p99 da latência, em porcentagem.
+/// @returns Inteiro. Quantidade de regressões encontradas.
+int compararReferencia(const MedicaoCenario medicoes[TOTAL_CENARIOS], const MedicaoCenario referencias[TOTAL_CENARIOS],
+	double limite, double limiteLatencia);
+
+/// @brief Ponto de entrada do programa.
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: --acoes N, --referencia ARQUIVO, --gravar-referencia,
+/// --exigir-referencia, --limite PORCENTAGEM.
+/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, em caso de falha ou regressão. Ex: EXIT_FAILURE.
+int main(int argc, char* argv[]);
+
+// **** Implementações das funções. ****
+
+int main(int argc, char* argv[]) {
+
+	// Configurações de caracteres para ajuste de ortografia para saída do console(UTF-8).
+#ifdef _WIN32
+	// Plataforma Windows.
+	SetConsoleOutputCP(CP_UTF8);
+#endif
+
+	int64_t quantidade = ACOES_PADRAO;
+	uint64_t semente = SEMENTE_PADRAO;
+	int repeticoes = REPETICOES_PADRAO;
+	double limite = LIMITE_PADRAO;
+	double limiteLatencia = LIMITE_LATENCIA_PADRAO;
+	const char* caminhoSaida = NULL;
+	const char* caminhoReferencia = NULL;
+	bool gravarReferencia = false;
+	bool exigirReferencia = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--acoes") == 0 && i + 1 < argc && atoll(argv[i + 1]) > 0)
+		{
+			quantidade = atoll(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc)
+		{
+			semente = strtoull(argv[++i], NULL, 10);
+			continue;
+		}
+		if (strcmp(argv[i], "--repeticoes") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+		{
+			repeticoes = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--limite") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0.0)
+		{
+			limite = atof(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--limite-latencia") == 0 && i + 1 < argc && atof(argv[i + 1]) > 0.0)
+		{
+			limiteLatencia = atof(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc)
+		{
+			caminhoSaida = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--referencia") == 0 && i + 1 < argc)
+		{
+			caminhoReferencia = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--gravar-referencia") == 0)
+		{
+			gravarReferencia = true;
+			continue;
+		}
+		if (strcmp(argv[i], "--exigir-referencia") == 0)
+		{
+			exigirReferencia = true;
+			continue;
+		}
+		printf("Uso: %s [--acoes N] [--semente N] [--repeticoes N] [--saida ARQUIVO]\n"
+			"       [--referencia ARQUIVO [--gravar-referencia | --exigir-referencia]\n"
+			"        [--limite PORCENTAGEM] [--limite-latencia PORCENTAGEM]]\n",
+			argv[0]);
+		return EXIT_FAILURE;
+	}
+	if ((gravarReferencia || exigirReferencia) && caminhoReferencia == NULL)
+	{
+		printf("\n==== ⚠️  --gravar-referencia e --exigir-referencia requerem --referencia ARQUIVO. ====\n");
+		return EXIT_FAILURE;
+	}
+
+	printf("==== Desempenho: semente %" PRIu64 ", %" PRId64 " ações por sessão, melhor de %d. ====\n",
+		semente, quantidade, repeticoes);
+	printf("%-13s %16s %12s %8s %8s %8s %8s %11s %12s\n", "Cenário", "Ações/s", "Sucessos",
+		"p50(ns)", "p90(ns)", "p99(ns)", "p999(ns)", "Máx(ns)", "Pico(KiB)");
+	fflush(stdout);
+
+	MedicaoCenario medicoes[TOTAL_CENARIOS];
+	for (int c = 0; c < TOTAL_CENARIOS; c++)
+	{
+		MedicaoCenario* m = &medicoes[c];
+		if (!medirCenarioIsolado(&cenarios[c], semente, quantidade, repeticoes, m))
+		{
+			printf("\n==== ⚠️  Memória insuficiente para as ações do cenário %s. ====\n", cenarios[c].nome);
+			return EXIT_FAILURE;
+		}
+		printf("%-12s %14.0f %12" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %8" PRIu64 " %10" PRIu64 " %12" PRIu64 "\n",
+			cenarios[c].nome, m->acoesPorSegundo, m->sucessos, m->p50Ns, m->p90Ns, m->p99Ns, m->p999Ns,
+			m->maximoNs, m->memoriaPicoKb);
+		fflush(stdout);
+	}
+
+	if (caminhoSaida != NULL)
+	{
+		FILE* arquivo = fopen(caminhoSaida, "w");
+		if (arquivo == NULL)
+		{
+			printf("\n==== ⚠️  Não foi possível criar o arquivo %s. ====\n", caminhoSaida);
+			return EXIT_FAILURE;
+		}
+		escreverDesempenhoJson(arquivo, semente, quantidade, medicoes);
+		fclose(arquivo);
+	}
+
+	if (caminhoReferencia == NULL)
+	{
+		return EXIT_SUCCESS;
+	}
+
+	// Sem referência anterior(ou com --gravar-referencia), as medições atuais passam a ser a referência.
+	// Uma referência existente nunca é substituída sem --gravar-referencia, mesmo que seja inválida.
+	FILE* existente = fopen(caminhoReferencia, "r");
+	if (existente != NULL)
+	{
+		fclose(existente);
+	}
+	else if (exigirReferencia)
+	{
+		printf("\n==== ⚠️  Referência inexistente: %s. Grave-a com --gravar-referencia(na versão de base). ====\n",
+			caminhoReferencia);
+		return EXIT_FAILURE;
+	}
+	if (gravarReferencia || existente == NULL)
+	{
+		FILE* arquivo = fopen(caminhoReferencia, "w");
+		if (arquivo == NULL)
+		{
+			printf("\n==== ⚠️  Não foi possível criar o arquivo %s. ====\n", caminhoReferencia);
+			return EXIT_FAILURE;
+		}
+		escreverDesempenhoJson(arquivo, semente, quantidade, medicoes);
+		fclose(arquivo);
+		printf("\nReferência gravada em %s(sem comparação).\n", caminhoReferencia);
+		return EXIT_SUCCESS;
+	}
+
+	MedicaoCenario referencias[TOTAL_CENARIOS];
+	if (!lerReferencia(caminhoReferencia, referencias))
+	{
+		printf("\n==== ⚠️  Referência inválida(formato ou cenários ausentes): %s. ====\n", caminhoReferencia);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n==== Comparação com %s(limites: vazão e memória %.0f%%, p99 %.0f%%) ====\n",
+		caminhoReferencia, limite, limiteLatencia);
+	int regressoes = compararReferencia(medicoes, referencias, limite, limiteLatencia);
+	if (regressoes > 0)
+	{
+		printf("\n==== ⚠️  %d regressão(ões) de desempenho. ====\n", regressoes);
+		return EXIT_FAILURE;
+	}
+	printf("\nNenhuma regressão de desempenho.\n");
+	return EXIT_SUCCESS;
+}
+
+void sortearAcoes(const Cenario* cenario, uint64_t semente, uint8_t* acoes, int64_t quantidade)
+{
+	// Gerador splitmix64: as ações não consomem o gerador de peças da sessão.
+	uint64_t estado = semente ^ ((uint64_t)cenario->totalAcoes * 0xD1B54A32D192ED03ULL);
+	for (int64_t i = 0; i < quantidade; i++)
+	{
+		uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		z ^= z >> 31;
+		acoes[i] = (uint8_t)cenario->acoes[(z >> 32) % (uint64_t)cenario->totalAcoes];
+	}
+}
+
+uint64_t executarSessao(uint64_t semente, const uint8_t* acoes, int64_t quantidade)
+{
+	GeradorPecas gerador;
+	Sessao sessao;
+	inicializarGerador(&gerador, semente);
+	inicializarSessaoComGerador(&sessao, &gerador);
+
+	uint64_t sucessos = 0;
+	for (int64_t i = 0; i < quantidade; i++)
+	{
+		sucessos += aplicarAcao(&sessao, (CodigoAcao)acoes[i], NULL) == RESULTADO_SUCESSO;
+	}
+	return sucessos;
+}
+
+bool medirCenario(const Cenario* cenario, uint64_t semente, int64_t quantidade, int repeticoes, MedicaoCenario* medicao)
+{
+	memset(medicao, 0, sizeof(*medicao));
+
+	// As ações são sorteadas antes da medição: somente a lógica do núcleo é cronometrada.
+	uint8_t* acoes = alocarMemoria((size_t)quantidade);
+	if (acoes == NULL)
+	{
+		return false;
+	}
+	sortearAcoes(cenario, semente, acoes, quantidade);
+
+	// Vazão: a melhor das repetições, sem instrumentação(o ruído do sistema só aumenta o tempo).
+	int64_t melhorNs = INT64_MAX;
+	for (int r = 0; r < repeticoes; r++)
+	{
+		int64_t inicioNs = relogioMonotonicoNs();
+		medicao->sucessos = executarSessao(semente, acoes, quantidade);
+		int64_t duracaoNs = relogioMonotonicoNs() - inicioNs;
+		if (duracaoNs < melhorNs)
+		{
+			melhorNs = duracaoNs;
+		}
+	}
+	medicao->acoesPorSegundo = melhorNs > 0 ? (double)quantidade * 1e9 / (double)melhorNs : 0.0;
+
+	// Latência: uma execução à parte, com as métricas do núcleo. Os histogramas de todas as ações são somados.
+	zerarMetricas();
+	ativarMetricas(true);
+	executarSessao(semente, acoes, quantidade);
+	ativarMetricas(false);
+
+	static Metricas metricas;
+	static MetricaAcao total;
+	consolidarMetricas(&metricas);
+	memset(&total, 0, sizeof(total));
+	for (int a = 0; a < TOTAL_METRICAS; a++)
+	{
+		const MetricaAcao* m = &metricas.acoes[a];
+		total.chamadas += m->chamadas;
+		if (m->maximoNs > total.maximoNs)
+		{
+			total.maximoNs = m->maximoNs;
+		}
+		for (int f = 0; f < TOTAL_FAIXAS_HISTOGRAMA; f++)
+		{
+			total.faixas[f] += m->faixas[f];
+		}
+	}
+	medicao->p50Ns = percentilMetrica(&total, 50.0);
+	medicao->p90Ns = percentilMetrica(&total, 90.0);
+	medicao->p99Ns = percentilMetrica(&total, 99.0);
+	medicao->p999Ns = percentilMetrica(&total, 99.9);
+	medicao->maximoNs = total.maximoNs;
+
+	liberarMemoria(acoes);
+	medicao->memoriaPicoKb = memoriaPicoKb();
+	return true;
+}
+
+bool medirCenarioIsolado(const Cenario* cenario, uint64_t semente, int64_t quantidade, int repeticoes,
+	MedicaoCenario* medicao)
+{
+#ifndef _WIN32
+	int canal[2];
+	if (pipe(canal) == 0)
+	{
+		pid_t filho = fork();
+		if (filho == 0)
+		{
+			// Processo filho: mede e devolve o resultado pelo canal.
+			close(canal[0]);
+			bool sucesso = medirCenario(cenario, semente, quantidade, repeticoes, medicao);
+			bool escrito = write(canal[1], medicao, sizeof(*medicao)) == (ssize_t)sizeof(*medicao);
+			_exit(sucesso && escrito ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+		close(canal[1]);
+		if (filho > 0)
+		{
+			size_t lidos = 0;
+			while (lidos < sizeof(*medicao))
+			{
+				ssize_t n = read(canal[0], (char*)medicao + lidos, sizeof(*medicao) - lidos);
+				if (n <= 0)
+				{
+					break;
+				}
+				lidos += (size_t)n;
+			}
+			close(canal[0]);
+
+			int estado;
+			struct rusage uso;
+			if (wait4(filho, &estado, 0, &uso) != filho || !WIFEXITED(estado) || WEXITSTATUS(estado) != EXIT_SUCCESS
+				|| lidos != sizeof(*medicao))
+			{
+				return false;
+			}
+#ifdef __APPLE__
+			medicao->memoriaPicoKb = (uint64_t)uso.ru_maxrss / 1024;
+#else
+			medicao->memoriaPicoKb = (uint64_t)uso.ru_maxrss;
+#endif
+			return true;
+		}
+		close(canal[0]);
+	}
+#endif
+	return medirCenario(cenario, semente, quantidade, repeticoes, medicao);
+}
+
+uint64_t memoriaPicoKb(void)
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS contadores;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &contadores, sizeof(contadores)))
+	{
+		return 0;
+	}
+	return (uint64_t)contadores.PeakWorkingSetSize / 1024;
+#else
+	struct rusage uso;
+	if (getrusage(RUSAGE_SELF, &uso) != 0)
+	{
+		return 0;
+	}
+#ifdef __APPLE__
+	// No macOS, ru_maxrss é informado em bytes(nos demais sistemas, em KiB).
+	return (uint64_t)uso.ru_maxrss / 1024;
+#else
+	return (uint64_t)uso.ru_maxrss;
+#endif
+#endif
+}
+
+void escreverDesempenhoJson(FILE* arquivo, uint64_t semente, int64_t quantidade, const MedicaoCenario medicoes[TOTAL_CENARIOS])
+{
+	fprintf(arquivo, "{\n  \"semente\": %llu,\n  \"acoes\": %lld,\n  \"cenarios\": [\n",
+		(unsigned long long)semente, (long long)quantidade);
+
+	for (int c = 0; c < TOTAL_CENARIOS; c++)
+	{
+		const MedicaoCenario* m = &medicoes[c];
+		fprintf(arquivo, "    {\n      \"nome\": \"%s\",\n", cenarios[c].nome);
+		fprintf(arquivo, "      \"acoes_por_segundo\": %.0f,\n      \"sucessos\": %llu,\n",
+			m->acoesPorSegundo, (unsigned long long)m->sucessos);
+		fprintf(arquivo, "      \"latencia_ns\": {\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu},\n",
+			(unsigned long long)m->p50Ns, (unsigned long long)m->p90Ns, (unsigned long long)m->p99Ns,
+			(unsigned long long)m->p999Ns, (unsigned long long)m->maximoNs);
+		fprintf(arquivo, "      \"memoria_pico_kb\": %llu\n    }%s\n",
+			(unsigned long long)m->memoriaPicoKb, c + 1 < TOTAL_CENARIOS ? "," : "");
+	}
+
+	fprintf(arquivo, "  ]\n}\n");
+}
+
+/// @brief Procura um campo numérico(ex: "p99") a partir de um trecho do texto.
+/// @returns Valor do campo, ou -1 se o campo não foi encontrado.
+static double lerCampo(const char* trecho, const char* campo)
+{
+	char chave[64];
+	snprintf(chave, sizeof(chave), "\"%s\":", campo);
+	const char* posicao = strstr(trecho, chave);
+	return posicao != NULL ? strtod(posicao + strlen(chave), NULL) : -1.0;
+}
+
+bool lerReferencia(const char* caminho, MedicaoCenario referencias[TOTAL_CENARIOS])
+{
+	FILE* arquivo = fopen(caminho, "r");
+	if (arquivo == NULL)
+	{
+		return false;
+	}
+	static char texto[TAM_MAX_REFERENCIA];
+	size_t tamanho = fread(texto, 1, sizeof(texto) - 1, arquivo);
+	fclose(arquivo);
+	texto[tamanho] = '\0';
+
+	// Leitura restrita ao formato de escreverDesempenhoJson: cada cenário começa no seu campo "nome",
+	// e os seus campos são procurados a partir dali(o primeiro de cada nome é o do próprio cenário).
+	for (int c = 0; c < TOTAL_CENARIOS; c++)
+	{
+		char chave[64];
+		snprintf(chave, sizeof(chave), "\"nome\": \"%s\"", cenarios[c].nome);
+		const char* trecho = strstr(texto, chave);
+		if (trecho == NULL)
+		{
+			return false;
+		}
+
+		MedicaoCenario* r = &referencias[c];
+		double acoesPorSegundo = lerCampo(trecho, "acoes_por_segundo");
+		double sucessos = lerCampo(trecho, "sucessos");
+		double p99 = lerCampo(trecho, "p99");
+		double memoria = lerCampo(trecho, "memoria_pico_kb");
+		if (acoesPorSegundo < 0.0 || sucessos < 0.0 || p99 < 0.0 || memoria < 0.0)
+		{
+			return false;
+		}
+		memset(r, 0, sizeof(*r));
+		r->acoesPorSegundo = acoesPorSegundo;
+		r->sucessos = (uint64_t)sucessos;
+		r->p99Ns = (uint64_t)p99;
+		r->memoriaPicoKb = (uint64_t)memoria;
+	}
+	return true;
+}
+
+/// @brief Exibe a variação de uma grandeza em relação à referência.
+/// @returns Verdadeiro(true), se a piora excede o limite. Caso contrário, Falso(false).
+static bool compararGrandeza(const char* cenario, const char* grandeza, double atual, double referencia,
+	bool maiorMelhor, double limite)
+{
+	double variacao = referencia > 0.0 ? (atual - referencia) * 100.0 / referencia : 0.0;
+	double piora = maiorMelhor ? -variacao : variacao;
+	bool regressao = piora > limite;
+
+	// A largura da coluna é em bytes: os caracteres acentuados(UTF-8) ocupam 2 bytes.
+	int largura = 10;
+	for (const char* c = grandeza; *c != '\0'; c++)
+	{
+		largura += ((unsigned char)*c & 0xC0) == 0x80;
+	}
+	printf("%-12s %-*s %16.0f %16.0f %+9.1f%% %s\n", cenario, largura, grandeza, referencia, atual, variacao,
+		regressao ? "⚠️  REGRESSÃO" : "ok");
+	return regressao;
+}
+
+int compararReferencia(const MedicaoCenario medicoes[TOTAL_CENARIOS], const MedicaoCenario referencias[TOTAL_CENARIOS],
+	double limite, double limiteLatencia)
+{
+	printf("%-13s %-10s %17s %16s %12s\n", "Cenário", "Grandeza", "Referência", "Atual", "Variação");
+
+	int regressoes = 0;
+	for (int c = 0; c < TOTAL_CENARIOS; c++)
+	{
+		const MedicaoCenario* m = &medicoes[c];
+		const MedicaoCenario* r = &referencias[c];
+
+		// Outra quantidade de sucessos indica outra carga(semente, quantidade ou regras alteradas):
+		// as medições não são comparáveis.
+		if (m->sucessos != r->sucessos)
+		{
+			printf("%-12s %-10s %16" PRIu64 " %16" PRIu64 " %10s ⚠️  CARGA DIFERENTE\n", cenarios[c].nome, "sucessos",
+				r->sucessos, m->sucessos, "");
+			regressoes++;
+			continue;
+		}
+		regressoes += compararGrandeza(cenarios[c].nome, "ações/s", m->acoesPorSegundo, r->acoesPorSegundo, true, limite);
+		regressoes += compararGrandeza(cenarios[c].nome, "p99(ns)", (double)m->p99Ns, (double)r->p99Ns, false, limiteLatencia);
+		regressoes += compararGrandeza(cenarios[c].nome, "pico(KiB)", (double)m->memoriaPicoKb, (double)r->memoriaPicoKb,
+			false, limite);
+	}
+	return regressoes;
+}
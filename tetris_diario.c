@@ -0,0 +1,288 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_diario.h"
+#include "tetris_memoria.h"
+#include "tetris_tempo.h"
+#ifdef _WIN32
+#include <Windows.h>
+#include <io.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// **** Definições de constantes. ****
+
+/// @brief Tamanho do cabeçalho do arquivo, em bytes.
+#define TAM_CABECALHO_DIARIO 8
+
+/// @brief Pausa da thread de escrita quando o anel está vazio, em nanossegundos.
+#define PAUSA_ESCRITA_NS 1000000
+
+// **** Implementações das funções. ****
+
+// **** Plataforma ****
+
+#ifdef _WIN32
+// Plataforma Windows: _write e _commit(equivalente ao fsync), thread nativa.
+
+static int abrirArquivoDiario(const char* caminho)
+{
+	return _open(caminho, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+static long escreverArquivoDiario(int arquivo, const uint8_t* dados, uint32_t tamanho)
+{
+	return _write(arquivo, dados, tamanho);
+}
+
+static bool sincronizarArquivoDiario(int arquivo)
+{
+	return _commit(arquivo) == 0;
+}
+
+static void fecharArquivoDiario(int arquivo)
+{
+	_close(arquivo);
+}
+
+static void pausarEscrita(void)
+{
+	Sleep(PAUSA_ESCRITA_NS / 1000000);
+}
+
+#else
+
+static int abrirArquivoDiario(const char* caminho)
+{
+	return open(caminho, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+static long escreverArquivoDiario(int arquivo, const uint8_t* dados, uint32_t tamanho)
+{
+	return (long)write(arquivo, dados, tamanho);
+}
+
+static bool sincronizarArquivoDiario(int arquivo)
+{
+	return fsync(arquivo) == 0;
+}
+
+static void fecharArquivoDiario(int arquivo)
+{
+	close(arquivo);
+}
+
+static void pausarEscrita(void)
+{
+	struct timespec pausa = { 0, PAUSA_ESCRITA_NS };
+	nanosleep(&pausa, NULL);
+}
+
+#endif
+
+/// @brief Escreve todos os bytes, repetindo as escritas parciais.
+static bool escreverTudo(int arquivo, const uint8_t* dados, uint32_t tamanho)
+{
+	while (tamanho > 0)
+	{
+		long escritos = escreverArquivoDiario(arquivo, dados, tamanho);
+		if (escritos <= 0)
+		{
+			return false;
+		}
+		dados += escritos;
+		tamanho -= (uint32_t)escritos;
+	}
+	return true;
+}
+
+// **** Thread de escrita ****
+
+/// @brief Laço da thread de escrita: escreve tudo o que foi publicado(no máximo duas escritas, pela volta
+/// do anel), e sincroniza o arquivo quando o intervalo vence. Encerra após escrever o que restar.
+static void executarEscrita(Diario* diario)
+{
+	uint64_t liberados = atomic_load_explicit(&diario->liberados, memory_order_relaxed);
+	int64_t ultimaSincronizacao = relogioMonotonicoNs();
+	bool pendente = false;
+	uint64_t capacidade = (uint64_t)diario->mascara + 1;
+
+	for (;;)
+	{
+		// O pedido de encerramento é lido antes dos publicados: nada publicado antes dele fica para trás.
+		bool encerrar = atomic_load_explicit(&diario->encerrar, memory_order_acquire);
+		uint64_t publicados = atomic_load_explicit(&diario->publicados, memory_order_acquire);
+
+		if (publicados > liberados && !atomic_load_explicit(&diario->falhou, memory_order_relaxed))
+		{
+			uint32_t inicio = (uint32_t)(liberados & diario->mascara);
+			uint64_t total = publicados - liberados;
+			uint32_t primeiro = (uint32_t)(total < capacidade - inicio ? total : capacidade - inicio);
+			bool escrito = escreverTudo(diario->arquivo, &diario->anel[inicio], primeiro)
+				&& escreverTudo(diario->arquivo, diario->anel, (uint32_t)(total - primeiro));
+			if (!escrito)
+			{
+				atomic_store_explicit(&diario->falhou, true, memory_order_relaxed);
+			}
+			diario->escritas++;
+			pendente = true;
+		}
+		bool escreveu = publicados > liberados;
+		if (escreveu)
+		{
+			// Após uma falha, os registros continuam sendo liberados: o produtor não fica bloqueado.
+			liberados = publicados;
+			atomic_store_explicit(&diario->liberados, liberados, memory_order_release);
+		}
+
+		int64_t agora = relogioMonotonicoNs();
+		if (pendente && (encerrar || agora - ultimaSincronizacao >= diario->intervaloFsyncNs))
+		{
+			// Sincronização agrupada: um único fsync para todas as escritas do intervalo.
+			if (!sincronizarArquivoDiario(diario->arquivo))
+			{
+				atomic_store_explicit(&diario->falhou, true, memory_order_relaxed);
+			}
+			diario->sincronizacoes++;
+			ultimaSincronizacao = agora;
+			pendente = false;
+		}
+		if (encerrar && !escreveu)
+		{
+			return;
+		}
+		if (!escreveu)
+		{
+			pausarEscrita();
+		}
+	}
+}
+
+#ifdef _WIN32
+static DWORD WINAPI threadEscrita(LPVOID parametro)
+{
+	executarEscrita((Diario*)parametro);
+	return 0;
+}
+#else
+static void* threadEscrita(void* parametro)
+{
+	executarEscrita((Diario*)parametro);
+	return NULL;
+}
+#endif
+
+// **** Diário ****
+
+bool abrirDiario(Diario* diario, const char* caminho, uint32_t capacidade, int intervaloFsyncMs)
+{
+	memset(diario, 0, sizeof(*diario));
+	uint32_t potencia = 1024;
+	while (potencia < capacidade && potencia < (1u << 31))
+	{
+		potencia <<= 1;
+	}
+	diario->mascara = potencia - 1;
+	diario->intervaloFsyncNs = (int64_t)(intervaloFsyncMs > 0 ? intervaloFsyncMs : 0) * 1000000;
+	diario->anel = alocarMemoria(potencia);
+	diario->arquivo = abrirArquivoDiario(caminho);
+	if (diario->anel == NULL || diario->arquivo < 0)
+	{
+		liberarMemoria(diario->anel);
+		if (diario->arquivo >= 0)
+		{
+			fecharArquivoDiario(diario->arquivo);
+		}
+		return false;
+	}
+
+	uint8_t cabecalho[TAM_CABECALHO_DIARIO] = { 'T', 'T', 'D', 'I', VERSAO_DIARIO, 0, 0, 0 };
+	bool iniciado = escreverTudo(diario->arquivo, cabecalho, sizeof(cabecalho));
+#ifdef _WIN32
+	HANDLE thread = iniciado ? CreateThread(NULL, 0, threadEscrita, diario, 0, NULL) : NULL;
+	iniciado = thread != NULL;
+	diario->thread = thread;
+#else
+	pthread_t* thread = alocarMemoria(sizeof(pthread_t));
+	iniciado = iniciado && thread != NULL && pthread_create(thread, NULL, threadEscrita, diario) == 0;
+	diario->thread = thread;
+#endif
+	if (!iniciado)
+	{
+#ifndef _WIN32
+		liberarMemoria(diario->thread);
+#endif
+		liberarMemoria(diario->anel);
+		fecharArquivoDiario(diario->arquivo);
+		return false;
+	}
+	return true;
+}
+
+bool registrarDiario(Diario* diario, const void* registro, uint32_t tamanho)
+{
+	// Somente o produtor escreve publicados: a leitura relaxada é exata.
+	uint64_t publicados = atomic_load_explicit(&diario->publicados, memory_order_relaxed);
+	uint64_t liberados = atomic_load_explicit(&diario->liberados, memory_order_acquire);
+	uint64_t capacidade = (uint64_t)diario->mascara + 1;
+	if (capacidade - (publicados - liberados) < tamanho)
+	{
+		diario->recusados++;
+		return false;
+	}
+
+	uint32_t inicio = (uint32_t)(publicados & diario->mascara);
+	uint32_t primeiro = tamanho < capacidade - inicio ? tamanho : (uint32_t)(capacidade - inicio);
+	memcpy(&diario->anel[inicio], registro, primeiro);
+	memcpy(diario->anel, (const uint8_t*)registro + primeiro, tamanho - primeiro);
+
+	atomic_store_explicit(&diario->publicados, publicados + tamanho, memory_order_release);
+	diario->registros++;
+	return true;
+}
+
+bool registrarAcaoDiario(Diario* diario, const Sessao* sessao, CodigoAcao acao)
+{
+	uint8_t registro[TAM_REGISTRO_ACAO_DIARIO] = { 0 };
+	uint64_t campos[3] = { diario->proximaAcao++, (uint64_t)relogioMonotonicoNs(), (uint64_t)sessao->pontuacao.pontos };
+	for (int c = 0; c < 3; c++)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			registro[8 * c + i] = (uint8_t)(campos[c] >> (8 * i));
+		}
+	}
+	registro[24] = (uint8_t)acao;
+	registro[25] = sessao->trocou ? 1 : 0;
+	for (int i = 0, idx = sessao->fila.inicio; i < sessao->fila.total; i++, idx = avancarFila(idx))
+	{
+		registro[26 + i] = (uint8_t)sessao->fila.itens[idx].tipo;
+	}
+	for (int i = 0; i <= sessao->pilha.topo; i++)
+	{
+		registro[26 + TAM_MAX_FILA + i] = (uint8_t)sessao->pilha.itens[i].tipo;
+	}
+
+	return registrarDiario(diario, registro, sizeof(registro));
+}
+
+bool fecharDiario(Diario* diario)
+{
+	atomic_store_explicit(&diario->encerrar, true, memory_order_release);
+#ifdef _WIN32
+	WaitForSingleObject((HANDLE)diario->thread, INFINITE);
+	CloseHandle((HANDLE)diario->thread);
+#else
+	pthread_join(*(pthread_t*)diario->thread, NULL);
+	liberarMemoria(diario->thread);
+#endif
+	diario->thread = NULL;
+
+	fecharArquivoDiario(diario->arquivo);
+	liberarMemoria(diario->anel);
+	diario->anel = NULL;
+	return !atomic_load(&diario->falhou);
+}
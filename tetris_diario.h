@@ -0,0 +1,95 @@
+#ifndef TETRIS_DIARIO_H
+#define TETRIS_DIARIO_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Diário assíncrono: o laço do jogo nunca espera pelo disco. Os registros codificados são copiados para
+// um anel de bytes sem travas(um produtor, o laço do jogo, e um consumidor, a thread de escrita), e a
+// thread de escrita os agrupa em escritas grandes, com fsync agrupado(group commit) a cada intervalo
+// configurável. Com o anel cheio, o registro é recusado e contabilizado(pressão de retorno): nada é
+// descartado silenciosamente, e o produtor decide o que fazer.
+//
+// Leiaute do arquivo(inteiros em little-endian):
+//   cabeçalho: "TTDI", versão(1 byte), 3 bytes reservados.
+//   registros: sequências de bytes gravadas por registrarDiario, na ordem de chegada.
+//
+// O registro de ações do nível Mestre(registrarAcaoDiario) tem TAM_REGISTRO_ACAO_DIARIO bytes: a ação e
+// uma fotografia dos tipos das peças após a ação.
+//   número da ação(8 bytes), instante(8 bytes, ns do relógio monotônico), pontos(8 bytes), ação(1 byte),
+//   flag de troca(1 byte), tipos da fila a partir da frente(TAM_MAX_FILA bytes), tipos da pilha a partir
+//   da base(TAM_MAX_PILHA bytes, 0 nas posições vazias).
+
+// **** Definições de constantes. ****
+
+/// @brief Versão do formato gravada no cabeçalho.
+#define VERSAO_DIARIO 1
+
+/// @brief Capacidade padrão do anel, em bytes(potência de 2).
+#define CAPACIDADE_PADRAO_DIARIO (1 << 20)
+
+/// @brief Intervalo padrão entre os fsync agrupados, em milissegundos.
+#define INTERVALO_PADRAO_FSYNC_MS 50
+
+/// @brief Tamanho do registro de uma ação, em bytes.
+#define TAM_REGISTRO_ACAO_DIARIO (26 + TAM_MAX_FILA + TAM_MAX_PILHA)
+
+// **** Declarações de estruturas. ****
+
+/// @brief Diário assíncrono. Os índices do anel são contadores crescentes de bytes(posição = índice & máscara).
+typedef struct {
+	uint8_t* anel;
+	uint32_t mascara;
+	/// @brief Bytes publicados pelo produtor(escrito somente pelo produtor).
+	_Atomic uint64_t publicados;
+	/// @brief Bytes já escritos no arquivo, e liberados no anel(escrito somente pela thread de escrita).
+	/// Em outra linha de cache, para que o produtor e a thread de escrita não disputem a mesma linha.
+	_Alignas(64) _Atomic uint64_t liberados;
+	_Atomic bool encerrar;
+	_Atomic bool falhou;
+	/// @brief Descritor do arquivo.
+	int arquivo;
+	/// @brief Intervalo entre os fsync, em nanossegundos.
+	int64_t intervaloFsyncNs;
+	/// @brief Identificador da thread de escrita(pthread_t ou HANDLE).
+	void* thread;
+	/// @brief Estatísticas do produtor.
+	uint64_t registros;
+	uint64_t recusados;
+	/// @brief Estatísticas da thread de escrita(consultadas após o encerramento).
+	uint64_t escritas;
+	uint64_t sincronizacoes;
+	/// @brief Número da próxima ação de registrarAcaoDiario.
+	uint64_t proximaAcao;
+} Diario;
+
+// **** Declarações das funções. ****
+
+/// @brief Cria o arquivo do diário, escreve o cabeçalho e inicia a thread de escrita.
+/// @param Diario. Ponteiro via referência, para efetuar a inicialização. Não deve ser copiado após a abertura.
+/// @param Texto. Caminho do arquivo de destino.
+/// @param Inteiro. Capacidade do anel, em bytes(arredondada para a próxima potência de 2).
+/// @param Inteiro. Intervalo entre os fsync agrupados, em milissegundos(0: fsync após cada escrita).
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool abrirDiario(Diario* diario, const char* caminho, uint32_t capacidade, int intervaloFsyncMs);
+/// @brief Publica um registro no anel, sem bloquear e sem chamadas de sistema.
+/// @param Diario. Ponteiro via referência, do diário.
+/// @param void. Conteúdo do registro. Somente leitura.
+/// @param Inteiro. Tamanho do registro, em bytes.
+/// @returns Verdadeiro(true), se publicado. Falso(false), se o anel estiver cheio(o registro é recusado e contabilizado).
+bool registrarDiario(Diario* diario, const void* registro, uint32_t tamanho);
+/// @brief Codifica e publica o registro de uma ação aplicada à sessão(ver leiaute em tetris_diario.h).
+/// @param Diario. Ponteiro via referência, do diário.
+/// @param Sessao. Ponteiro da sessão, após a ação. Somente leitura.
+/// @param CodigoAcao. Ação aplicada.
+/// @returns Verdadeiro(true), se publicado. Falso(false), se o anel estiver cheio.
+bool registrarAcaoDiario(Diario* diario, const Sessao* sessao, CodigoAcao acao);
+/// @brief Encerra a thread de escrita após escrever e sincronizar todos os registros publicados, e fecha o arquivo.
+/// @param Diario. Ponteiro via referência, a ser finalizado.
+/// @returns Verdadeiro(true), se todos os registros publicados foram escritos. Caso contrário, Falso(false).
+bool fecharDiario(Diario* diario);
+
+#endif // TETRIS_DIARIO_H
@@ -0,0 +1,127 @@
+#ifndef TETRIS_FIXAS_H
+#define TETRIS_FIXAS_H
+
+#include <stdbool.h>
+
+// Desafio Tetris Stack
+// Geradores, em tempo de compilação, da fila circular e da pilha de peças com capacidade fixa,
+// e das rotinas de troca entre elas. Com a capacidade constante, o compilador desenrola totalmente
+// os laços das capacidades pequenas(a configuração usual: fila de 5 e pilha de 3), e os índices
+// circulares dispensam a divisão(% capacidade): uma única subtração condicional, sem desvio.
+// Acima de LIMITE_DESENROLAMENTO, os laços permanecem(desenrolamento parcial). Para as configurações grandes,
+// ou quando a quantidade só é conhecida em tempo de execução, há a rotina de troca genérica, sem temporários.
+//
+// Uso(após a declaração de Peca):
+//   DEFINIR_FILA_FIXA(Fila, 5)                   -> tipo Fila, avancarFila(idx) e posicaoFila(fila, i).
+//   DEFINIR_PILHA_FIXA(Pilha, 3)                 -> tipo Pilha.
+//   DEFINIR_TROCA_GRUPO(trocar, Fila, Pilha, 3)  -> trocar(fila, pilha, inverter, paraPilha, paraFila).
+//   DEFINIR_TROCA_GRUPO_VARIAVEL(trocar, Fila, Pilha)
+//                                                -> trocar(fila, pilha, quantidade, inverter, paraPilha, paraFila).
+
+// **** Definições de constantes. ****
+
+/// @brief Maior quantidade de iterações totalmente desenrolada nas rotinas geradas.
+#ifndef LIMITE_DESENROLAMENTO
+#define LIMITE_DESENROLAMENTO 8
+#endif
+
+/// @brief Converte o texto da diretiva em _Pragma, após a expansão dos seus argumentos(ex: LIMITE_DESENROLAMENTO).
+#define DIRETIVA_PRAGMA(texto) _Pragma(#texto)
+#define DIRETIVA_DESENROLAR(limite) DIRETIVA_PRAGMA(GCC unroll limite)
+#define DIRETIVA_DESENROLAR_CLANG(limite) DIRETIVA_PRAGMA(clang loop unroll_count(limite))
+
+/// @brief Solicita ao compilador o desenrolamento do laço seguinte(até LIMITE_DESENROLAMENTO iterações).
+#if defined(__clang__)
+#define DESENROLAR DIRETIVA_DESENROLAR_CLANG(LIMITE_DESENROLAMENTO)
+#elif defined(__GNUC__)
+#define DESENROLAR DIRETIVA_DESENROLAR(LIMITE_DESENROLAMENTO)
+#else
+#define DESENROLAR
+#endif
+
+// **** Geradores. ****
+
+/// @brief Declara uma fila circular de peças com a capacidade informada, e as suas funções de índice:
+/// avancar<Nome>(idx), posição seguinte à informada, e posicao<Nome>(fila, i), posição do i-ésimo
+/// elemento a partir do início(0 <= i < capacidade).
+#define DEFINIR_FILA_FIXA(Nome, Capacidade) \
+	typedef struct { \
+		Peca itens[Capacidade]; \
+		int inicio; \
+		int fim; \
+		int total; \
+	} Nome; \
+	static inline int avancar##Nome(int idx) \
+	{ \
+		return idx + 1 < (Capacidade) ? idx + 1 : 0; \
+	} \
+	static inline int posicao##Nome(const Nome* fila, int i) \
+	{ \
+		int idx = fila->inicio + i; \
+		return idx < (Capacidade) ? idx : idx - (Capacidade); \
+	}
+
+/// @brief Declara uma pilha de peças com a capacidade informada(topo -1 se vazia).
+#define DEFINIR_PILHA_FIXA(Nome, Capacidade) \
+	typedef struct { \
+		Peca itens[Capacidade]; \
+		int topo; \
+	} Nome;
+
+/// @brief Declara a rotina de troca em grupo entre a fila e a pilha, com a quantidade informada:
+/// os primeiros elementos da fila e os elementos da pilha(a partir da base) trocam de lugar.
+/// Os elementos da pilha entram na fila em ordem invertida. Os da fila entram na pilha na mesma ordem,
+/// ou invertidos se inverter for verdadeiro(restaurando um grupo já trocado).
+/// Os vetores paraPilha e paraFila(opcionais, podem ser NULL) recebem as peças movidas, na ordem da troca.
+#define DEFINIR_TROCA_GRUPO(NomeFuncao, TipoFila, TipoPilha, Quantidade) \
+	static inline void NomeFuncao(TipoFila* fila, TipoPilha* pilha, bool inverter, Peca* paraPilha, Peca* paraFila) \
+	{ \
+		Peca tmpFila[Quantidade], tmpPilha[Quantidade]; \
+		DESENROLAR \
+		for (int i = 0; i < (Quantidade); i++) \
+		{ \
+			tmpFila[i] = fila->itens[posicao##TipoFila(fila, i)]; \
+			tmpPilha[i] = pilha->itens[i]; \
+		} \
+		DESENROLAR \
+		for (int i = 0; i < (Quantidade); i++) \
+		{ \
+			Peca movida = inverter ? tmpFila[(Quantidade) - 1 - i] : tmpFila[i]; \
+			fila->itens[posicao##TipoFila(fila, i)] = tmpPilha[(Quantidade) - 1 - i]; \
+			pilha->itens[i] = movida; \
+			if (paraPilha != NULL) \
+			{ \
+				paraPilha[i] = movida; \
+				paraFila[i] = tmpPilha[i]; \
+			} \
+		} \
+	}
+
+/// @brief Declara a rotina de troca em grupo genérica, com a quantidade informada em tempo de execução
+/// (de 0 à capacidade da pilha, e até o total da fila), e a mesma regra de DEFINIR_TROCA_GRUPO.
+/// Sem temporários por quantidade: as posições i e quantidade - 1 - i são trocadas juntas, no próprio lugar.
+#define DEFINIR_TROCA_GRUPO_VARIAVEL(NomeFuncao, TipoFila, TipoPilha) \
+	static inline void NomeFuncao(TipoFila* fila, TipoPilha* pilha, int quantidade, bool inverter, \
+		Peca* paraPilha, Peca* paraFila) \
+	{ \
+		for (int i = 0, j = quantidade - 1; i <= j; i++, j--) \
+		{ \
+			int posicaoI = posicao##TipoFila(fila, i); \
+			int posicaoJ = posicao##TipoFila(fila, j); \
+			Peca filaI = fila->itens[posicaoI], filaJ = fila->itens[posicaoJ]; \
+			Peca pilhaI = pilha->itens[i], pilhaJ = pilha->itens[j]; \
+			fila->itens[posicaoI] = pilhaJ; \
+			fila->itens[posicaoJ] = pilhaI; \
+			pilha->itens[i] = inverter ? filaJ : filaI; \
+			pilha->itens[j] = inverter ? filaI : filaJ; \
+			if (paraPilha != NULL) \
+			{ \
+				paraPilha[i] = pilha->itens[i]; \
+				paraPilha[j] = pilha->itens[j]; \
+				paraFila[i] = pilhaI; \
+				paraFila[j] = pilhaJ; \
+			} \
+		} \
+	}
+
+#endif // TETRIS_FIXAS_H
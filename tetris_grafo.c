@@ -0,0 +1,194 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_grafo.h"
+#include "tetris_memoria.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Capacidade do buffer local de novos estados de cada thread, antes da publicação na fronteira.
+#define TAM_BUFFER_FRONTEIRA 256
+
+/// @brief Quantidade de palavras de 64 bits do conjunto de visitados.
+#define TOTAL_PALAVRAS_VISITADOS ((TOTAL_ESTADOS + 63) / 64)
+
+// **** Implementações das funções. ****
+
+/// @brief Percorre as arestas de um estado na tabela: chama a macro VISITAR(sucessor) para cada uma.
+#define PERCORRER_ARESTAS(tabela, estado, mascara, VISITAR) \
+	for (int acao = ACAO_JOGAR_PECA; acao < TOTAL_ACOES; acao++) \
+	{ \
+		if (!((mascara) & (1u << acao))) \
+		{ \
+			continue; \
+		} \
+		int gerados = (acao == ACAO_JOGAR_PECA || acao == ACAO_RESERVAR_PECA) ? 4 : 1; \
+		for (int codigo = 0; codigo < gerados; codigo++) \
+		{ \
+			int32_t sucessor = transicaoEstado((tabela), (estado), (CodigoAcao)acao, codigo); \
+			if (sucessor >= 0) \
+			{ \
+				VISITAR(sucessor); \
+			} \
+		} \
+	}
+
+bool construirGrafo(const TabelaTransicoes* tabela, uint32_t mascaraAcoes, bool reverso, GrafoEstados* grafo)
+{
+	memset(grafo, 0, sizeof(*grafo));
+	grafo->inicio = alocarMemoriaZerada((size_t)TOTAL_ESTADOS + 1, sizeof(int32_t));
+	if (grafo->inicio == NULL)
+	{
+		return false;
+	}
+
+	// Primeira passagem: graus. Cada aresta e -> s conta em e(direto) ou em s(reverso).
+	int32_t* inicio = grafo->inicio;
+	for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+	{
+#define CONTAR(sucessor) inicio[(reverso ? (sucessor) : estado) + 1]++
+		PERCORRER_ARESTAS(tabela, estado, mascaraAcoes, CONTAR)
+#undef CONTAR
+	}
+	for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+	{
+		inicio[estado + 1] += inicio[estado];
+	}
+	grafo->totalArestas = inicio[TOTAL_ESTADOS];
+
+	grafo->vizinhos = alocarMemoria((size_t)(grafo->totalArestas > 0 ? grafo->totalArestas : 1) * sizeof(int32_t));
+	int32_t* posicoes = alocarMemoria((size_t)TOTAL_ESTADOS * sizeof(int32_t));
+	if (grafo->vizinhos == NULL || posicoes == NULL)
+	{
+		liberarMemoria(posicoes);
+		liberarGrafo(grafo);
+		return false;
+	}
+
+	// Segunda passagem: preenchimento, na ordem dos estados e das ações(grafo determinístico).
+	memcpy(posicoes, inicio, (size_t)TOTAL_ESTADOS * sizeof(int32_t));
+	int32_t* vizinhos = grafo->vizinhos;
+	for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+	{
+#define PREENCHER(sucessor) \
+		do \
+		{ \
+			if (reverso) \
+			{ \
+				vizinhos[posicoes[(sucessor)]++] = estado; \
+			} \
+			else \
+			{ \
+				vizinhos[posicoes[estado]++] = (sucessor); \
+			} \
+		} while (0)
+		PERCORRER_ARESTAS(tabela, estado, mascaraAcoes, PREENCHER)
+#undef PREENCHER
+	}
+
+	liberarMemoria(posicoes);
+	return true;
+}
+
+void liberarGrafo(GrafoEstados* grafo)
+{
+	liberarMemoria(grafo->inicio);
+	liberarMemoria(grafo->vizinhos);
+	memset(grafo, 0, sizeof(*grafo));
+}
+
+/// @brief Marca um estado como visitado.
+/// @returns Verdadeiro(true), se esta chamada o marcou. Falso(false), se já estava marcado.
+static inline bool marcarVisitado(_Atomic uint64_t* visitados, int32_t estado)
+{
+	uint64_t bit = 1ULL << (estado & 63);
+	_Atomic uint64_t* palavra = &visitados[estado >> 6];
+	// Leitura prévia, sem escrita: a maior parte dos vizinhos já foi visitada nos níveis finais.
+	if (atomic_load_explicit(palavra, memory_order_relaxed) & bit)
+	{
+		return false;
+	}
+	return !(atomic_fetch_or_explicit(palavra, bit, memory_order_relaxed) & bit);
+}
+
+int32_t buscarLargura(const GrafoEstados* grafo, const int32_t* origens, int32_t totalOrigens, uint8_t* distancias)
+{
+	_Atomic uint64_t* visitados = alocarMemoriaZerada(TOTAL_PALAVRAS_VISITADOS, sizeof(_Atomic uint64_t));
+	int32_t* fronteira = alocarMemoria((size_t)TOTAL_ESTADOS * sizeof(int32_t));
+	int32_t* proxima = alocarMemoria((size_t)TOTAL_ESTADOS * sizeof(int32_t));
+	if (visitados == NULL || fronteira == NULL || proxima == NULL)
+	{
+		liberarMemoria((void*)visitados);
+		liberarMemoria(fronteira);
+		liberarMemoria(proxima);
+		return -1;
+	}
+
+	memset(distancias, DISTANCIA_INALCANCAVEL, (size_t)TOTAL_ESTADOS);
+	int32_t totalFronteira = 0;
+	for (int32_t i = 0; i < totalOrigens; i++)
+	{
+		if (marcarVisitado(visitados, origens[i]))
+		{
+			distancias[origens[i]] = 0;
+			fronteira[totalFronteira++] = origens[i];
+		}
+	}
+
+	int32_t alcancados = totalFronteira;
+	for (int nivel = 1; totalFronteira > 0; nivel++)
+	{
+		uint8_t distancia = (uint8_t)(nivel < DISTANCIA_INALCANCAVEL ? nivel : DISTANCIA_INALCANCAVEL - 1);
+		_Atomic int32_t totalProxima = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+		{
+			int32_t buffer[TAM_BUFFER_FRONTEIRA];
+			int pendentes = 0;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1024)
+#endif
+			for (int32_t i = 0; i < totalFronteira; i++)
+			{
+				int32_t estado = fronteira[i];
+				for (int32_t k = grafo->inicio[estado]; k < grafo->inicio[estado + 1]; k++)
+				{
+					int32_t vizinho = grafo->vizinhos[k];
+					if (!marcarVisitado(visitados, vizinho))
+					{
+						continue;
+					}
+					// Cada estado é marcado por uma única thread: a escrita da distância não concorre.
+					distancias[vizinho] = distancia;
+					buffer[pendentes++] = vizinho;
+					if (pendentes == TAM_BUFFER_FRONTEIRA)
+					{
+						int32_t destino = atomic_fetch_add_explicit(&totalProxima, pendentes, memory_order_relaxed);
+						memcpy(&proxima[destino], buffer, (size_t)pendentes * sizeof(int32_t));
+						pendentes = 0;
+					}
+				}
+			}
+
+			if (pendentes > 0)
+			{
+				int32_t destino = atomic_fetch_add_explicit(&totalProxima, pendentes, memory_order_relaxed);
+				memcpy(&proxima[destino], buffer, (size_t)pendentes * sizeof(int32_t));
+			}
+		}
+
+		int32_t* troca = fronteira;
+		fronteira = proxima;
+		proxima = troca;
+		totalFronteira = atomic_load(&totalProxima);
+		alcancados += totalFronteira;
+	}
+
+	liberarMemoria((void*)visitados);
+	liberarMemoria(fronteira);
+	liberarMemoria(proxima);
+	return alcancados;
+}
@@ -0,0 +1,60 @@
+#ifndef TETRIS_GRAFO_H
+#define TETRIS_GRAFO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_transicoes.h"
+
+// Desafio Tetris Stack
+// Grafo de estados explícito, a partir da tabela de transições(tetris_transicoes.h), e busca em largura
+// sobre ele. Cada ação efetuada com sucesso é uma aresta. Jogar e reservar geram uma aresta por tipo
+// da peça gerada: as distâncias consideram a sequência de peças mais favorável.
+//
+// O grafo é armazenado em listas de adjacência compactas(CSR): os vizinhos do estado e ficam em
+// vizinhos[inicio[e]] até vizinhos[inicio[e + 1] - 1]. No grafo reverso, os vizinhos são os antecessores:
+// a busca a partir de um conjunto de destinos calcula a distância de cada estado até eles(retrógrada).
+//
+// A busca é sincronizada por nível: cada nível da fronteira é dividido entre as threads(OpenMP, se houver),
+// os estados visitados ficam em um conjunto de bits(marcados atomicamente), e cada thread acumula os
+// novos estados em um buffer local antes de publicá-los na próxima fronteira.
+
+// **** Definições de constantes. ****
+
+/// @brief Distância dos estados não alcançados pela busca.
+#define DISTANCIA_INALCANCAVEL 0xFF
+
+/// @brief Máscara com todas as ações(bit de cada CodigoAcao).
+#define TODAS_ACOES_GRAFO ((uint32_t)(((1u << TOTAL_ACOES) - 1) & ~(1u << ACAO_SAIR)))
+
+// **** Declarações de estruturas. ****
+
+/// @brief Grafo de estados em listas de adjacência compactas.
+typedef struct {
+	/// @brief Início dos vizinhos de cada estado(TOTAL_ESTADOS + 1 entradas).
+	int32_t* inicio;
+	int32_t* vizinhos;
+	int32_t totalArestas;
+} GrafoEstados;
+
+// **** Declarações das funções. ****
+
+/// @brief Constrói o grafo de estados a partir da tabela de transições.
+/// @param TabelaTransicoes. Ponteiro da tabela. Somente leitura.
+/// @param Inteiro. Máscara das ações consideradas(bit de cada CodigoAcao). Ex: TODAS_ACOES_GRAFO.
+/// @param Booleano. Verdadeiro(true), para o grafo reverso(arestas dos sucessores para os antecessores).
+/// @param GrafoEstados. Ponteiro via referência, a conter o grafo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória.
+bool construirGrafo(const TabelaTransicoes* tabela, uint32_t mascaraAcoes, bool reverso, GrafoEstados* grafo);
+/// @brief Libera a memória do grafo.
+/// @param GrafoEstados. Ponteiro via referência, a ser finalizado.
+void liberarGrafo(GrafoEstados* grafo);
+/// @brief Busca em largura paralela, a partir de um conjunto de origens.
+/// @param GrafoEstados. Ponteiro do grafo. Somente leitura.
+/// @param Inteiro. Vetor com os índices das origens(distância 0). Somente leitura.
+/// @param Inteiro. Quantidade de origens.
+/// @param Inteiro. Vetor(TOTAL_ESTADOS) a conter a distância de cada estado, limitada a
+/// DISTANCIA_INALCANCAVEL - 1, ou DISTANCIA_INALCANCAVEL se o estado não for alcançado.
+/// @returns Inteiro. Quantidade de estados alcançados(incluindo as origens), ou -1 se não houver memória.
+int32_t buscarLargura(const GrafoEstados* grafo, const int32_t* origens, int32_t totalOrigens, uint8_t* distancias);
+
+#endif // TETRIS_GRAFO_H
@@ -0,0 +1,460 @@
+#ifndef _WIN32
+// Deslocamentos de 64 bits(fseeko e ftello), também nas plataformas de 32 bits.
+#define _FILE_OFFSET_BITS 64
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_gravacao.h"
+#include "tetris_memoria.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Tamanho do cabeçalho do arquivo, em bytes.
+#define TAM_CABECALHO_GRAVACAO 8
+
+/// @brief Tamanho do cabeçalho de cada bloco, em bytes.
+#define TAM_CABECALHO_BLOCO 12
+
+/// @brief Tamanho do rodapé do arquivo, em bytes.
+#define TAM_RODAPE_GRAVACAO 16
+
+/// @brief Tamanho de cada entrada do índice no arquivo(posição e primeiro evento), em bytes.
+#define TAM_ENTRADA_INDICE_GRAVACAO 16
+
+// **** Implementações das funções. ****
+
+// **** Arquivo ****
+
+/// @brief Posiciona o arquivo com um deslocamento de 64 bits(fseek usa long, de 32 bits no Windows).
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+static bool posicionarArquivo(FILE* arquivo, int64_t deslocamento, int origem)
+{
+#ifdef _WIN32
+	return _fseeki64(arquivo, deslocamento, origem) == 0;
+#else
+	return fseeko(arquivo, (off_t)deslocamento, origem) == 0;
+#endif
+}
+
+/// @brief Recupera a posição atual do arquivo, com 64 bits.
+/// @returns Inteiro. Posição atual, ou -1 em caso de falha.
+static int64_t posicaoArquivo(FILE* arquivo)
+{
+#ifdef _WIN32
+	return _ftelli64(arquivo);
+#else
+	return (int64_t)ftello(arquivo);
+#endif
+}
+
+// **** Codificação ****
+
+/// @brief Escreve um inteiro de 32 bits em little-endian.
+static void escreverU32(uint8_t* destino, uint32_t valor)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		destino[i] = (uint8_t)(valor >> (8 * i));
+	}
+}
+
+/// @brief Escreve um inteiro de 64 bits em little-endian.
+static void escreverU64(uint8_t* destino, uint64_t valor)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		destino[i] = (uint8_t)(valor >> (8 * i));
+	}
+}
+
+/// @brief Lê um inteiro de 32 bits em little-endian.
+static uint32_t lerU32(const uint8_t* origem)
+{
+	uint32_t valor = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		valor |= (uint32_t)origem[i] << (8 * i);
+	}
+	return valor;
+}
+
+/// @brief Lê um inteiro de 64 bits em little-endian.
+static uint64_t lerU64(const uint8_t* origem)
+{
+	uint64_t valor = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		valor |= (uint64_t)origem[i] << (8 * i);
+	}
+	return valor;
+}
+
+/// @brief Converte uma diferença com sinal em um valor sem sinal(zigzag), para que deltas
+/// pequenos, positivos ou negativos, ocupem poucos bytes no varint.
+static uint64_t codificarZigzag(uint64_t atual, uint64_t anterior)
+{
+	int64_t delta = (int64_t)(atual - anterior);
+	return ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+}
+
+/// @brief Reverte a conversão zigzag, aplicando o delta à referência anterior.
+static uint64_t decodificarZigzag(uint64_t codificado, uint64_t anterior)
+{
+	uint64_t delta = (codificado >> 1) ^ (0 - (codificado & 1));
+	return anterior + delta;
+}
+
+/// @brief Escreve um varint(LEB128: 7 bits por byte, com o bit mais alto indicando continuação).
+/// @returns Inteiro. Quantidade de bytes escritos.
+static uint32_t escreverVarint(uint8_t* destino, uint64_t valor)
+{
+	uint32_t tamanho = 0;
+	while (valor >= 0x80)
+	{
+		destino[tamanho++] = (uint8_t)(valor | 0x80);
+		valor >>= 7;
+	}
+	destino[tamanho++] = (uint8_t)valor;
+	return tamanho;
+}
+
+/// @brief Lê um varint, sem ultrapassar o limite informado.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o varint estiver truncado.
+static bool lerVarint(const uint8_t* origem, uint32_t limite, uint32_t* posicao, uint64_t* valor)
+{
+	uint64_t resultado = 0;
+	for (int deslocamento = 0; deslocamento < 64 && *posicao < limite; deslocamento += 7)
+	{
+		uint8_t byte = origem[(*posicao)++];
+		resultado |= (uint64_t)(byte & 0x7F) << deslocamento;
+		if ((byte & 0x80) == 0)
+		{
+			*valor = resultado;
+			return true;
+		}
+	}
+	return false;
+}
+
+// **** Gravação ****
+
+/// @brief Inicia um novo bloco: fluxos vazios e referências dos deltas reiniciadas.
+static void reiniciarBloco(Gravador* gravador)
+{
+	memset(gravador->codigos, 0, (gravador->eventosBloco * BITS_CODIGO_GRAVACAO + 7) / 8);
+	gravador->eventosBloco = 0;
+	gravador->tamanhoValores = 0;
+	gravador->sementeAnterior = 0;
+	gravador->sequencialAnterior = 0;
+}
+
+/// @brief Escreve o bloco pendente e registra a sua posição no índice. O estado do bloco é sempre
+/// reiniciado, mesmo após uma falha: os fluxos nunca ultrapassam a sua capacidade.
+static void escreverBloco(Gravador* gravador)
+{
+	if (gravador->eventosBloco == 0)
+	{
+		return;
+	}
+	if (gravador->falhou)
+	{
+		reiniciarBloco(gravador);
+		return;
+	}
+
+	// O índice não cresce durante a partida: ao atingir a capacidade máxima, a gravação falha.
+	if (gravador->totalBlocos == gravador->capacidadeIndice)
+	{
+		gravador->falhou = true;
+		reiniciarBloco(gravador);
+		return;
+	}
+
+	EntradaIndice* entrada = &gravador->indice[gravador->totalBlocos++];
+	entrada->posicao = gravador->posicao;
+	entrada->primeiroEvento = gravador->totalEventos - gravador->eventosBloco;
+
+	uint32_t tamanhoCodigos = (gravador->eventosBloco * BITS_CODIGO_GRAVACAO + 7) / 8;
+	uint8_t cabecalho[TAM_CABECALHO_BLOCO];
+	escreverU32(cabecalho, gravador->eventosBloco);
+	escreverU32(cabecalho + 4, tamanhoCodigos);
+	escreverU32(cabecalho + 8, gravador->tamanhoValores);
+
+	if (fwrite(cabecalho, 1, sizeof(cabecalho), gravador->arquivo) != sizeof(cabecalho)
+		|| fwrite(gravador->codigos, 1, tamanhoCodigos, gravador->arquivo) != tamanhoCodigos
+		|| fwrite(gravador->valores, 1, gravador->tamanhoValores, gravador->arquivo) != gravador->tamanhoValores)
+	{
+		gravador->falhou = true;
+	}
+	gravador->posicao += sizeof(cabecalho) + tamanhoCodigos + gravador->tamanhoValores;
+
+	reiniciarBloco(gravador);
+}
+
+/// @brief Acrescenta um código ao bloco atual, escrevendo o bloco antes, se estiver cheio.
+/// @param Booleano. Indica se o evento terá um valor(varint) associado.
+/// @returns Verdadeiro(true), se o código foi acrescentado. Falso(false), após uma falha de escrita:
+/// os eventos seguintes são descartados.
+static bool gravarCodigo(Gravador* gravador, uint8_t codigo, bool comValor)
+{
+	if (gravador->eventosBloco == TAM_MAX_EVENTOS_BLOCO
+		|| (comValor && gravador->tamanhoValores + TAM_MAX_VARINT > TAM_MAX_VALORES_BLOCO))
+	{
+		escreverBloco(gravador);
+	}
+	if (gravador->falhou || gravador->eventosBloco >= TAM_MAX_EVENTOS_BLOCO)
+	{
+		return false;
+	}
+
+	uint32_t bit = gravador->eventosBloco * BITS_CODIGO_GRAVACAO;
+	uint32_t valor = (uint32_t)codigo << (bit % 8);
+	gravador->codigos[bit / 8] |= (uint8_t)valor;
+	if (valor > 0xFF)
+	{
+		gravador->codigos[bit / 8 + 1] |= (uint8_t)(valor >> 8);
+	}
+
+	gravador->eventosBloco++;
+	gravador->totalEventos++;
+	return true;
+}
+
+bool abrirGravacao(Gravador* gravador, const char* caminho)
+{
+	memset(gravador, 0, sizeof(*gravador));
+
+	// O índice é reservado aqui, com a capacidade máxima, e não no primeiro bloco: a gravação não aloca
+	// durante a partida. As páginas ainda não usadas não ocupam memória física.
+	gravador->indice = alocarMemoria(TAM_MAX_BLOCOS_GRAVACAO * sizeof(EntradaIndice));
+	gravador->arquivo = gravador->indice != NULL ? fopen(caminho, "wb") : NULL;
+	if (gravador->arquivo == NULL)
+	{
+		liberarMemoria(gravador->indice);
+		gravador->indice = NULL;
+		return false;
+	}
+	gravador->capacidadeIndice = TAM_MAX_BLOCOS_GRAVACAO;
+
+	uint8_t cabecalho[TAM_CABECALHO_GRAVACAO] = { 'T', 'T', 'R', 'P', VERSAO_GRAVACAO, 0, 0, 0 };
+	if (fwrite(cabecalho, 1, sizeof(cabecalho), gravador->arquivo) != sizeof(cabecalho))
+	{
+		gravador->falhou = true;
+	}
+	gravador->posicao = sizeof(cabecalho);
+
+	return true;
+}
+
+void gravarNovaPartida(Gravador* gravador, uint64_t semente)
+{
+	if (!gravarCodigo(gravador, CODIGO_NOVA_PARTIDA, true))
+	{
+		return;
+	}
+	gravador->tamanhoValores += escreverVarint(&gravador->valores[gravador->tamanhoValores],
+		codificarZigzag(semente, gravador->sementeAnterior));
+	gravador->sementeAnterior = semente;
+	// Toda partida começa com o contador sequencial zerado.
+	gravador->sequencialAnterior = 0;
+}
+
+void gravarAcao(Gravador* gravador, CodigoAcao acao)
+{
+	gravarCodigo(gravador, (uint8_t)acao, false);
+}
+
+void gravarVerificacao(Gravador* gravador, int64_t geradas)
+{
+	if (!gravarCodigo(gravador, CODIGO_VERIFICACAO, true))
+	{
+		return;
+	}
+	gravador->tamanhoValores += escreverVarint(&gravador->valores[gravador->tamanhoValores],
+		codificarZigzag((uint64_t)geradas, gravador->sequencialAnterior));
+	gravador->sequencialAnterior = (uint64_t)geradas;
+}
+
+bool fecharGravacao(Gravador* gravador)
+{
+	escreverBloco(gravador);
+
+	uint64_t posicaoIndice = gravador->posicao;
+	for (uint32_t b = 0; b < gravador->totalBlocos && !gravador->falhou; b++)
+	{
+		uint8_t entrada[TAM_ENTRADA_INDICE_GRAVACAO];
+		escreverU64(entrada, gravador->indice[b].posicao);
+		escreverU64(entrada + 8, gravador->indice[b].primeiroEvento);
+		gravador->falhou = fwrite(entrada, 1, sizeof(entrada), gravador->arquivo) != sizeof(entrada);
+	}
+
+	uint8_t rodape[TAM_RODAPE_GRAVACAO];
+	escreverU64(rodape, posicaoIndice);
+	escreverU32(rodape + 8, gravador->totalBlocos);
+	memcpy(rodape + 12, "TTRI", 4);
+	if (!gravador->falhou && fwrite(rodape, 1, sizeof(rodape), gravador->arquivo) != sizeof(rodape))
+	{
+		gravador->falhou = true;
+	}
+
+	bool sucesso = fclose(gravador->arquivo) == 0 && !gravador->falhou;
+	liberarMemoria(gravador->indice);
+	gravador->arquivo = NULL;
+	gravador->indice = NULL;
+
+	return sucesso;
+}
+
+// **** Leitura ****
+
+/// @brief Carrega o próximo bloco do arquivo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), ao final ou se o bloco for inválido.
+static bool carregarBloco(LeitorGravacao* leitor)
+{
+	if (leitor->proximoBloco >= leitor->totalBlocos)
+	{
+		return false;
+	}
+
+	const EntradaIndice* entrada = &leitor->indice[leitor->proximoBloco++];
+	uint8_t cabecalho[TAM_CABECALHO_BLOCO];
+	if (!posicionarArquivo(leitor->arquivo, (int64_t)entrada->posicao, SEEK_SET)
+		|| fread(cabecalho, 1, sizeof(cabecalho), leitor->arquivo) != sizeof(cabecalho))
+	{
+		return false;
+	}
+
+	uint32_t eventos = lerU32(cabecalho);
+	uint32_t tamanhoCodigos = lerU32(cabecalho + 4);
+	uint32_t tamanhoValores = lerU32(cabecalho + 8);
+	if (eventos > TAM_MAX_EVENTOS_BLOCO || tamanhoCodigos != (eventos * BITS_CODIGO_GRAVACAO + 7) / 8
+		|| tamanhoValores > TAM_MAX_VALORES_BLOCO)
+	{
+		return false;
+	}
+
+	if (fread(leitor->codigos, 1, tamanhoCodigos, leitor->arquivo) != tamanhoCodigos
+		|| fread(leitor->valores, 1, tamanhoValores, leitor->arquivo) != tamanhoValores)
+	{
+		return false;
+	}
+	leitor->codigos[tamanhoCodigos] = 0;
+
+	leitor->eventosBloco = eventos;
+	leitor->tamanhoValores = tamanhoValores;
+	leitor->eventoAtual = 0;
+	leitor->posicaoValores = 0;
+	leitor->sementeAnterior = 0;
+	leitor->sequencialAnterior = 0;
+
+	return true;
+}
+
+bool abrirLeitura(LeitorGravacao* leitor, const char* caminho)
+{
+	memset(leitor, 0, sizeof(*leitor));
+
+	leitor->arquivo = fopen(caminho, "rb");
+	if (leitor->arquivo == NULL)
+	{
+		return false;
+	}
+
+	uint8_t cabecalho[TAM_CABECALHO_GRAVACAO];
+	uint8_t rodape[TAM_RODAPE_GRAVACAO];
+	int64_t posicaoRodape = -1;
+	bool valido = fread(cabecalho, 1, sizeof(cabecalho), leitor->arquivo) == sizeof(cabecalho)
+		&& memcmp(cabecalho, "TTRP", 4) == 0 && cabecalho[4] == VERSAO_GRAVACAO
+		&& posicionarArquivo(leitor->arquivo, -TAM_RODAPE_GRAVACAO, SEEK_END)
+		&& (posicaoRodape = posicaoArquivo(leitor->arquivo)) >= TAM_CABECALHO_GRAVACAO
+		&& fread(rodape, 1, sizeof(rodape), leitor->arquivo) == sizeof(rodape)
+		&& memcmp(rodape + 12, "TTRI", 4) == 0;
+
+	// O rodapé não é confiável: o índice deve ocupar exatamente o trecho entre a sua posição e o rodapé,
+	// e caber na capacidade do gravador, antes de qualquer alocação.
+	if (valido)
+	{
+		uint64_t posicaoIndice = lerU64(rodape);
+		leitor->totalBlocos = lerU32(rodape + 8);
+		valido = leitor->totalBlocos <= TAM_MAX_BLOCOS_GRAVACAO && posicaoIndice >= TAM_CABECALHO_GRAVACAO
+			&& posicaoIndice + (uint64_t)leitor->totalBlocos * TAM_ENTRADA_INDICE_GRAVACAO == (uint64_t)posicaoRodape;
+		if (valido)
+		{
+			leitor->indice = alocarMemoria((leitor->totalBlocos > 0 ? leitor->totalBlocos : 1) * sizeof(EntradaIndice));
+			valido = leitor->indice != NULL && posicionarArquivo(leitor->arquivo, (int64_t)posicaoIndice, SEEK_SET);
+		}
+	}
+
+	for (uint32_t b = 0; valido && b < leitor->totalBlocos; b++)
+	{
+		uint8_t entrada[TAM_ENTRADA_INDICE_GRAVACAO];
+		valido = fread(entrada, 1, sizeof(entrada), leitor->arquivo) == sizeof(entrada);
+		leitor->indice[b].posicao = lerU64(entrada);
+		leitor->indice[b].primeiroEvento = lerU64(entrada + 8);
+	}
+
+	if (!valido)
+	{
+		fecharLeitura(leitor);
+		return false;
+	}
+
+	return true;
+}
+
+bool lerEvento(LeitorGravacao* leitor, EventoGravacao* evento)
+{
+	while (leitor->eventoAtual >= leitor->eventosBloco)
+	{
+		if (!carregarBloco(leitor))
+		{
+			return false;
+		}
+	}
+
+	uint32_t bit = leitor->eventoAtual++ * BITS_CODIGO_GRAVACAO;
+	uint32_t par = leitor->codigos[bit / 8] | (uint32_t)leitor->codigos[bit / 8 + 1] << 8;
+	uint8_t codigo = (uint8_t)((par >> (bit % 8)) & ((1u << BITS_CODIGO_GRAVACAO) - 1));
+
+	if (codigo < CODIGO_VERIFICACAO)
+	{
+		evento->tipo = EVENTO_ACAO;
+		evento->acao = (CodigoAcao)codigo;
+		evento->valor = 0;
+		return true;
+	}
+
+	uint64_t codificado;
+	if (!lerVarint(leitor->valores, leitor->tamanhoValores, &leitor->posicaoValores, &codificado))
+	{
+		return false;
+	}
+
+	evento->acao = ACAO_SAIR;
+	if (codigo == CODIGO_NOVA_PARTIDA)
+	{
+		evento->tipo = EVENTO_NOVA_PARTIDA;
+		evento->valor = decodificarZigzag(codificado, leitor->sementeAnterior);
+		leitor->sementeAnterior = evento->valor;
+		leitor->sequencialAnterior = 0;
+	}
+	else
+	{
+		evento->tipo = EVENTO_VERIFICACAO;
+		evento->valor = decodificarZigzag(codificado, leitor->sequencialAnterior);
+		leitor->sequencialAnterior = evento->valor;
+	}
+
+	return true;
+}
+
+void fecharLeitura(LeitorGravacao* leitor)
+{
+	if (leitor->arquivo != NULL)
+	{
+		fclose(leitor->arquivo);
+	}
+	liberarMemoria(leitor->indice);
+	leitor->arquivo = NULL;
+	leitor->indice = NULL;
+}
@@ -0,0 +1,156 @@
+#ifndef TETRIS_GRAVACAO_H
+#define TETRIS_GRAVACAO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Gravação compacta de partidas, para reprodução(replay) e arquivamento.
+// O arquivo é dividido em blocos independentes. Cada bloco possui dois fluxos:
+// os códigos dos eventos, empacotados em 3 bits cada, e os valores dos eventos especiais
+// (sementes e identificações), codificados como deltas em varint(LEB128).
+// Ao final do arquivo, um índice com a posição e o primeiro evento de cada bloco.
+//
+// Leiaute do arquivo(inteiros de tamanho fixo em little-endian):
+//   cabeçalho: "TTRP", versão(1 byte), 3 bytes reservados.
+//   bloco:     total de eventos(4 bytes), tamanho dos códigos(4 bytes), tamanho dos valores(4 bytes),
+//              códigos, valores.
+//   índice:    por bloco, posição(8 bytes) e primeiro evento(8 bytes).
+//   rodapé:    posição do índice(8 bytes), total de blocos(4 bytes), "TTRI".
+
+// **** Definições de constantes. ****
+
+/// @brief Versão do formato gravada no cabeçalho.
+#define VERSAO_GRAVACAO 1
+
+/// @brief Bits usados por código de evento.
+#define BITS_CODIGO_GRAVACAO 3
+
+/// @brief Quantidade máxima de eventos por bloco.
+#define TAM_MAX_EVENTOS_BLOCO 65536
+
+/// @brief Tamanho máximo do fluxo de códigos de um bloco, em bytes.
+#define TAM_MAX_CODIGOS_BLOCO ((TAM_MAX_EVENTOS_BLOCO * BITS_CODIGO_GRAVACAO + 7) / 8)
+
+/// @brief Tamanho máximo do fluxo de valores(varints) de um bloco, em bytes.
+#define TAM_MAX_VALORES_BLOCO 16384
+
+/// @brief Tamanho máximo de um varint de 64 bits.
+#define TAM_MAX_VARINT 10
+
+/// @brief Quantidade máxima de blocos de uma gravação(o índice é reservado na abertura, sem realocações).
+/// Ao menos 400 milhões de eventos(blocos cheios de verificações); com blocos cheios de ações, 17 bilhões.
+#ifndef TAM_MAX_BLOCOS_GRAVACAO
+#define TAM_MAX_BLOCOS_GRAVACAO 262144
+#endif
+
+/// @brief Códigos especiais, após os códigos das ações(CodigoAcao, de 0 a 5).
+#define CODIGO_VERIFICACAO 6
+#define CODIGO_NOVA_PARTIDA 7
+
+// **** Declarações de estruturas. ****
+
+/// @brief Tipos de eventos gravados.
+typedef enum {
+	/// @brief Ação aplicada à sessão(com sucesso ou não).
+	EVENTO_ACAO,
+	/// @brief Ponto de verificação, com o total de peças geradas na sessão naquele momento.
+	EVENTO_VERIFICACAO,
+	/// @brief Início de uma nova partida, com a semente do gerador de peças.
+	EVENTO_NOVA_PARTIDA
+} TipoEvento;
+
+/// @brief Um evento decodificado.
+typedef struct {
+	TipoEvento tipo;
+	/// @brief Ação aplicada(somente EVENTO_ACAO).
+	CodigoAcao acao;
+	/// @brief Total de peças geradas(EVENTO_VERIFICACAO) ou semente(EVENTO_NOVA_PARTIDA).
+	uint64_t valor;
+} EventoGravacao;
+
+/// @brief Posição de um bloco no arquivo.
+typedef struct {
+	uint64_t posicao;
+	/// @brief Número(global) do primeiro evento do bloco.
+	uint64_t primeiroEvento;
+} EntradaIndice;
+
+/// @brief Gravador de partidas. Os eventos são acumulados em memória e escritos bloco a bloco.
+typedef struct {
+	FILE* arquivo;
+	uint8_t codigos[TAM_MAX_CODIGOS_BLOCO];
+	uint8_t valores[TAM_MAX_VALORES_BLOCO];
+	uint32_t eventosBloco;
+	uint32_t tamanhoValores;
+	/// @brief Referências dos deltas. Reiniciadas a cada bloco, para que sejam independentes.
+	uint64_t sementeAnterior;
+	uint64_t sequencialAnterior;
+	uint64_t totalEventos;
+	EntradaIndice* indice;
+	uint32_t totalBlocos;
+	uint32_t capacidadeIndice;
+	/// @brief Posição de escrita no arquivo(acompanhada aqui, sem ftell: 64 bits em todas as plataformas).
+	uint64_t posicao;
+	bool falhou;
+} Gravador;
+
+/// @brief Leitor sequencial de partidas gravadas.
+typedef struct {
+	FILE* arquivo;
+	EntradaIndice* indice;
+	uint32_t totalBlocos;
+	/// @brief Próximo bloco a ser carregado.
+	uint32_t proximoBloco;
+	/// @brief Um byte extra(zerado), para a leitura de códigos que cruzam o último byte.
+	uint8_t codigos[TAM_MAX_CODIGOS_BLOCO + 1];
+	uint8_t valores[TAM_MAX_VALORES_BLOCO];
+	uint32_t eventosBloco;
+	uint32_t tamanhoValores;
+	uint32_t eventoAtual;
+	uint32_t posicaoValores;
+	uint64_t sementeAnterior;
+	uint64_t sequencialAnterior;
+} LeitorGravacao;
+
+// **** Declarações das funções. ****
+
+/// @brief Cria o arquivo de gravação e escreve o cabeçalho.
+/// @param Gravador. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Caminho do arquivo de destino.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool abrirGravacao(Gravador* gravador, const char* caminho);
+/// @brief Grava o início de uma nova partida.
+/// @param Gravador. Ponteiro via referência, usado na gravação.
+/// @param Inteiro. Semente do gerador de peças da partida.
+void gravarNovaPartida(Gravador* gravador, uint64_t semente);
+/// @brief Grava uma ação aplicada à sessão.
+/// @param Gravador. Ponteiro via referência, usado na gravação.
+/// @param CodigoAcao. Ação aplicada.
+void gravarAcao(Gravador* gravador, CodigoAcao acao);
+/// @brief Grava um ponto de verificação, para conferência durante a reprodução.
+/// @param Gravador. Ponteiro via referência, usado na gravação.
+/// @param Inteiro. Total de peças geradas na sessão.
+void gravarVerificacao(Gravador* gravador, int64_t geradas);
+/// @brief Escreve o bloco pendente, o índice e o rodapé, e fecha o arquivo.
+/// @param Gravador. Ponteiro via referência, a ser finalizado.
+/// @returns Verdadeiro(true), se toda a gravação foi escrita com sucesso. Caso contrário, Falso(false).
+bool fecharGravacao(Gravador* gravador);
+
+/// @brief Abre um arquivo de gravação e carrega o índice de blocos.
+/// @param LeitorGravacao. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Caminho do arquivo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o arquivo não existir ou for inválido.
+bool abrirLeitura(LeitorGravacao* leitor, const char* caminho);
+/// @brief Lê o próximo evento, carregando o próximo bloco quando necessário.
+/// @param LeitorGravacao. Ponteiro via referência, usado na leitura.
+/// @param EventoGravacao. Ponteiro via referência, para conter o evento lido.
+/// @returns Verdadeiro(true), se um evento foi lido. Falso(false), ao final do arquivo ou em caso de falha.
+bool lerEvento(LeitorGravacao* leitor, EventoGravacao* evento);
+/// @brief Fecha o arquivo e libera o índice.
+/// @param LeitorGravacao. Ponteiro via referência, a ser finalizado.
+void fecharLeitura(LeitorGravacao* leitor);
+
+#endif // TETRIS_GRAVACAO_H
@@ -0,0 +1,207 @@
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+/// @brief Verifica se o descritor é um terminal.
+#define descritorTerminal(descritor) _isatty(descritor)
+#else
+#include <unistd.h>
+/// @brief Verifica se o descritor é um terminal.
+#define descritorTerminal(descritor) isatty(descritor)
+#endif
+#include "tetris_memoria.h"
+
+// **** Variáveis internas. ****
+
+#ifdef TETRIS_CONTAR_ALOCACOES
+/// @brief Contadores das alocações. Atômicos: a thread do diário e as threads do OpenMP também alocam.
+static _Atomic uint64_t contadorAlocacoes = 0;
+static _Atomic uint64_t contadorRegimePermanente = 0;
+static _Atomic bool regimePermanente = false;
+#endif
+
+// **** Implementações das funções. ****
+
+// **** Contagem de alocações ****
+
+#ifdef TETRIS_CONTAR_ALOCACOES
+
+/// @brief Contabiliza uma alocação. Não pode alocar: é chamada de dentro de malloc.
+static void contarAlocacao(void)
+{
+	atomic_fetch_add_explicit(&contadorAlocacoes, 1, memory_order_relaxed);
+	if (atomic_load_explicit(&regimePermanente, memory_order_relaxed))
+	{
+		atomic_fetch_add_explicit(&contadorRegimePermanente, 1, memory_order_relaxed);
+	}
+}
+
+#ifdef TETRIS_INTERPOR_ALOCADOR
+
+// Alocador original da glibc, sob os nomes internos exportados.
+extern void* __libc_malloc(size_t tamanho);
+extern void* __libc_calloc(size_t quantidade, size_t tamanho);
+extern void* __libc_realloc(void* memoria, size_t tamanho);
+
+// Substituições de malloc, calloc e realloc: definidas no executável, têm precedência sobre as da glibc
+// para todo o processo(inclusive nas bibliotecas dinâmicas). free não é substituída: a memória continua
+// sendo do alocador da glibc.
+
+void* malloc(size_t tamanho)
+{
+	contarAlocacao();
+	return __libc_malloc(tamanho);
+}
+
+void* calloc(size_t quantidade, size_t tamanho)
+{
+	contarAlocacao();
+	return __libc_calloc(quantidade, tamanho);
+}
+
+void* realloc(void* memoria, size_t tamanho)
+{
+	contarAlocacao();
+	return __libc_realloc(memoria, tamanho);
+}
+
+#else
+
+void* alocarMemoria(size_t tamanho)
+{
+	contarAlocacao();
+	return malloc(tamanho);
+}
+
+void* alocarMemoriaZerada(size_t quantidade, size_t tamanho)
+{
+	contarAlocacao();
+	return calloc(quantidade, tamanho);
+}
+
+void* realocarMemoria(void* memoria, size_t tamanho)
+{
+	contarAlocacao();
+	return realloc(memoria, tamanho);
+}
+
+#endif
+
+void iniciarRegimePermanente(void)
+{
+	atomic_store_explicit(&regimePermanente, true, memory_order_relaxed);
+}
+
+bool contagemAlocacoesAtiva(void)
+{
+	return true;
+}
+
+uint64_t totalAlocacoes(void)
+{
+	return atomic_load_explicit(&contadorAlocacoes, memory_order_relaxed);
+}
+
+uint64_t alocacoesRegimePermanente(void)
+{
+	return atomic_load_explicit(&contadorRegimePermanente, memory_order_relaxed);
+}
+
+#else
+
+void iniciarRegimePermanente(void)
+{
+}
+
+bool contagemAlocacoesAtiva(void)
+{
+	return false;
+}
+
+uint64_t totalAlocacoes(void)
+{
+	return 0;
+}
+
+uint64_t alocacoesRegimePermanente(void)
+{
+	return 0;
+}
+
+#endif
+
+// **** Buffers da entrada e da saída padrão ****
+
+void reservarBuffersPadrao(void)
+{
+	static char bufferEntrada[BUFSIZ];
+	static char bufferSaida[BUFSIZ];
+	setvbuf(stdin, bufferEntrada, _IOFBF, sizeof(bufferEntrada));
+	setvbuf(stdout, bufferSaida, descritorTerminal(fileno(stdout)) ? _IOLBF : _IOFBF, sizeof(bufferSaida));
+}
+
+// **** Pools ****
+
+bool inicializarPool(Pool* pool, size_t tamanhoObjeto, uint32_t capacidade)
+{
+	memset(pool, 0, sizeof(*pool));
+
+	// Cada objeto livre guarda o ponteiro do próximo: o tamanho mínimo é o de um ponteiro.
+	size_t alinhamento = alignof(max_align_t);
+	size_t tamanho = tamanhoObjeto > sizeof(void*) ? tamanhoObjeto : sizeof(void*);
+	tamanho = (tamanho + alinhamento - 1) / alinhamento * alinhamento;
+
+	pool->objetos = alocarMemoria(tamanho * (capacidade > 0 ? capacidade : 1));
+	if (pool->objetos == NULL)
+	{
+		return false;
+	}
+	pool->tamanhoObjeto = tamanho;
+	pool->capacidade = capacidade;
+
+	// A lista de livres percorre todo o bloco: as páginas são mapeadas aqui, e não durante o jogo.
+	void* proximo = NULL;
+	for (uint32_t i = capacidade; i > 0; i--)
+	{
+		void* objeto = pool->objetos + (size_t)(i - 1) * tamanho;
+		memcpy(objeto, &proximo, sizeof(proximo));
+		proximo = objeto;
+	}
+	pool->livres = proximo;
+	return true;
+}
+
+void* alocarPool(Pool* pool)
+{
+	void* objeto = pool->livres;
+	if (objeto == NULL)
+	{
+		pool->esgotamentos++;
+		return NULL;
+	}
+	memcpy(&pool->livres, objeto, sizeof(void*));
+	if (++pool->emUso > pool->maximoEmUso)
+	{
+		pool->maximoEmUso = pool->emUso;
+	}
+	return objeto;
+}
+
+void liberarPool(Pool* pool, void* objeto)
+{
+	if (objeto == NULL)
+	{
+		return;
+	}
+	memcpy(objeto, &pool->livres, sizeof(void*));
+	pool->livres = objeto;
+	pool->emUso--;
+}
+
+void finalizarPool(Pool* pool)
+{
+	liberarMemoria(pool->objetos);
+	memset(pool, 0, sizeof(*pool));
+}
@@ -0,0 +1,127 @@
+#ifndef TETRIS_MEMORIA_H
+#define TETRIS_MEMORIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Desafio Tetris Stack
+// Memória do núcleo: todas as alocações da biblioteca passam por alocarMemoria, realocarMemoria e
+// liberarMemoria, e as estruturas dinâmicas do laço do jogo vêm de pools de objetos de tamanho fixo,
+// reservados na inicialização. Em regime permanente(após iniciarRegimePermanente), nenhuma ação deve
+// chamar o alocador do sistema: sem disputa entre threads no alocador, e sem latências de cauda.
+//
+// Com a opção de compilação TETRIS_CONTAR_ALOCACOES(CMake: -DTETRIS_CONTAR_ALOCACOES=ON), as alocações
+// são contadas, separando as efetuadas em regime permanente, e os executáveis falham ao final se houver
+// alguma. Com a glibc, malloc, calloc e realloc do processo são substituídos(interpostos): todas as
+// alocações são contadas, inclusive as da stdio, do OpenMP e das threads. Nas demais plataformas, somente
+// as alocações feitas por alocarMemoria, alocarMemoriaZerada e realocarMemoria são contadas.
+// Sem a opção, as funções de alocação chamam diretamente malloc, calloc e realloc.
+
+// **** Definições de constantes. ****
+
+#if defined(TETRIS_CONTAR_ALOCACOES) && defined(__GLIBC__)
+/// @brief As alocações são contadas nas funções malloc, calloc e realloc substituídas(ver tetris_memoria.c).
+#define TETRIS_INTERPOR_ALOCADOR
+#endif
+
+// **** Declarações de estruturas. ****
+
+/// @brief Pool de objetos de tamanho fixo: um único bloco contíguo, reservado e percorrido(páginas
+/// já mapeadas) na inicialização, com os objetos livres encadeados entre si. Alocar e liberar custam
+/// O(1), sem chamadas ao alocador do sistema. Não é seguro para uso concorrente entre threads.
+typedef struct {
+	uint8_t* objetos;
+	/// @brief Primeiro objeto livre(o início de cada objeto livre aponta para o próximo).
+	void* livres;
+	/// @brief Tamanho de cada objeto, arredondado para o alinhamento máximo.
+	size_t tamanhoObjeto;
+	uint32_t capacidade;
+	uint32_t emUso;
+	/// @brief Maior quantidade de objetos em uso simultâneo(para dimensionar a capacidade).
+	uint32_t maximoEmUso;
+	/// @brief Alocações recusadas com o pool esgotado.
+	uint64_t esgotamentos;
+} Pool;
+
+// **** Declarações das funções. ****
+
+#if defined(TETRIS_CONTAR_ALOCACOES) && !defined(TETRIS_INTERPOR_ALOCADOR)
+
+/// @brief Aloca memória do sistema(malloc), contabilizada.
+/// @param Inteiro. Tamanho, em bytes.
+/// @returns Ponteiro da memória, ou NULL se não houver memória.
+void* alocarMemoria(size_t tamanho);
+/// @brief Aloca memória do sistema zerada(calloc), contabilizada.
+/// @param Inteiro. Quantidade de elementos.
+/// @param Inteiro. Tamanho de cada elemento, em bytes.
+/// @returns Ponteiro da memória, ou NULL se não houver memória.
+void* alocarMemoriaZerada(size_t quantidade, size_t tamanho);
+/// @brief Realoca memória do sistema(realloc), contabilizada.
+/// @param void. Ponteiro da memória atual, ou NULL.
+/// @param Inteiro. Novo tamanho, em bytes.
+/// @returns Ponteiro da memória, ou NULL se não houver memória(a memória atual é mantida).
+void* realocarMemoria(void* memoria, size_t tamanho);
+
+#else
+
+static inline void* alocarMemoria(size_t tamanho)
+{
+	return malloc(tamanho);
+}
+
+static inline void* alocarMemoriaZerada(size_t quantidade, size_t tamanho)
+{
+	return calloc(quantidade, tamanho);
+}
+
+static inline void* realocarMemoria(void* memoria, size_t tamanho)
+{
+	return realloc(memoria, tamanho);
+}
+
+#endif
+
+/// @brief Libera memória obtida de alocarMemoria, alocarMemoriaZerada ou realocarMemoria.
+/// @param void. Ponteiro da memória, ou NULL.
+static inline void liberarMemoria(void* memoria)
+{
+	free(memoria);
+}
+
+/// @brief Associa buffers estáticos à entrada e à saída padrão, no modo que a stdio usaria(saída com buffer
+/// de linha em terminais). Sem eles, a stdio aloca cada buffer no primeiro uso, já em regime permanente.
+/// Deve ser chamada antes de qualquer leitura ou escrita na entrada e na saída padrão.
+void reservarBuffersPadrao(void);
+/// @brief Indica o fim da inicialização: as alocações seguintes são contadas como de regime permanente.
+void iniciarRegimePermanente(void);
+/// @brief Verifica se a contagem de alocações foi habilitada na compilação(TETRIS_CONTAR_ALOCACOES).
+/// @returns Verdadeiro(true), se as alocações são contadas. Caso contrário, Falso(false).
+bool contagemAlocacoesAtiva(void);
+/// @brief Obtém a quantidade de alocações(e realocações) desde o início do programa.
+/// @returns Inteiro. Quantidade de alocações, ou 0 se a contagem não estiver habilitada.
+uint64_t totalAlocacoes(void);
+/// @brief Obtém a quantidade de alocações(e realocações) efetuadas em regime permanente.
+/// @returns Inteiro. Quantidade de alocações, ou 0 se a contagem não estiver habilitada.
+uint64_t alocacoesRegimePermanente(void);
+
+/// @brief Reserva o bloco de um pool, com todos os objetos livres.
+/// @param Pool. Ponteiro via referência, para efetuar a inicialização.
+/// @param Inteiro. Tamanho de cada objeto, em bytes.
+/// @param Inteiro. Quantidade de objetos.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória.
+bool inicializarPool(Pool* pool, size_t tamanhoObjeto, uint32_t capacidade);
+/// @brief Obtém um objeto livre do pool, em O(1).
+/// @param Pool. Ponteiro via referência, do pool.
+/// @returns Ponteiro do objeto(conteúdo indefinido), ou NULL se o pool estiver esgotado.
+void* alocarPool(Pool* pool);
+/// @brief Devolve um objeto ao pool, em O(1).
+/// @param Pool. Ponteiro via referência, do pool.
+/// @param void. Ponteiro do objeto obtido de alocarPool, ou NULL.
+void liberarPool(Pool* pool, void* objeto);
+/// @brief Libera o bloco do pool. Os objetos em uso tornam-se inválidos.
+/// @param Pool. Ponteiro via referência, a ser finalizado.
+void finalizarPool(Pool* pool);
+
+#endif // TETRIS_MEMORIA_H
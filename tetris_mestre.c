@@ -1,3 +1,5 @@
+#include <ctype.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -7,42 +9,88 @@
 #ifdef _WIN32
 #include <Windows.h>
 #endif
+#include "tetris_nucleo.h"
+#include "tetris_colunas.h"
+#include "tetris_diario.h"
+#include "tetris_gravacao.h"
+#include "tetris_memoria.h"
+#include "tetris_metricas.h"
+#include "tetris_observacao.h"
+#include "tetris_rastro.h"
+#include "tetris_revisao.h"
+#include "tetris_servidor.h"
+#include "tetris_tela.h"
+#include "tetris_tempo.h"
+#include "tetris_terminal.h"
+#include "tetris_versus.h"
 
 // Desafio Tetris Stack
 // Tema 3 - Integração de Fila e Pilha
 // Este código inicial serve como base para o desenvolvimento do sistema de controle de peças.
 // Use as instruções de cada nível para desenvolver o desafio.
+// As estruturas e a lógica de fila e pilha ficam no núcleo(tetris_nucleo.h), sem saída de console.
+// Aqui ficam as interfaces: o menu interativo(em texto corrido, ou em tela fixa com --tela)
+// e o modo tempo real(--tempo-real). As partidas podem ser gravadas(--gravar) e reproduzidas(--reproduzir),
+// e as ações podem ser registradas em um diário assíncrono(--diario), sem que o laço espere pelo disco.
+// Para revisão, a partida pode ser gravada com quadros-chave(--revisao), e qualquer ponto dela é restaurado
+// diretamente(--revisar), sem reaplicar a partida desde o início.
+// Bots podem jogar pelo servidor local(--servidor), sem a interface de texto, e agentes externos podem
+// observar as sessões pela região de memória compartilhada(--observacao).
 
 // **** Definições de constantes. ****
 
-/// @brief Tamanho reservado para o máximo de elementos na fila.
-#define TAM_MAX_FILA 5
-
-/// @brief Tamanho reservado para o máximo de elementos na pilha.
-#define TAM_MAX_PILHA 3
-
-// **** Declarações de estruturas. ****
-
-/// @brief Define uma struct chamada Peca(alias), com os campos: tipo (char) e id (int).
-typedef struct
-{
-	/// @brief Caractere que representa o tipo da peça('I', 'O', 'T', 'L').
-	char tipo;
-	/// @brief Número inteiro único que representa a ordem de criação da peça.
-	int id;
-} Peca;
-/// @brief Define uma struct com um alias Fila, para uma fila circular com capacidade de TAM_MAX_FILA.
-typedef struct {
-	Peca itens[TAM_MAX_FILA];
-	int inicio;
-	int fim;
-	int total;
-} Fila;
-/// @brief Define uma struct com um alias Pilha, para uma pilha com capacidade de TAM_MAX_PILHA.
-typedef struct {
-	Peca itens[TAM_MAX_PILHA];
-	int topo;
-} Pilha;
+/// @brief Taxa de quadros do modo tempo real(60 Hz).
+#define QUADROS_POR_SEGUNDO 60
+
+/// @brief Quantidade de linhas que a peça da frente da fila percorre até ser jogada automaticamente.
+#define ALTURA_QUEDA 20
+
+/// @brief Linhas do layout de tela fixa(a partir de 0), usadas pelo modo --tela e pelo modo tempo real.
+#define LINHA_TITULO 0
+#define LINHA_FILA 2
+#define LINHA_PILHA 3
+#define LINHA_PONTUACAO 4
+#define LINHA_QUEDA 5
+#define LINHA_MENSAGEM 7
+#define LINHA_MENU 15
+/// @brief Linha da entrada: acima da última linha do terminal(TELA_LINHAS), pois o Enter da digitação
+/// move o cursor para a linha seguinte. Na última linha, o terminal rolaria o quadro inteiro.
+#define LINHA_ENTRADA (TELA_LINHAS - 2)
+
+/// @brief Quantidade máxima de linhas da área de mensagens da tela fixa(comporta as estatísticas).
+#define TOTAL_LINHAS_MENSAGEM (TOTAL_METRICAS + 1)
+
+/// @brief Tamanho máximo de cada linha da área de mensagens da tela fixa.
+#define TAM_MAX_MENSAGEM 80
+
+// **** Variáveis internas. ****
+
+/// @brief Gravador da partida atual(opção --gravar). Estático, pelo tamanho dos buffers de bloco.
+static Gravador gravador;
+/// @brief Caminho do arquivo de gravação, ou NULL se a partida não estiver sendo gravada.
+static const char* arquivoGravacao = NULL;
+/// @brief Diário assíncrono das ações(opção --diario). Estático, compartilhado com a thread de escrita.
+static Diario diario;
+/// @brief Caminho do arquivo do diário, ou NULL se as ações não estiverem sendo registradas.
+static const char* arquivoDiario = NULL;
+/// @brief Indica se o diário foi aberto(somente nos modos interativos).
+static bool diarioAberto = false;
+/// @brief Gravador para revisão da partida atual(opção --revisao).
+static GravadorRevisao revisao;
+/// @brief Caminho do arquivo de revisão, ou NULL se a partida não estiver sendo gravada para revisão.
+static const char* arquivoRevisao = NULL;
+/// @brief Gerador de peças da sessão gravada para revisão(os quadros-chave contêm o seu estado),
+/// ou da sessão com pesos dos tipos(opção --pesos).
+static GeradorPecas geradorSessao;
+/// @brief Região de observação compartilhada(opção --observacao). Sem slots, se não for criada.
+static RegiaoObservacao observacao;
+/// @brief Exportação em colunas das ações da sessão, ou das conexões do servidor(opção --colunas).
+/// Estático, pelos buffers de bloco. Nas partidas versus, a exportação é local ao modo.
+static ExportadorColunas exportadorColunas;
+/// @brief Prefixo dos arquivos das colunas, ou NULL se as ações não estiverem sendo exportadas.
+static const char* prefixoColunas = NULL;
+/// @brief Indica se as colunas da sessão foram abertas(modos interativos e servidor).
+static bool colunasAbertas = false;
 
 // **** Declarações das funções. ****
 
@@ -55,138 +103,462 @@ void exibirMenuPrincipal(int* opcao);
 // **** Funções de Lógica Principal ****
 
 /// @brief Efetua procedimentos para a remoção e reposição de peças da fila.
-/// @param Fila. Ponteiro via referência, para aplicar a remoção.
-/// @param Inteiro. Ponteiro via referência, para atribuição e leitura
-/// de valores do contador sequencial único.
-void acaoJogarPeca(Fila* fila, int* sequencial);
+/// @param Sessao. Ponteiro via referência, para aplicar a remoção.
+/// @param RegistroAcao. Ponteiro via referência, para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao acaoJogarPeca(Sessao* sessao, RegistroAcao* registro);
 /// @brief Efetua procedimentos para a reserva de peças.
-/// @param Fila. Ponteiro via referência, para efetuar as ações de reserva.
-/// @param Pilha. Ponteiro via referência, para efetuar as ações de reserva.
-/// @param Inteiro. Ponteiro via referência, para atribuição e leitura
-/// de valores do contador sequencial único.
-/// @param trocou. Ponteiro via referência, para conter o valor da flag informativa de troca.
-void acaoReservarPeca(Fila* fila, Pilha* pilha, int* sequencial, bool* trocou);
+/// @param Sessao. Ponteiro via referência, para efetuar as ações de reserva.
+/// @param RegistroAcao. Ponteiro via referência, para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao acaoReservarPeca(Sessao* sessao, RegistroAcao* registro);
 /// @brief Efetua procedimentos para o uso de peças reservadas(da pilha).
-/// @param Pilha. Ponteiro via referência, para efetuar as ações de reserva.
-void acaoUsarPecaReservada(Pilha* pilha);
+/// @param Sessao. Ponteiro via referência, para efetuar as ações de reserva.
+/// @param RegistroAcao. Ponteiro via referência, para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao acaoUsarPecaReservada(Sessao* sessao, RegistroAcao* registro);
 /// @brief Efetua procedimentos para a troca de peças reservadas(da pilha).
-/// @param Fila. Ponteiro via referência, para efetuar as ações de troca.
-/// @param Pilha. Ponteiro via referência, para efetuar as ações de troca.
-void acaoTrocarPecaReservada(Fila* fila, Pilha* pilha);
+/// @param Sessao. Ponteiro via referência, para efetuar as ações de troca.
+/// @param RegistroAcao. Ponteiro via referência, para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao acaoTrocarPecaReservada(Sessao* sessao, RegistroAcao* registro);
 /// @brief Efetua procedimentos para a troca de grupos de peças reservadas(da pilha).
-/// @param Fila. Ponteiro via referência, para efetuar as ações de troca.
-/// @param Pilha. Ponteiro via referência, para efetuar as ações de troca.
-/// @param trocou. Ponteiro via referência, para conter o valor da flag informativa de troca.
-void acaoTrocarPecasReservadas(Fila* fila, Pilha* pilha, bool* trocou);
+/// @param Sessao. Ponteiro via referência, para efetuar as ações de troca.
+/// @param RegistroAcao. Ponteiro via referência, para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao acaoTrocarPecasReservadas(Sessao* sessao, RegistroAcao* registro);
 /// @brief Efetua a exibição do status para a troca de grupos de peças reservadas(da pilha).
 /// @param Peca. Estrutura usada nas ações de troca, antes posicionada à frente da fila.
 /// @param Peca. Estrutura usada nas ações de troca, antes posicionada no topo da pilha.
 void exibirStatusTrocaElemento(Peca frente, Peca topo);
 
-/// @brief Inicializa a fila. Baseado no conteúdo da plataforma.
-/// @param Fila. Ponteiro via referência, para efetuar a inicialização.
-void inicializarFila(Fila* fila);
-/// @brief Verifica se a fila está cheia. Baseado no conteúdo da plataforma.
-/// @param Fila. Ponteiro usado para efetuar a verificação. Somente leitura.
-/// @returns Verdadeiro(true) se a fila está cheia. Caso contrário, Falso(false). 
-bool filaCheia(const Fila* fila);
-/// @brief Verifica se a fila está vazia. Baseado no conteúdo da plataforma.
-/// @param Fila. Ponteiro usado para efetuar a verificação. Somente leitura.
-/// @returns Verdadeiro(true) se a fila está vazia. Caso contrário, Falso(false). 
-bool filaVazia(const Fila* fila);
-/// @brief Enfileira(ou sobrescreve) o elemento se houver alocações disponíveis na fila. Baseado no conteúdo da plataforma.
-/// @param Fila. Ponteiro via referência, usado no enfileiramento.
-/// @param Peca. Elemento a ser enfileirado.
-/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false). 
-bool enqueue(Fila* f, Peca p);
-/// @brief Marca para sobrescrever(desenfileirar) o primeiro elemento de acordo com a ordem atual da fila.
-/// Baseado no conteúdo da plataforma.
-/// @param Fila. Ponteiro via referência, usado no desenfileiramento.
-/// @returns Peca. Ponteiro a conter o elemento desenfileirado.
-Peca* dequeue(Fila* fila);
+/// @brief Exibe as estatísticas(contadores e latências) de cada ação, desde o início da sessão.
+void exibirEstatisticas();
+/// @brief Formata as estatísticas de cada ação em linhas de texto, uma por ação, mais o cabeçalho.
+/// @param Texto. Matriz a conter as linhas.
+/// @returns Inteiro. Quantidade de linhas preenchidas.
+int formatarEstatisticas(char linhas[TOTAL_LINHAS_MENSAGEM][TAM_MAX_MENSAGEM]);
+/// @brief Escreve as métricas consolidadas em formato JSON.
+/// @param Texto. Caminho do arquivo de destino, ou "-" para a saída padrão.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool exportarMetricas(const char* caminho);
+/// @brief Exporta, ao final da sessão, as métricas, o rastro, a gravação e as colunas, se solicitados na linha de comando.
+/// @param Sessao. Ponteiro da sessão encerrada, ou NULL(servidor: sem sessão principal). Somente leitura.
+/// @param Texto. Caminho do arquivo de métricas, ou NULL.
+/// @param Texto. Caminho do arquivo de rastro(Chrome trace-event), ou NULL.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool exportarResultados(const Sessao* sessao, const char* arquivoMetricas, const char* arquivoRastro);
+/// @brief Exibe a contagem de alocações, se habilitada na compilação(TETRIS_CONTAR_ALOCACOES).
+/// @returns Verdadeiro(true), se não houve alocações em regime permanente. Caso contrário, Falso(false).
+bool verificarAlocacoes();
+
+// **** Gravação, reprodução e observação ****
+
+/// @brief Registra um passo da sessão, após a ação ser aplicada: grava a ação, se a partida estiver
+/// sendo gravada, registra a ação no diário e nas colunas, se houver, e publica o novo estado, se houver
+/// região de observação. Somente as ações válidas(de 1 a 5).
+/// @param Sessao. Ponteiro da sessão, após a ação. Somente leitura.
+/// @param CodigoAcao. Ação aplicada.
+/// @param ResultadoAcao. Resultado da ação.
+/// @param RegistroAcao. Detalhes da ação(preenchidos somente com sucesso). Somente leitura.
+void registrarPasso(const Sessao* sessao, CodigoAcao acao, ResultadoAcao resultado, const RegistroAcao* registro);
+/// @brief Reproduz, na velocidade máxima, todas as partidas de um arquivo de gravação,
+/// conferindo os pontos de verificação. Ao final, exibe o resumo da reprodução.
+/// @param Texto. Caminho do arquivo de gravação.
+/// @param Sessao. Ponteiro via referência, a conter a última partida reproduzida.
+/// @returns Verdadeiro(true), se todas as verificações conferem. Caso contrário, Falso(false).
+bool reproduzirGravacao(const char* caminho, Sessao* sessao);
+/// @brief Exibe as observações atuais de todas as sessões publicadas em uma região de observação.
+/// @param Texto. Caminho do arquivo da região.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se a região não existir ou for inválida.
+bool exibirObservacoes(const char* caminho);
+/// @brief Restaura e exibe o estado de uma partida gravada para revisão, após uma quantidade de ações,
+/// e o tempo da busca(quadro-chave mais próximo e ações seguintes).
+/// @param Texto. Caminho do arquivo de revisão.
+/// @param Inteiro. Quantidade de ações aplicadas.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o arquivo for inválido ou a ação não existir.
+bool exibirRevisao(const char* caminho, uint64_t acao);
+
+// **** Servidor para bots ****
+
+/// @brief Executa o servidor local para bots até Ctrl+C(SIGINT) ou SIGTERM, e exibe o resumo ao encerrar.
+/// @param Texto. Caminho do socket Unix.
+/// @param Inteiro. Pesos dos tipos de peça das sessões(opção --pesos), ou NULL para as peças aleatórias.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool executarModoServidor(const char* caminho, const uint16_t* pesos);
+
+// **** Partidas versus ****
+
+/// @brief Executa partidas versus sem interface, entre a estratégia gulosa e a aleatória(alternando os lados),
+/// e exibe o resumo: vitórias, empates, passos médios e partidas por segundo.
+/// @param Inteiro. Quantidade de partidas.
+/// @param Texto. Prefixo dos arquivos da exportação em colunas das ações dos dois jogadores, ou NULL.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool executarModoVersus(int partidas, const char* prefixoColunas);
+
 /// @brief Mostra os elementos enfileirados de acordo com a ordem atual da fila.
 /// Baseado no conteúdo da plataforma.
 /// @param Fila. Ponteiro usado para efetuar a listagem. Somente leitura.
 void mostrarFila(const Fila* f);
-/// @brief Verifica e enfileira totalmente se necessário com novos elementos a fila em questão.
-/// @param Fila. Ponteiro via referência, a ser usado para efetuar o enfileiramento.
-/// @param Inteiro. Ponteiro via referência, para atribuição e leitura
-/// de valores do contador sequencial único.
-void popularFila(Fila* fila, int* sequencial);
-/// @brief Cria aleatoriamente um novo elemento do tipo Peca, para uso posterior.
-/// @param Inteiro. Ponteiro via referência, para atribuição e leitura
-/// de valores do contador sequencial único.
-/// @returns Peca. Conforme as especificações.
-Peca gerarPeca(int* sequencial);
-/// @brief Efetua a tentativa de criar automaticamente um novo elemento do tipo Peca na fila,
-/// além de efetuar controle e verificação de identificação única.
-/// @param Fila. Ponteiro via referência, usado no desenfileiramento.
-/// @param Inteiro. Ponteiro via referência, para atribuição e leitura
-/// de valores do contador sequencial único.
-/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
-bool autoGeracao(Fila* fila, int* sequencial);
-/// @brief Inicializa a pilha. Baseado no conteúdo da plataforma.
-/// @param Pilha. Ponteiro via referência, para efetuar a inicialização.
-void inicializarPilha(Pilha* p);
-/// @brief Insere(ou sobrescreve) o elemento se houver alocações disponíveis na pilha.
-/// Baseado no conteúdo da plataforma.
-/// @param Pilha. Ponteiro via referência, usado na inserção.
-/// @param Peca. Elemento a ser inserido.
-/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
-bool push(Pilha* pilha, Peca peca);
-/// @brief Marca para sobrescrever(remover) o primeiro elemento de acordo com a ordem atual da pilha.
-/// Baseado no conteúdo da plataforma.
-/// @param Pilha. Ponteiro via referência, usado na remoção.
-/// @returns Peca. Ponteiro a conter o elemento removido.
-Peca* pop(Pilha* p);
-/// @brief Recupera o primeiro elemento de acordo com a ordem atual da pilha, apenas para espiar.
-/// Baseado no conteúdo da plataforma.
-/// @param Pilha. Ponteiro usado na recuperação. Somente leitura.
-/// @returns Peca. Ponteiro a conter o elemento recuperado. Somente leitura.
-const Peca* peek(const Pilha* p);
-/// @brief Verifica se a pilha está cheia. Baseado no conteúdo da plataforma.
-/// @param Pilha. Ponteiro usado para efetuar a verificação. Somente leitura.
-/// @returns Verdadeiro(true) se a pilha está cheia. Caso contrário, Falso(false).
-bool pilhaCheia(const Pilha* p);
-/// @brief Verifica se a pilha está vazia. Baseado no conteúdo da plataforma.
-/// @param Pilha. Ponteiro usado para efetuar a verificação. Somente leitura.
-/// @returns Verdadeiro(true) se a pilha está vazia. Caso contrário, Falso(false). 
-bool pilhaVazia(const Pilha* p);
 /// @brief Mostra os elementos empilhados de acordo com a ordem atual da pilha.
 /// Baseado no conteúdo da plataforma.
 /// @param Pilha. Ponteiro usado para efetuar a listagem. Somente leitura.
 void mostrarPilha(const Pilha* p);
+/// @brief Mostra a pontuação atual da partida.
+/// @param Pontuacao. Ponteiro usado para efetuar a listagem. Somente leitura.
+void mostrarPontuacao(const Pontuacao* pontuacao);
+/// @brief Mostra os pontos ganhos por uma peça colocada, se houver.
+/// @param Inteiro. Pontos ganhos.
+void mostrarPontosGanhos(int32_t pontos);
+
+// **** Modo tela fixa ****
+
+/// @brief Executa o menu interativo em tela fixa: o estado, o menu e as mensagens ocupam posições
+/// fixas, e a cada ação somente as células alteradas são redesenhadas(sem rolagem do terminal).
+/// @param Sessao. Ponteiro via referência, da sessão a ser jogada.
+void executarModoTela(Sessao* sessao);
+/// @brief Monta no quadro o título e os estados atuais da fila e da pilha.
+/// @param Tela. Ponteiro via referência, usado na montagem.
+/// @param Sessao. Ponteiro usado na montagem. Somente leitura.
+/// @param Texto. Título exibido no topo da tela.
+void montarEstadoTela(Tela* tela, const Sessao* sessao, const char* titulo);
+/// @brief Descreve o resultado de uma ação em linhas de mensagem, para a tela fixa.
+/// @param Texto. Matriz a conter as linhas de mensagem.
+/// @param CodigoAcao. Ação efetuada.
+/// @param ResultadoAcao. Resultado da ação.
+/// @param RegistroAcao. Ponteiro com os detalhes da ação. Somente leitura.
+/// @returns Inteiro. Quantidade de linhas preenchidas.
+int descreverRegistro(char linhas[TOTAL_LINHAS_MENSAGEM][TAM_MAX_MENSAGEM], CodigoAcao acao,
+	ResultadoAcao resultado, const RegistroAcao* registro);
+
+// **** Modo tempo real ****
+
+/// @brief Executa o laço de jogo em tempo real: gravidade com período fixo e ações por tecla única,
+/// sem aguardar Enter. Ao final, exibe as latências entre a entrada e a mudança de estado.
+/// @param Sessao. Ponteiro via referência, da sessão a ser jogada.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o terminal não suportar o modo.
+bool executarModoTempoReal(Sessao* sessao);
+/// @brief Converte uma tecla no código da ação correspondente.
+/// @param Inteiro. Código da tecla lida.
+/// @returns CodigoAcao. A ação mapeada, ou ACAO_SAIR se a tecla não corresponder a nenhuma ação.
+CodigoAcao mapearTecla(int tecla);
+/// @brief Desenha o quadro atual do modo tempo real. Somente as células alteradas são enviadas.
+/// @param Tela. Ponteiro via referência, usado no desenho.
+/// @param Sessao. Ponteiro usado no desenho. Somente leitura.
+/// @param Inteiro. Linha atual da queda da peça da frente.
+/// @param ResultadoAcao. Resultado da última ação, para exibição.
+void desenharQuadroTempoReal(Tela* tela, const Sessao* sessao, int altura, ResultadoAcao ultimo);
+/// @brief Exibe o resumo das latências medidas no modo tempo real.
+/// @param AmostrasLatencia. Ponteiro usado no resumo. Somente leitura.
+/// @param Agendador. Ponteiro usado no resumo. Somente leitura.
+void exibirResumoLatencias(const AmostrasLatencia* latencias, const Agendador* agendador);
+
+// **** Partidas versus ****
+
+/// @brief Quantidade máxima de passos de cada partida versus(empate ao atingir).
+#define LIMITE_PASSOS_VERSUS 10000
+
+/// @brief Observador das partidas versus: exporta cada ação em colunas(contexto: ExportadorColunas).
+static void observarColunas(void* contexto, const Sessao* sessao, CodigoAcao acao, ResultadoAcao resultado,
+	const RegistroAcao* registro)
+{
+	registrarColunas((ExportadorColunas*)contexto, sessao, acao, resultado, registro);
+}
+
+bool executarModoVersus(int partidas, const char* prefixoColunas)
+{
+	uint64_t semente = (uint64_t)time(NULL);
+	int vitoriasGulosa = 0, vitoriasAleatoria = 0, empates = 0;
+	int64_t passos = 0, linhasEnviadas = 0;
+
+	ExportadorColunas colunas;
+	if (prefixoColunas != NULL && !abrirColunas(&colunas, prefixoColunas))
+	{
+		printf("\n==== ⚠️  Não foi possível criar as colunas em %s. ====\n", prefixoColunas);
+		return false;
+	}
+	iniciarRegimePermanente();
+
+	printf("\n==== Versus: estratégia gulosa contra aleatória, %d partidas(semente %" PRIu64 "). ====\n",
+		partidas, semente);
+	fflush(stdout);
+
+	int64_t inicioNs = relogioMonotonicoNs();
+	for (int p = 0; p < partidas; p++)
+	{
+		// A estratégia gulosa alterna de lado, pois o jogador 0 age primeiro em cada passo.
+		int lado = p & 1;
+		uint64_t sorteio = semente + (uint64_t)p * 0x9E3779B97F4A7C15ULL + 1;
+		Estrategia estrategias[2];
+		void* contextos[2];
+		estrategias[lado] = estrategiaGulosa;
+		contextos[lado] = NULL;
+		estrategias[1 - lado] = estrategiaAleatoria;
+		contextos[1 - lado] = &sorteio;
+
+		Versus versus;
+		inicializarVersus(&versus, semente + (uint64_t)p);
+		if (prefixoColunas != NULL)
+		{
+			versus.observador = observarColunas;
+			versus.contextoObservador = &colunas;
+		}
+		ResultadoVersus resultado = executarPartidaVersus(&versus, estrategias, contextos, LIMITE_PASSOS_VERSUS);
+
+		if (resultado.vencedor < 0)
+		{
+			empates++;
+		}
+		else if (resultado.vencedor == lado)
+		{
+			vitoriasGulosa++;
+		}
+		else
+		{
+			vitoriasAleatoria++;
+		}
+		passos += resultado.passos;
+		linhasEnviadas += resultado.linhasEnviadas[lado];
+	}
+	int64_t duracaoNs = relogioMonotonicoNs() - inicioNs;
+
+	printf("\n==== Resumo das partidas ====\n");
+	printf("Gulosa: %d vitórias. Aleatória: %d vitórias. Empates: %d.\n", vitoriasGulosa, vitoriasAleatoria, empates);
+	printf("Passos por partida: %.1f. Linhas de lixo enviadas pela gulosa por partida: %.1f.\n",
+		(double)passos / partidas, (double)linhasEnviadas / partidas);
+	printf("Duração: %.3f s(%.0f partidas por segundo).\n", duracaoNs / 1e9,
+		duracaoNs > 0 ? partidas * 1e9 / duracaoNs : 0.0);
+
+	if (prefixoColunas != NULL)
+	{
+		uint64_t linhas = colunas.totalLinhas;
+		if (!fecharColunas(&colunas))
+		{
+			printf("\n==== ⚠️  Não foi possível gravar as colunas em %s. ====\n", prefixoColunas);
+			return false;
+		}
+		printf("Colunas: %llu linhas(ações dos dois jogadores) em %s.*.\n", (unsigned long long)linhas, prefixoColunas);
+	}
+
+	return verificarAlocacoes();
+}
 
 // **** Funções utilitárias ****
 
-/// @brief Limpa o buffer de entrada do teclado (stdin), evitando problemas 
+/// @brief Limpa o buffer de entrada do teclado (stdin), evitando problemas
 /// com leituras consecutivas de scanf e getchar.
 void limparBufferEntrada();
 /// @brief Função para limpar '\n' deixado pelo fgets.
 /// @param str Conteúdo do texto a ser analisado e limpo.
 void limparEnter(char* str);
+/// @brief Lê os pesos dos tipos de peça, na ordem de TIPOS_PECA, separados por vírgula(opção --pesos).
+/// @param Texto. Pesos a serem lidos. Ex: "4,1,2,2"(I, O, T e L).
+/// @param Inteiro. Vetor de TOTAL_TIPOS_PECA, para conter os pesos.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o texto for inválido ou todos os pesos forem zero.
+bool lerPesos(const char* texto, uint16_t pesos[TOTAL_TIPOS_PECA]);
 
 /// @brief Ponto de entrada do programa.
-/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS. 
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: --tela, --tempo-real, --metricas ARQUIVO, --rastro ARQUIVO,
+/// --gravar ARQUIVO, --revisao ARQUIVO, --revisar ARQUIVO ACAO, --diario ARQUIVO, --fsync MS, --reproduzir ARQUIVO, --servidor SOCKET, --observacao ARQUIVO, --observar ARQUIVO, --versus PARTIDAS, --colunas PREFIXO, --pesos I,O,T,L.
+/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS.
 /// Ou diferente de Zero, em caso de falha. Ex: EXIT_FAILURE.
-int main() {
+int main(int argc, char* argv[]) {
 
 	// Configurações de caracteres para ajuste de ortografia para saída do console(UTF-8).
 #ifdef _WIN32
 	// Plataforma Windows.
 	SetConsoleOutputCP(CP_UTF8);
-#endif    
+#endif
+	reservarBuffersPadrao();
+
+	bool tempoReal = false, telaFixa = false;
+	const char* arquivoMetricas = NULL;
+	const char* arquivoRastro = NULL;
+	const char* arquivoReproducao = NULL;
+	const char* caminhoServidor = NULL;
+	const char* arquivoObservacao = NULL;
+	const char* arquivoObservado = NULL;
+	const char* arquivoRevisado = NULL;
+	uint64_t acaoRevisada = 0;
+	int partidasVersus = 0;
+	int intervaloFsyncMs = INTERVALO_PADRAO_FSYNC_MS;
+	uint16_t pesos[TOTAL_TIPOS_PECA];
+	bool ponderado = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--metricas") == 0 && i + 1 < argc)
+		{
+			arquivoMetricas = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--rastro") == 0 && i + 1 < argc)
+		{
+			arquivoRastro = argv[++i];
+			continue;
+		}
+		// A gravação não se aplica à reprodução nem ao servidor. As peças são reproduzidas pela semente(sem pesos).
+		if (strcmp(argv[i], "--gravar") == 0 && i + 1 < argc && arquivoReproducao == NULL && caminhoServidor == NULL
+			&& arquivoRevisao == NULL && !ponderado)
+		{
+			arquivoGravacao = argv[++i];
+			continue;
+		}
+		// A revisão usa o gerador de peças em lote, e não as peças aleatórias reproduzidas por --gravar.
+		if (strcmp(argv[i], "--revisao") == 0 && i + 1 < argc && arquivoReproducao == NULL && caminhoServidor == NULL
+			&& arquivoGravacao == NULL)
+		{
+			arquivoRevisao = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--revisar") == 0 && i + 2 < argc && strspn(argv[i + 2], "0123456789") == strlen(argv[i + 2]))
+		{
+			arquivoRevisado = argv[++i];
+			acaoRevisada = strtoull(argv[++i], NULL, 10);
+			continue;
+		}
+		if (strcmp(argv[i], "--diario") == 0 && i + 1 < argc)
+		{
+			arquivoDiario = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--fsync") == 0 && i + 1 < argc && atoi(argv[i + 1]) >= 0)
+		{
+			intervaloFsyncMs = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--reproduzir") == 0 && i + 1 < argc && arquivoGravacao == NULL && arquivoRevisao == NULL
+			&& !ponderado && prefixoColunas == NULL)
+		{
+			arquivoReproducao = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--servidor") == 0 && i + 1 < argc && arquivoGravacao == NULL && arquivoRevisao == NULL)
+		{
+			caminhoServidor = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--observacao") == 0 && i + 1 < argc)
+		{
+			arquivoObservacao = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--observar") == 0 && i + 1 < argc)
+		{
+			arquivoObservado = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--versus") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+		{
+			partidasVersus = atoi(argv[++i]);
+			continue;
+		}
+		// As colunas registram as ações aplicadas: na reprodução, já estão no arquivo reproduzido.
+		if (strcmp(argv[i], "--colunas") == 0 && i + 1 < argc && arquivoReproducao == NULL)
+		{
+			prefixoColunas = argv[++i];
+			continue;
+		}
+		// Os pesos exigem o gerador em lote: não se combinam com a gravação nem com a reprodução.
+		if (strcmp(argv[i], "--pesos") == 0 && i + 1 < argc && arquivoGravacao == NULL && arquivoReproducao == NULL
+			&& lerPesos(argv[i + 1], pesos))
+		{
+			ponderado = true;
+			i++;
+			continue;
+		}
+		if (strcmp(argv[i], "--tempo-real") == 0)
+		{
+			tempoReal = true;
+			continue;
+		}
+		if (strcmp(argv[i], "--tela") == 0)
+		{
+			telaFixa = true;
+			continue;
+		}
+		printf("Uso: %s [--tela | --tempo-real] [--metricas ARQUIVO] [--rastro ARQUIVO] [--gravar ARQUIVO | --revisao ARQUIVO | --reproduzir ARQUIVO] [--revisar ARQUIVO ACAO] [--diario ARQUIVO] [--fsync MS] [--servidor SOCKET] [--observacao ARQUIVO] [--observar ARQUIVO] [--versus PARTIDAS] [--colunas PREFIXO] [--pesos I,O,T,L]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
 
-	// Inicializa o gerador de números aleatórios.
-	srand((unsigned int)time(NULL));
+	if (arquivoObservado != NULL)
+	{
+		return exibirObservacoes(arquivoObservado) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (arquivoRevisado != NULL)
+	{
+		return exibirRevisao(arquivoRevisado, acaoRevisada) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (partidasVersus > 0)
+	{
+		return executarModoVersus(partidasVersus, prefixoColunas) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	Sessao sessao;
+	ativarRastro(arquivoRastro != NULL);
+
+	// No servidor, um slot por conexão. Nos demais modos, somente a sessão principal.
+	if (arquivoObservacao != NULL && !criarRegiaoObservacao(&observacao, arquivoObservacao,
+		caminhoServidor != NULL ? TAM_MAX_CONEXOES : 1))
+	{
+		printf("\n==== ⚠️  Não foi possível criar a região de observação em %s. ====\n", arquivoObservacao);
+		return EXIT_FAILURE;
+	}
+
+	if (prefixoColunas != NULL)
+	{
+		colunasAbertas = abrirColunas(&exportadorColunas, prefixoColunas);
+		if (!colunasAbertas)
+		{
+			printf("\n==== ⚠️  Não foi possível criar as colunas em %s. ====\n", prefixoColunas);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (caminhoServidor != NULL)
+	{
+		ativarMetricas(arquivoMetricas != NULL);
+		iniciarRegimePermanente();
+		bool sucesso = executarModoServidor(caminhoServidor, ponderado ? pesos : NULL);
+		return (sucesso && exportarResultados(NULL, arquivoMetricas, arquivoRastro)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (arquivoReproducao != NULL)
+	{
+		// Na reprodução, a coleta de métricas só é habilitada se forem exportadas.
+		ativarMetricas(arquivoMetricas != NULL);
+		bool sucesso = reproduzirGravacao(arquivoReproducao, &sessao);
+		return (sucesso && exportarResultados(&sessao, arquivoMetricas, arquivoRastro)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// Inicializa o gerador de números aleatórios. A semente é gravada, para a reprodução da partida.
+	unsigned int semente = (unsigned int)time(NULL);
+	srand(semente);
+
+	if (arquivoGravacao != NULL && !abrirGravacao(&gravador, arquivoGravacao))
+	{
+		printf("\n==== ⚠️  Não foi possível criar a gravação em %s. ====\n", arquivoGravacao);
+		return EXIT_FAILURE;
+	}
+
+	// O diário só se aplica aos modos interativos.
+	if (arquivoDiario != NULL)
+	{
+		diarioAberto = abrirDiario(&diario, arquivoDiario, CAPACIDADE_PADRAO_DIARIO, intervaloFsyncMs);
+		if (!diarioAberto)
+		{
+			printf("\n==== ⚠️  Não foi possível criar o diário em %s. ====\n", arquivoDiario);
+			return EXIT_FAILURE;
+		}
+	}
 
 	printf("======================================================\n");
 	printf("======== 🧱  TETRIS STACK - Nível Mestre  🧱 ========\n");
 	printf("======================================================\n");
 
-	// Poderíamos também usar um contador estático, para os valores únicos. 
-	// Mas vamos manter de acordo com escopo do tempo de vida do método main.
-	int opcao = 0, sequencial = 0;
+	int opcao = 0;
 
 	// Ao menos no comportamento apresentado na vídeo aula da plataforma, parece que ao
 	// efetuar a troca pela SEGUNDA vez, a ordenação descendente inicial feita pela pilha
@@ -194,46 +566,94 @@ int main() {
 	// Dessa forma, o comportamento de inversão pela pilha é efetuado efetivamente sempre
 	// que NOVAS peças FOREM RESERVADAS. Desta forma, os grupos invertidos respeitarão a ordem inicial
 	// de peças inseridas na pilha, pois o objetivo seria a fila usar essa habilidade de inversão da pilha.
-	// Nesse caso, vamos usar uma flag, informando o estado da inversão já efetuada.
-	bool trocou = false;
+	// Nesse caso, a sessão mantém uma flag(trocou), informando o estado da inversão já efetuada.
+	// Poderíamos também usar um contador estático, para os valores únicos.
+	// Mas vamos manter de acordo com escopo do tempo de vida do método main, dentro da sessão.
+	ativarMetricas(true);
+	if (arquivoRevisao != NULL || ponderado)
+	{
+		// Na revisão e com pesos, as peças vêm do gerador em lote: na revisão, o seu estado(inclusive os pesos)
+		// é gravado em cada quadro-chave.
+		inicializarGerador(&geradorSessao, semente);
+		definirPesosGerador(&geradorSessao, ponderado ? pesos : NULL);
+		inicializarSessaoComGerador(&sessao, &geradorSessao);
+		if (arquivoRevisao != NULL && !abrirRevisao(&revisao, arquivoRevisao, &sessao, INTERVALO_PADRAO_QUADROS))
+		{
+			printf("\n==== ⚠️  Não foi possível criar a gravação para revisão em %s. ====\n", arquivoRevisao);
+			return EXIT_FAILURE;
+		}
+	}
+	else
+	{
+		inicializarSessao(&sessao);
+	}
+	if (arquivoGravacao != NULL)
+	{
+		gravarNovaPartida(&gravador, semente);
+	}
+	if (diarioAberto)
+	{
+		// Fotografia do estado inicial.
+		registrarAcaoDiario(&diario, &sessao, ACAO_SAIR);
+	}
+	publicarObservacao(&observacao, 0, &sessao, ACAO_SAIR);
+	// Fim da inicialização: a partir daqui, nenhuma ação deve alocar memória.
+	iniciarRegimePermanente();
+
+	if (tempoReal)
+	{
+		bool sucesso = executarModoTempoReal(&sessao);
+		return (sucesso && exportarResultados(&sessao, arquivoMetricas, arquivoRastro)) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (telaFixa)
+	{
+		executarModoTela(&sessao);
+		return exportarResultados(&sessao, arquivoMetricas, arquivoRastro) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
 
-	Fila fila;
-	inicializarFila(&fila);
-	popularFila(&fila, &sequencial);
-	// Pilha reserva.
-	Pilha pilha;
-	inicializarPilha(&pilha);
+	for (int i = 0; i < sessao.fila.total; i++)
+	{
+		printf("\n  ✅  Nova Peça Id %" PRId64 " inserida na fila.\n", sessao.fila.itens[i].id);
+	}
 
 	do
 	{
 		// Após cada ação, devemos mostrar os estados atuais da fila e da pilha(reserva).
 		// Então vamos efetuar a exibição por padrão.
-		mostrarFila(&fila);
-		mostrarPilha(&pilha);
+		mostrarFila(&sessao.fila);
+		mostrarPilha(&sessao.pilha);
+		mostrarPontuacao(&sessao.pontuacao);
 
 		exibirMenuPrincipal(&opcao);
 
+		RegistroAcao registro;
+		ResultadoAcao resultado = RESULTADO_ACAO_INVALIDA;
+		iniciarRastro("despacho");
 		switch (opcao)
 		{
 		case 1:
 			// Jogar Peça.
-			acaoJogarPeca(&fila, &sequencial);
+			resultado = acaoJogarPeca(&sessao, &registro);
 			break;
 		case 2:
 			// Reservar Peça.
-			acaoReservarPeca(&fila, &pilha, &sequencial, &trocou);
+			resultado = acaoReservarPeca(&sessao, &registro);
 			break;
 		case 3:
 			// Usar Peça Reservada.
-			acaoUsarPecaReservada(&pilha);
+			resultado = acaoUsarPecaReservada(&sessao, &registro);
 			break;
 		case 4:
 			// Trocar Peça Reservada.
-			acaoTrocarPecaReservada(&fila, &pilha);
+			resultado = acaoTrocarPecaReservada(&sessao, &registro);
 			break;
 		case 5:
 			// Trocar Peças Reservadas.
-			acaoTrocarPecasReservadas(&fila, &pilha, &trocou);
+			resultado = acaoTrocarPecasReservadas(&sessao, &registro);
+			break;
+		case 6:
+			// Estatísticas.
+			exibirEstatisticas();
 			break;
 		case 0:
 			//  0  Sair.
@@ -244,12 +664,14 @@ int main() {
 			printf("\n==== ⚠️  Opção inválida. ====\n");
 			break;
 		}
+		registrarPasso(&sessao, (CodigoAcao)opcao, resultado, &registro);
+		finalizarRastro("despacho");
 
 	} while (opcao != 0);
 
 	printf("\n==== Operação encerrada. ====\n");
 
-	return EXIT_SUCCESS;
+	return exportarResultados(&sessao, arquivoMetricas, arquivoRastro) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 // **** Implementações das funções. ****
@@ -263,10 +685,12 @@ void exibirMenuPrincipal(int* opcao)
 	printf("3 - Usar Peça Reservada.\n");
 	printf("4 - Trocar peça da frente da fila com o topo da pilha.\n");
 	printf("5 - Trocar os 3 primeiros da fila com as 3 peças da pilha.\n");
+	printf("6 - Estatísticas.\n");
 	printf("0 - Sair.\n");
 
 	int invalido;
 
+	iniciarRastro("leituraMenu");
 	do
 	{
 		printf("Escolha uma opção: ");
@@ -277,332 +701,790 @@ void exibirMenuPrincipal(int* opcao)
 			printf("\n==== ⚠️  Entrada inválida. Tente novamente. ====\n");
 		}
 	} while (invalido);
+	finalizarRastro("leituraMenu");
 }
 
 // **** Funções de Lógica Principal ****
 
-void acaoJogarPeca(Fila* fila, int* sequencial)
+ResultadoAcao acaoJogarPeca(Sessao* sessao, RegistroAcao* registro)
 {
-	Peca* peca = dequeue(fila);
-
-	if (peca == NULL)
+	ResultadoAcao resultado = jogarPeca(sessao, registro);
+	if (resultado != RESULTADO_SUCESSO)
 	{
+		printf("\n ⚠️  Fila vazia. Não é possível remover.\n");
 		printf("\n  ℹ️  A ação de jogar peça foi abortada.\n");
-		return;
+		return resultado;
 	}
 
-	printf("\n  ✅  Peça Id %d removida da fila.\n", peca->id);
+	printf("\n  ✅  Peça Id %" PRId64 " removida da fila.\n", registro->removida.id);
+	mostrarPontosGanhos(registro->pontos);
 
 	// Ao desinfileirarmos um elemento, outro deverá ser enfileirado automaticamente.
-	if (autoGeracao(fila, sequencial))
+	if (registro->reposta)
 	{
+		printf("\n  ✅  Nova Peça Id %" PRId64 " inserida na fila.\n", registro->gerada.id);
 		printf("\n  ℹ️  A ação de jogar peça foi efetuada com êxito.\n");
 		printf("\n  ℹ️  Reposição de elemento da fila efetuada com êxito.\n");
-		return;
+		return resultado;
 	}
 
 	printf("\n  ℹ️  A reposição de elemento da fila foi abortada.\n");
+	return resultado;
 }
 
-void acaoReservarPeca(Fila* fila, Pilha* pilha, int* sequencial, bool* trocou)
+ResultadoAcao acaoReservarPeca(Sessao* sessao, RegistroAcao* registro)
 {
-	if (filaVazia(fila) || pilhaCheia(pilha))
+	ResultadoAcao resultado = reservarPeca(sessao, registro);
+	if (resultado != RESULTADO_SUCESSO)
 	{
 		printf("\n  ⚠️  Nenhuma peça disponível para reservar na fila, ou a pilha está cheia.\n");
 		printf("\n  ℹ️  A ação de reserva de peça da pilha foi abortada.\n");
-		return;
+		return resultado;
 	}
 
-	Peca* peca = dequeue(fila);
-	// Não precisaríamos reter o ponteiro para a peça em si, nesse cenário. 
-	// Somente uma cópia segura dos valores.
-	Peca removida = *peca;
-
-	if (push(pilha, removida) && autoGeracao(fila, sequencial))
+	if (registro->reposta)
 	{
-		printf("\n  ✅  Peça Id %d reservada na pilha.\n", removida.id);
+		printf("\n  ✅  Nova Peça Id %" PRId64 " inserida na fila.\n", registro->gerada.id);
+		printf("\n  ✅  Peça Id %" PRId64 " reservada na pilha.\n", registro->removida.id);
 		printf("\n  ℹ️  Reposição de elemento da fila efetuada com êxito.\n");
-		// Vamos atualizar o valor da flag para trocas futuras de grupos de peças, informando que a
-		// uma ordenação(inversão) precisará ser feita, para a um novo grupo de peças recém reservadas.
-		*trocou = false;
-		return;
+		return resultado;
 	}
 
-	printf("\n  ℹ️  A ação de reserva de peça da pilha foi abortada.\n");
+	printf("\n  ✅  Peça Id %" PRId64 " reservada na pilha.\n", registro->removida.id);
 	printf("\n  ℹ️  A reposição de elemento da fila foi abortada.\n");
+	return resultado;
 }
 
-void acaoUsarPecaReservada(Pilha* pilha)
+ResultadoAcao acaoUsarPecaReservada(Sessao* sessao, RegistroAcao* registro)
 {
-	Peca* peca = pop(pilha);
-
-	if (peca != NULL)
+	ResultadoAcao resultado = usarPecaReservada(sessao, registro);
+	if (resultado == RESULTADO_SUCESSO)
 	{
-		printf("\n  ✅  Peça Id %d removida da pilha.\n", peca->id);
+		printf("\n  ✅  Peça Id %" PRId64 " removida da pilha.\n", registro->removida.id);
+		mostrarPontosGanhos(registro->pontos);
 		printf("\n  ℹ️  A ação de usar peça reservada da pilha foi efetuada com êxito.\n");
-		return;
+		return resultado;
 	}
 
+	printf("\n ⚠️  Pilha vazia. Não é possível remover.\n");
 	printf("\n  ℹ️  A ação de usar peça reservada da pilha foi abortada.\n");
+	return resultado;
 }
 
-void acaoTrocarPecaReservada(Fila* fila, Pilha* pilha)
+ResultadoAcao acaoTrocarPecaReservada(Sessao* sessao, RegistroAcao* registro)
 {
 	// Precisamos garantir ao menos 1 elemento existente em ambos os lados,
 	// tanto da fila quanto da pilha, para efetuarmos a troca.
-	if (filaVazia(fila) || pilhaVazia(pilha))
+	ResultadoAcao resultado = trocarPecaReservada(sessao, registro);
+	if (resultado != RESULTADO_SUCESSO)
 	{
 		printf("\n  ⚠️  A pilha ou a fila não possuem peças disponíveis para trocar.\n");
 		printf("\n  ℹ️  A ação de trocar %d peça(s) reservada(s) do topo da pilha com %d da frente da fila, foi abortada.\n", 1, 1);
-		return;
+		return resultado;
 	}
 
-	// Troca simplificada peça da frente(início) da fila com o topo da pilha. Vamos incluir um log das trocas.
-	Peca frenteLog = fila->itens[fila->inicio];
-	Peca topoLog = pilha->itens[pilha->topo];
-	fila->itens[fila->inicio] = topoLog;
-	pilha->itens[pilha->topo] = frenteLog;
-
-	exibirStatusTrocaElemento(frenteLog, topoLog);
+	// Vamos incluir um log das trocas.
+	exibirStatusTrocaElemento(registro->paraPilha[0], registro->paraFila[0]);
 
 	printf("\n  ℹ️  A ação de trocar %d peça(s) reservada(s) do topo da pilha com %d da frente da fila, foi bem sucedida.\n", 1, 1);
+	return resultado;
 }
 
-void acaoTrocarPecasReservadas(Fila* fila, Pilha* pilha, bool* trocou)
+ResultadoAcao acaoTrocarPecasReservadas(Sessao* sessao, RegistroAcao* registro)
 {
 	// Precisamos garantir os 3 elementos existentes em ambos os lados,
 	// tanto da fila quanto da pilha, para efetuarmos a troca.
-	if (!(pilhaCheia(pilha) && fila->total >= TAM_MAX_PILHA))
+	ResultadoAcao resultado = trocarPecasReservadas(sessao, registro);
+	if (resultado != RESULTADO_SUCESSO)
 	{
 		printf("\n  ⚠️  A pilha ou a fila ainda não possuem peças disponíveis para as trocas(%d por %d).\n", 3, 3);
 		printf("\n  ℹ️  A ação de trocar %d peça(s) reservada(s) do topo da pilha com %d da frente da fila, foi abortada.\n", 3, 3);
-		return;
+		return resultado;
 	}
 
-	Peca tmpFila[3], tmpPilha[3]; // Cache para a troca.
-
-	// Recuperando em cache temporário os elementos da fila, respeitando a ordem circular.
-	for (int i = 0, idx = fila->inicio; i <= pilha->topo; i++, idx = (idx + 1) % TAM_MAX_FILA)
-	{
-		tmpFila[i] = fila->itens[idx];
-	}
-	// Recuperando em cache temporário os elementos da pilha, respeitando a ordenação invertida.
-	for (int x = pilha->topo; x >= 0; x--)
+	for (int i = 0; i < registro->totalTrocas; i++)
 	{
-		tmpPilha[x] = pilha->itens[x];
-	}
-	// Efetuando as trocas, respeitando tanto a ordem circular da fila, quanto a ordem invertida da pilha,
-	// usando o cache previamente criado.
-	for (int i = 0, idx = fila->inicio; i <= pilha->topo; i++, idx = (idx + 1) % TAM_MAX_FILA)
-	{		
-		fila->itens[idx] = tmpPilha[pilha->topo - i];
-		Peca logPilha = pilha->itens[i]; // Vamos guardar o valor anterior à troca, para o log.
-		// Se a inversão já houver sido efetivada anteriormente, para os grupos atuais,
-		// iremos apenas restaurar a sua ordem original.
-		if (*trocou)
-		{			
-			pilha->itens[i] = tmpFila[pilha->topo - i];
-			exibirStatusTrocaElemento(tmpFila[pilha->topo - i], logPilha);
-			continue;
-		}
-		// Se alcançarmos este ponto, significa que novas peças foram reservadas.
-		// Portanto, um novo grupo de elementos está efetivando uma nova troca.		
-		pilha->itens[i] = tmpFila[i];
-		exibirStatusTrocaElemento(tmpFila[i], logPilha);
+		exibirStatusTrocaElemento(registro->paraPilha[i], registro->paraFila[i]);
 	}
 
-	*trocou = true; // Atualizando o valor da flag para informar que a troca foi efetivada.
-
 	printf("\n  ℹ️  A ação de trocar %d peça(s) reservada(s) do topo da pilha com %d da frente da fila, foi bem sucedida.\n", 3, 3);
+	return resultado;
 }
 
 void exibirStatusTrocaElemento(Peca frente, Peca topo)
 {
-	printf("\n  ✅  Peça Id %d movida da fila para a pilha.\n", frente.id);
-	printf("\n  ✅  Peça Id %d movida da pilha para a fila.\n", topo.id);
+	printf("\n  ✅  Peça Id %" PRId64 " movida da fila para a pilha.\n", frente.id);
+	printf("\n  ✅  Peça Id %" PRId64 " movida da pilha para a fila.\n", topo.id);
 }
 
-void inicializarFila(Fila* f)
+void exibirEstatisticas()
 {
-	f->inicio = 0;
-	f->fim = 0;
-	f->total = 0;
-}
+	char linhas[TOTAL_LINHAS_MENSAGEM][TAM_MAX_MENSAGEM];
+	int total = formatarEstatisticas(linhas);
 
-bool filaCheia(const Fila* fila)
-{
-	return fila->total == TAM_MAX_FILA;
+	printf("\n==== Estatísticas das Ações ====\n");
+	printf("\n");
+	for (int i = 0; i < total; i++)
+	{
+		printf("%s\n", linhas[i]);
+	}
 }
 
-bool filaVazia(const Fila* fila)
+int formatarEstatisticas(char linhas[TOTAL_LINHAS_MENSAGEM][TAM_MAX_MENSAGEM])
 {
-	return fila->total == 0;
+	static Metricas metricas; // Estática, pelo tamanho dos histogramas.
+	consolidarMetricas(&metricas);
+
+	snprintf(linhas[0], TAM_MAX_MENSAGEM, "%-27s %6s %7s %6s %9s %9s", "Ação", "Total", "Êxito", "Abort.", "p50(ns)", "p99(ns)");
+	for (int a = 0; a < TOTAL_METRICAS; a++)
+	{
+		const MetricaAcao* m = &metricas.acoes[a];
+		snprintf(linhas[a + 1], TAM_MAX_MENSAGEM, "%-25s %6llu %6llu %6llu %9llu %9llu",
+			nomeMetrica((CodigoMetrica)a),
+			(unsigned long long)m->chamadas, (unsigned long long)m->sucessos,
+			(unsigned long long)(m->chamadas - m->sucessos),
+			(unsigned long long)percentilMetrica(m, 50.0), (unsigned long long)percentilMetrica(m, 99.0));
+	}
+
+	return TOTAL_METRICAS + 1;
 }
 
-bool enqueue(Fila* fila, Peca peca)
+bool exportarMetricas(const char* caminho)
 {
-	if (filaCheia(fila))
+	if (caminho == NULL)
 	{
-		printf("\n ⚠️  Fila cheia. Não é possível inserir.\n");
-		return false;
+		return true;
 	}
 
-	fila->itens[fila->fim] = peca;
-	fila->fim = (fila->fim + 1) % TAM_MAX_FILA;
-	fila->total++;
+	static Metricas metricas; // Estática, pelo tamanho dos histogramas.
+	consolidarMetricas(&metricas);
+
+	if (strcmp(caminho, "-") == 0)
+	{
+		escreverMetricasJson(stdout, &metricas);
+		return true;
+	}
+
+	FILE* arquivo = fopen(caminho, "w");
+	if (arquivo == NULL)
+	{
+		printf("\n==== ⚠️  Não foi possível gravar as métricas em %s. ====\n", caminho);
+		return false;
+	}
+	escreverMetricasJson(arquivo, &metricas);
+	fclose(arquivo);
 
 	return true;
 }
 
-Peca* dequeue(Fila* fila)
+bool exportarResultados(const Sessao* sessao, const char* arquivoMetricas, const char* arquivoRastro)
 {
-	if (filaVazia(fila))
+	bool sucesso = exportarMetricas(arquivoMetricas);
+
+	if (arquivoGravacao != NULL && sessao != NULL)
 	{
-		printf("\n ⚠️  Fila vazia. Não é possível remover.\n");
-		return NULL;
+		// O ponto de verificação final permite conferir a reprodução.
+		gravarVerificacao(&gravador, sessao->ids.emitidos);
+		if (!fecharGravacao(&gravador))
+		{
+			printf("\n==== ⚠️  Não foi possível gravar a partida em %s. ====\n", arquivoGravacao);
+			sucesso = false;
+		}
 	}
 
-	Peca* peca = &fila->itens[fila->inicio];
-	fila->inicio = (fila->inicio + 1) % TAM_MAX_FILA;
-	fila->total--;
+	if (arquivoRevisao != NULL && !fecharRevisao(&revisao))
+	{
+		printf("\n==== ⚠️  Não foi possível gravar a partida para revisão em %s. ====\n", arquivoRevisao);
+		sucesso = false;
+	}
 
-	return peca;
+	if (diarioAberto)
+	{
+		// A pressão de retorno é informada: os registros recusados com o anel cheio não estão no diário.
+		bool escrito = fecharDiario(&diario);
+		diarioAberto = false;
+		printf("\nDiário: %llu registros, %llu recusados(anel cheio), %llu escritas, %llu sincronizações.\n",
+			(unsigned long long)diario.registros, (unsigned long long)diario.recusados,
+			(unsigned long long)diario.escritas, (unsigned long long)diario.sincronizacoes);
+		if (!escrito || diario.recusados > 0)
+		{
+			printf("\n==== ⚠️  O diário em %s está incompleto. ====\n", arquivoDiario);
+			sucesso = false;
+		}
+	}
+
+	if (colunasAbertas)
+	{
+		uint64_t linhas = exportadorColunas.totalLinhas;
+		colunasAbertas = false;
+		if (!fecharColunas(&exportadorColunas))
+		{
+			printf("\n==== ⚠️  Não foi possível gravar as colunas em %s. ====\n", prefixoColunas);
+			sucesso = false;
+		}
+		else
+		{
+			printf("\nColunas: %llu linhas em %s.*.\n", (unsigned long long)linhas, prefixoColunas);
+		}
+	}
+
+	if (arquivoRastro != NULL && !exportarRastroJson(arquivoRastro))
+	{
+		printf("\n==== ⚠️  Não foi possível gravar o rastro em %s. ====\n", arquivoRastro);
+		sucesso = false;
+	}
+
+	return verificarAlocacoes() && sucesso;
+}
+
+bool verificarAlocacoes()
+{
+	if (!contagemAlocacoesAtiva())
+	{
+		return true;
+	}
+
+	uint64_t permanentes = alocacoesRegimePermanente();
+	printf("\nAlocações: %llu no total, %llu em regime permanente.\n",
+		(unsigned long long)totalAlocacoes(), (unsigned long long)permanentes);
+	if (permanentes > 0)
+	{
+		printf("\n==== ⚠️  Houve alocações de memória após a inicialização. ====\n");
+		return false;
+	}
+	return true;
 }
 
 void mostrarFila(const Fila* f)
 {
+	iniciarRastro("mostrarFila");
 	printf("\n==== Estado Atual da Fila[Tipo, Id] ====\n");
 	printf("\n");
-	for (int i = 0, idx = f->inicio; i < f->total; i++, idx = (idx + 1) % TAM_MAX_FILA)
+	for (int i = 0, idx = f->inicio; i < f->total; i++, idx = avancarFila(idx))
+	{
+		printf("[%c, %" PRId64 "] ", f->itens[idx].tipo, f->itens[idx].id);
+	}
+	printf("\n");
+	finalizarRastro("mostrarFila");
+}
+
+void mostrarPilha(const Pilha* pilha)
+{
+	iniciarRastro("mostrarPilha");
+	printf("\n==== Estado Atual da Pilha[Tipo, Id] ====\n");
+	printf("\n");
+	printf("Pilha (topo -> base):\n");
+	for (int i = pilha->topo; i >= 0; i--)
 	{
-		printf("[%c, %d] ", f->itens[idx].tipo, f->itens[idx].id);
+		printf("[%c, %" PRId64 "] ", pilha->itens[i].tipo, pilha->itens[i].id);
 	}
 	printf("\n");
+	finalizarRastro("mostrarPilha");
+}
+
+void mostrarPontuacao(const Pontuacao* pontuacao)
+{
+	printf("\n==== Pontuação ====\n");
+	printf("\nPontos: %" PRId64 " | Linhas: %d | Nível: %d | Combo: %d\n",
+		pontuacao->pontos, (int)pontuacao->linhas, (int)pontuacao->nivel, pontuacao->combo + 1);
 }
 
-void popularFila(Fila* fila, int* sequencial)
+void mostrarPontosGanhos(int32_t pontos)
 {
-	// Enquanto temos alocações disponíveis, continuamos enfileirando elementos.	
-	while (fila->total < TAM_MAX_FILA)
+	if (pontos > 0)
 	{
-		if (!autoGeracao(fila, sequencial))
+		printf("\n  🏅  +%d pontos.\n", (int)pontos);
+	}
+}
+
+// **** Modo tela fixa ****
+
+void executarModoTela(Sessao* sessao)
+{
+	// Estática, pelo tamanho dos quadros e do buffer de saída.
+	static Tela tela;
+	inicializarTela(&tela);
+
+	char mensagens[TOTAL_LINHAS_MENSAGEM][TAM_MAX_MENSAGEM];
+	int totalMensagens = 0, opcao = -1;
+	char entrada[64];
+
+	do
+	{
+		limparQuadro(&tela);
+		montarEstadoTela(&tela, sessao, "======== TETRIS STACK - Nível Mestre ========");
+
+		for (int i = 0; i < totalMensagens; i++)
+		{
+			escreverTela(&tela, LINHA_MENSAGEM + i, 0, mensagens[i]);
+		}
+
+		escreverTela(&tela, LINHA_MENU, 0, "1 - Jogar Peça.");
+		escreverTela(&tela, LINHA_MENU + 1, 0, "2 - Reservar Peça.");
+		escreverTela(&tela, LINHA_MENU + 2, 0, "3 - Usar Peça Reservada.");
+		escreverTela(&tela, LINHA_MENU + 3, 0, "4 - Trocar peça da frente da fila com o topo da pilha.");
+		escreverTela(&tela, LINHA_MENU + 4, 0, "5 - Trocar os 3 primeiros da fila com as 3 peças da pilha.");
+		escreverTela(&tela, LINHA_MENU + 5, 0, "6 - Estatísticas.");
+		escreverTela(&tela, LINHA_MENU + 6, 0, "0 - Sair.");
+		int coluna = escreverTela(&tela, LINHA_ENTRADA, 0, "Escolha uma opção: ");
+		posicionarCursorTela(&tela, LINHA_ENTRADA, coluna);
+
+		apresentarTela(&tela);
+
+		// Fim da entrada: encerramos como se a opção de sair fosse escolhida.
+		iniciarRastro("leituraMenu");
+		bool lida = fgets(entrada, sizeof(entrada), stdin) != NULL;
+		finalizarRastro("leituraMenu");
+		if (!lida)
+		{
+			break;
+		}
+		limparEnter(entrada);
+		// O eco da digitação alterou a linha de entrada(e a seguinte, se a digitação a ultrapassou),
+		// sem o conhecimento do renderizador.
+		invalidarLinhaTela(&tela, LINHA_ENTRADA);
+		invalidarLinhaTela(&tela, LINHA_ENTRADA + 1);
+
+		if (sscanf(entrada, "%d", &opcao) != 1)
+		{
+			opcao = -1;
+			totalMensagens = 1;
+			snprintf(mensagens[0], TAM_MAX_MENSAGEM, "Entrada inválida. Tente novamente.");
+			continue;
+		}
+
+		if (opcao == 0)
 		{
-			printf(" ⚠️  Falha ao popular a fila. Operação abortada.");
 			break;
 		}
+		if (opcao == 6)
+		{
+			totalMensagens = formatarEstatisticas(mensagens);
+			continue;
+		}
+
+		RegistroAcao registro;
+		iniciarRastro("despacho");
+		ResultadoAcao resultado = aplicarAcao(sessao, (CodigoAcao)opcao, &registro);
+		finalizarRastro("despacho");
+		registrarPasso(sessao, (CodigoAcao)opcao, resultado, &registro);
+		totalMensagens = descreverRegistro(mensagens, (CodigoAcao)opcao, resultado, &registro);
+
+	} while (opcao != 0);
+
+	printf("\x1b[%d;1H\n==== Operação encerrada. ====\n", LINHA_ENTRADA + 1);
+}
+
+void montarEstadoTela(Tela* tela, const Sessao* sessao, const char* titulo)
+{
+	const Fila* f = &sessao->fila;
+	const Pilha* p = &sessao->pilha;
+
+	escreverTela(tela, LINHA_TITULO, 0, titulo);
+
+	int coluna = escreverTela(tela, LINHA_FILA, 0, "Fila[Tipo, Id]: ");
+	for (int i = 0, idx = f->inicio; i < f->total; i++, idx = avancarFila(idx))
+	{
+		coluna = escreverTelaFormatado(tela, LINHA_FILA, coluna, "[%c, %" PRId64 "] ", f->itens[idx].tipo, f->itens[idx].id);
+	}
+
+	coluna = escreverTela(tela, LINHA_PILHA, 0, "Pilha (topo -> base): ");
+	for (int i = p->topo; i >= 0; i--)
+	{
+		coluna = escreverTelaFormatado(tela, LINHA_PILHA, coluna, "[%c, %" PRId64 "] ", p->itens[i].tipo, p->itens[i].id);
+	}
+
+	const Pontuacao* pontuacao = &sessao->pontuacao;
+	escreverTelaFormatado(tela, LINHA_PONTUACAO, 0, "Pontos: %" PRId64 " | Linhas: %d | Nível: %d | Combo: %d",
+		pontuacao->pontos, (int)pontuacao->linhas, (int)pontuacao->nivel, pontuacao->combo + 1);
+}
+
+/// @brief Descreve os pontos ganhos por uma peça colocada, se houver.
+/// @returns Inteiro. Quantidade de linhas escritas(0 ou 1).
+static int descreverPontosGanhos(char* linha, int32_t pontos)
+{
+	if (pontos <= 0)
+	{
+		return 0;
 	}
+	snprintf(linha, TAM_MAX_MENSAGEM, "+%d pontos.", (int)pontos);
+	return 1;
 }
 
-void inicializarPilha(Pilha* p)
+int descreverRegistro(char linhas[TOTAL_LINHAS_MENSAGEM][TAM_MAX_MENSAGEM], CodigoAcao acao,
+	ResultadoAcao resultado, const RegistroAcao* registro)
 {
-	p->topo = -1;
+	if (resultado == RESULTADO_ACAO_INVALIDA)
+	{
+		snprintf(linhas[0], TAM_MAX_MENSAGEM, "Opção inválida.");
+		return 1;
+	}
+	if (resultado != RESULTADO_SUCESSO)
+	{
+		snprintf(linhas[0], TAM_MAX_MENSAGEM, "Ação abortada: %s", descreverResultado(resultado));
+		return 1;
+	}
+
+	switch (acao)
+	{
+	case ACAO_JOGAR_PECA:
+		snprintf(linhas[0], TAM_MAX_MENSAGEM, "Peça Id %" PRId64 " removida da fila. Nova Peça Id %" PRId64 " inserida na fila.",
+			registro->removida.id, registro->gerada.id);
+		return 1 + descreverPontosGanhos(linhas[1], registro->pontos);
+	case ACAO_RESERVAR_PECA:
+		snprintf(linhas[0], TAM_MAX_MENSAGEM, "Peça Id %" PRId64 " reservada na pilha. Nova Peça Id %" PRId64 " inserida na fila.",
+			registro->removida.id, registro->gerada.id);
+		return 1;
+	case ACAO_USAR_PECA_RESERVADA:
+		snprintf(linhas[0], TAM_MAX_MENSAGEM, "Peça Id %" PRId64 " removida da pilha.", registro->removida.id);
+		return 1 + descreverPontosGanhos(linhas[1], registro->pontos);
+	default:
+		// Trocas: uma linha por par de peças trocadas.
+		for (int i = 0; i < registro->totalTrocas; i++)
+		{
+			snprintf(linhas[i], TAM_MAX_MENSAGEM, "Peça Id %" PRId64 ": fila -> pilha. Peça Id %" PRId64 ": pilha -> fila.",
+				registro->paraPilha[i].id, registro->paraFila[i].id);
+		}
+		return registro->totalTrocas;
+	}
 }
 
-bool push(Pilha* pilha, Peca peca)
+// **** Modo tempo real ****
+
+bool executarModoTempoReal(Sessao* sessao)
 {
-	if (pilhaCheia(pilha))
+	if (!ativarModoBruto())
 	{
-		printf("\n ⚠️  Pilha cheia. Não é possível inserir.\n");
+		printf("\n==== ⚠️  O modo tempo real requer um terminal interativo. ====\n");
 		return false;
 	}
 
-	pilha->topo++;
-	pilha->itens[pilha->topo] = peca;
+	// Estático, para não ocupar a pilha de execução com as amostras.
+	static AmostrasLatencia latencias;
+	inicializarAmostrasLatencia(&latencias);
+
+	Agendador agendador;
+	inicializarAgendador(&agendador, NS_POR_SEGUNDO / QUADROS_POR_SEGUNDO);
+
+	// A peça da frente da fila "cai" a cada passo da gravidade. Ao alcançar o fundo, é jogada.
+	int altura = 0;
+	int64_t idQueda = sessao->fila.itens[sessao->fila.inicio].id;
+	ResultadoAcao ultimo = RESULTADO_SUCESSO;
+	bool sair = false;
+
+	// Estática, pelo tamanho dos quadros e do buffer de saída.
+	static Tela tela;
+	inicializarTela(&tela);
+
+	printf("\x1b[?25l"); // Oculta o cursor.
+	desenharQuadroTempoReal(&tela, sessao, altura, ultimo);
+
+	while (!sair)
+	{
+		// Aguardamos a entrada somente até o prazo do próximo quadro. Assim, uma tecla é
+		// processada assim que chega, sem esperar o quadro, e a gravidade nunca atrasa.
+		if (aguardarTecla(proximoPrazo(&agendador)))
+		{
+			int64_t chegada = relogioMonotonicoNs();
+			int tecla;
+
+			while (!sair && (tecla = lerTecla()) != -1)
+			{
+				if (tecla == 'q' || tecla == '0' || tecla == 27)
+				{
+					sair = true;
+					break;
+				}
+
+				CodigoAcao acao = mapearTecla(tecla);
+				if (acao == ACAO_SAIR)
+				{
+					continue; // Tecla sem ação associada.
+				}
+
+				RegistroAcao registro;
+				iniciarRastro("despacho");
+				ultimo = aplicarAcao(sessao, acao, &registro);
+				finalizarRastro("despacho");
+				registrarPasso(sessao, acao, ultimo, &registro);
+				registrarLatencia(&latencias, relogioMonotonicoNs() - chegada);
+			}
+		}
+
+		int64_t vencidos = avancarAgendador(&agendador, relogioMonotonicoNs());
+		if (vencidos == 0)
+		{
+			continue;
+		}
+
+		// Se a peça da frente mudou(jogada, reservada ou trocada), a queda recomeça.
+		if (sessao->fila.itens[sessao->fila.inicio].id != idQueda)
+		{
+			altura = 0;
+			idQueda = sessao->fila.itens[sessao->fila.inicio].id;
+		}
+
+		// Aplicamos um passo de gravidade para cada quadro vencido, mesmo os atrasados.
+		// O intervalo entre os passos diminui com o nível da pontuação.
+		for (int64_t q = agendador.quadro - vencidos + 1; q <= agendador.quadro; q++)
+		{
+			if (q % quadrosPorPassoGravidade(sessao->pontuacao.nivel) != 0 || ++altura < ALTURA_QUEDA)
+			{
+				continue;
+			}
+			RegistroAcao registro;
+			ultimo = jogarPeca(sessao, &registro);
+			registrarPasso(sessao, ACAO_JOGAR_PECA, ultimo, &registro);
+			altura = 0;
+			idQueda = sessao->fila.itens[sessao->fila.inicio].id;
+		}
+
+		desenharQuadroTempoReal(&tela, sessao, altura, ultimo);
+	}
+
+	printf("\x1b[%d;1H\x1b[?25h\n", LINHA_ENTRADA + 1); // Abaixo do quadro, reexibindo o cursor.
+	restaurarModoTerminal();
+
+	exibirResumoLatencias(&latencias, &agendador);
+
+	printf("\n==== Operação encerrada. ====\n");
 
 	return true;
 }
 
-Peca* pop(Pilha* p)
+CodigoAcao mapearTecla(int tecla)
 {
-	if (pilhaVazia(p))
+	switch (tecla)
 	{
-		printf("\n ⚠️  Pilha vazia. Não é possível remover.\n");
-		return NULL;
+	case '1': case 'j':
+		return ACAO_JOGAR_PECA;
+	case '2': case 'r':
+		return ACAO_RESERVAR_PECA;
+	case '3': case 'u':
+		return ACAO_USAR_PECA_RESERVADA;
+	case '4': case 't':
+		return ACAO_TROCAR_PECA_RESERVADA;
+	case '5': case 'g':
+		return ACAO_TROCAR_PECAS_RESERVADAS;
+	default:
+		return ACAO_SAIR;
 	}
-
-	Peca* removida = &p->itens[p->topo];
-	p->topo--;
-
-	return removida;
 }
 
-const Peca* peek(const Pilha* p)
+void desenharQuadroTempoReal(Tela* tela, const Sessao* sessao, int altura, ResultadoAcao ultimo)
 {
-	if (pilhaVazia(p))
+	limparQuadro(tela);
+	montarEstadoTela(tela, sessao, "======== TETRIS STACK - Modo Tempo Real ========");
+
+	int coluna = escreverTela(tela, LINHA_QUEDA, 0, "Queda: [");
+	for (int i = 0; i < ALTURA_QUEDA; i++)
 	{
-		printf("\n ⚠️  Pilha vazia. Nada para espiar.\n");
-		return NULL;
+		coluna = escreverTela(tela, LINHA_QUEDA, coluna, i < altura ? "#" : ".");
 	}
+	escreverTela(tela, LINHA_QUEDA, coluna, "]");
 
-	const Peca* recuperada = &p->itens[p->topo];
+	escreverTelaFormatado(tela, LINHA_MENSAGEM, 0, "Última ação: %s", descreverResultado(ultimo));
+	escreverTela(tela, LINHA_MENU, 0, "1/j Jogar  2/r Reservar  3/u Usar  4/t Trocar  5/g Trocar 3  q Sair");
+	posicionarCursorTela(tela, LINHA_ENTRADA, 0);
 
-	return recuperada;
+	apresentarTela(tela);
 }
 
-bool pilhaCheia(const Pilha* pilha)
+void exibirResumoLatencias(const AmostrasLatencia* latencias, const Agendador* agendador)
 {
-	return pilha->topo == TAM_MAX_PILHA - 1;
+	const double nsPorMs = 1e6;
+	int64_t quadroNs = agendador->periodo;
+	int64_t p99 = percentilLatencia(latencias, 99.0);
+
+	printf("\n==== Latência entrada -> mudança de estado ====\n");
+	printf("\nAções medidas: %lld\n", (long long)latencias->total);
+	printf("p50: %.4f ms | p99: %.4f ms | máx: %.4f ms\n",
+		(double)percentilLatencia(latencias, 50.0) / nsPorMs,
+		(double)p99 / nsPorMs,
+		(double)percentilLatencia(latencias, 100.0) / nsPorMs);
+	printf("Quadro(%d Hz): %.4f ms | p99 em relação ao quadro: %.2f%%\n",
+		QUADROS_POR_SEGUNDO, (double)quadroNs / nsPorMs, 100.0 * (double)p99 / (double)quadroNs);
+	printf("Quadros processados: %lld | Quadros atrasados: %lld\n",
+		(long long)agendador->quadro, (long long)agendador->perdidos);
 }
 
-bool pilhaVazia(const Pilha* pilha)
+// **** Gravação, reprodução e observação ****
+
+void registrarPasso(const Sessao* sessao, CodigoAcao acao, ResultadoAcao resultado, const RegistroAcao* registro)
 {
-	return pilha->topo == -1;
+	if (acao <= ACAO_SAIR || acao >= TOTAL_ACOES)
+	{
+		return;
+	}
+	if (arquivoGravacao != NULL)
+	{
+		gravarAcao(&gravador, acao);
+	}
+	if (arquivoRevisao != NULL)
+	{
+		gravarAcaoRevisao(&revisao, sessao, acao);
+	}
+	if (diarioAberto)
+	{
+		registrarAcaoDiario(&diario, sessao, acao);
+	}
+	if (colunasAbertas)
+	{
+		registrarColunas(&exportadorColunas, sessao, acao, resultado, registro);
+	}
+	publicarObservacao(&observacao, 0, sessao, acao);
 }
 
-void mostrarPilha(const Pilha* pilha)
+bool reproduzirGravacao(const char* caminho, Sessao* sessao)
 {
-	printf("\n==== Estado Atual da Pilha[Tipo, Id] ====\n");
-	printf("\n");
-	printf("Pilha (topo -> base):\n");
-	for (int i = pilha->topo; i >= 0; i--)
+	// Estático, pelo tamanho dos buffers de bloco.
+	static LeitorGravacao leitor;
+	if (!abrirLeitura(&leitor, caminho))
 	{
-		printf("[%c, %d] ", pilha->itens[i].tipo, pilha->itens[i].id);
+		printf("\n==== ⚠️  Gravação inválida ou inexistente: %s. ====\n", caminho);
+		return false;
 	}
-	printf("\n");
+
+	uint64_t partidas = 0, acoes = 0, verificacoes = 0, divergencias = 0;
+	bool emPartida = false;
+	EventoGravacao evento;
+	int64_t inicio = relogioMonotonicoNs();
+	iniciarRegimePermanente();
+
+	while (lerEvento(&leitor, &evento))
+	{
+		switch (evento.tipo)
+		{
+		case EVENTO_NOVA_PARTIDA:
+			srand((unsigned int)evento.valor);
+			inicializarSessao(sessao);
+			emPartida = true;
+			partidas++;
+			break;
+		case EVENTO_ACAO:
+			if (emPartida)
+			{
+				aplicarAcao(sessao, evento.acao, NULL);
+				acoes++;
+			}
+			break;
+		case EVENTO_VERIFICACAO:
+			verificacoes++;
+			if (!emPartida || (uint64_t)sessao->ids.emitidos != evento.valor)
+			{
+				divergencias++;
+			}
+			break;
+		}
+	}
+
+	int64_t decorrido = relogioMonotonicoNs() - inicio;
+	fecharLeitura(&leitor);
+
+	printf("\n==== Reprodução de %s ====\n", caminho);
+	printf("Partidas: %llu. Ações: %llu. Verificações: %llu(%llu divergentes).\n",
+		(unsigned long long)partidas, (unsigned long long)acoes,
+		(unsigned long long)verificacoes, (unsigned long long)divergencias);
+	printf("Tempo: %.3f ms(%.0f ações por segundo).\n", decorrido / 1e6,
+		decorrido > 0 ? (double)acoes * NS_POR_SEGUNDO / (double)decorrido : 0.0);
+
+	return divergencias == 0;
 }
 
-Peca gerarPeca(int* sequencial)
+bool exibirObservacoes(const char* caminho)
 {
-	int codPeca = rand() % 4 + 1; // Escolhendo uma "forma" de peça aleatoriamente.
+	RegiaoObservacao regiao;
+	if (!abrirRegiaoObservacao(&regiao, caminho))
+	{
+		printf("\n==== ⚠️  Região de observação inválida ou inexistente: %s. ====\n", caminho);
+		return false;
+	}
 
-	Peca peca; // Vamos preparar os dados da peça para atribuição.
+	int publicadas = 0;
+	for (int s = 0; s < regiao.totalSlots; s++)
+	{
+		Observacao atual;
+		if (!lerObservacao(&regiao, s, &atual) || atual.passo == 0)
+		{
+			continue;
+		}
+		publicadas++;
 
-	(*sequencial)++; // Acrescentando ao valor do ponteiro para o contador único.
+		printf("Slot %d | passo %u | geradas %" PRId64 " | pontos %" PRId64 " | nível %d | fila: ",
+			s, (unsigned int)atual.passo, atual.geradas, atual.pontos, (int)atual.nivel);
+		for (int i = 0; i < atual.totalFila; i++)
+		{
+			printf("[%c, %" PRId64 "] ", atual.fila[i].tipo, atual.fila[i].id);
+		}
+		printf("| pilha: ");
+		for (int i = atual.totalPilha - 1; i >= 0; i--)
+		{
+			printf("[%c, %" PRId64 "] ", atual.pilha[i].tipo, atual.pilha[i].id);
+		}
+		printf("\n");
+	}
+	printf("Sessões publicadas: %d de %d slots.\n", publicadas, regiao.totalSlots);
 
-	peca.id = *sequencial; // Atribuindo o valor atualizado do ponteiro ao identificador da peça a ser gerada.
+	fecharRegiaoObservacao(&regiao);
+	return true;
+}
 
-	// Optar somente entre os tipos de peça: 'I', 'O', 'T' ou 'L'.
-	switch (codPeca)
+bool exibirRevisao(const char* caminho, uint64_t acao)
+{
+	LeitorRevisao leitor;
+	if (!abrirLeitorRevisao(&leitor, caminho))
 	{
-	case 1:
-		peca.tipo = 'I';
-		break;
-	case 2:
-		peca.tipo = 'O';
-		break;
-	case 3:
-		peca.tipo = 'T';
-		break;
-	default:
-		peca.tipo = 'L';
-		break;
+		printf("\n==== ⚠️  Gravação para revisão inválida ou inexistente: %s. ====\n", caminho);
+		return false;
 	}
 
-	return peca; // Peça pronta para uso.
+	Sessao sessao;
+	GeradorPecas gerador;
+	int64_t inicioNs = relogioMonotonicoNs();
+	bool encontrada = buscarAcaoRevisao(&leitor, acao, &sessao, &gerador);
+	int64_t buscaNs = relogioMonotonicoNs() - inicioNs;
+	if (!encontrada)
+	{
+		printf("\n==== ⚠️  Ação %llu inexistente(a partida tem %llu ações). ====\n",
+			(unsigned long long)acao, (unsigned long long)leitor.totalAcoes);
+		fecharLeitorRevisao(&leitor);
+		return false;
+	}
+
+	printf("==== Revisão: ação %llu de %llu(%u quadros-chave, busca em %.1f us). ====\n",
+		(unsigned long long)acao, (unsigned long long)leitor.totalAcoes, (unsigned int)leitor.totalQuadros, buscaNs / 1e3);
+	mostrarFila(&sessao.fila);
+	mostrarPilha(&sessao.pilha);
+	mostrarPontuacao(&sessao.pontuacao);
+
+	fecharLeitorRevisao(&leitor);
+	return true;
 }
 
-bool autoGeracao(Fila* fila, int* sequencial)
+// **** Servidor para bots ****
+
+bool executarModoServidor(const char* caminho, const uint16_t* pesos)
 {
-	Peca peca = gerarPeca(sequencial);
-	if (enqueue(fila, peca))
+	// Cada conexão recebe uma nova sessão, com peças aleatórias(ou do seu gerador, com pesos).
+	srand((unsigned int)time(NULL));
+
+	printf("\n==== Servidor aguardando conexões em %s(Ctrl+C para encerrar). ====\n", caminho);
+	fflush(stdout);
+
+	EstatisticasServidor estatisticas;
+	if (!executarServidor(caminho, &observacao, colunasAbertas ? &exportadorColunas : NULL, pesos, &estatisticas))
 	{
-		printf("\n  ✅  Nova Peça Id %d inserida na fila.\n", peca.id);
-		return true;
+		printf("\n==== ⚠️  Não foi possível executar o servidor em %s. ====\n", caminho);
+		return false;
 	}
-	// Vamos devolver o valor sequencial único anterior, se a inserção não for bem sucedida.
-	(*sequencial)--;
 
-	return false;
+	printf("\n==== Servidor encerrado ====\n");
+	printf("Conexões: %llu(%llu recusadas, %llu inválidas). Lotes: %llu. Ações: %llu.\n",
+		(unsigned long long)estatisticas.conexoes, (unsigned long long)estatisticas.recusadas,
+		(unsigned long long)estatisticas.invalidas, (unsigned long long)estatisticas.lotes,
+		(unsigned long long)estatisticas.acoes);
+
+	return true;
 }
 
 // **** Funções utilitárias ****
@@ -616,4 +1498,29 @@ void limparBufferEntrada()
 void limparEnter(char* str)
 {
 	str[strcspn(str, "\n")] = '\0';
-}
\ No newline at end of file
+}
+
+bool lerPesos(const char* texto, uint16_t pesos[TOTAL_TIPOS_PECA])
+{
+	const char* p = texto;
+	for (int i = 0; i < TOTAL_TIPOS_PECA; i++)
+	{
+		// Somente dígitos: strtoul aceitaria sinais e espaços.
+		if (!isdigit((unsigned char)*p))
+		{
+			return false;
+		}
+		char* fim;
+		unsigned long valor = strtoul(p, &fim, 10);
+		if (valor > UINT16_MAX || *fim != (i + 1 < TOTAL_TIPOS_PECA ? ',' : '\0'))
+		{
+			return false;
+		}
+		pesos[i] = (uint16_t)valor;
+		p = fim + 1;
+	}
+
+	// Todos os pesos zero: distribuição inválida.
+	GeradorPecas validacao;
+	return definirPesosGerador(&validacao, pesos);
+}
@@ -0,0 +1,269 @@
+#include <string.h>
+#include <stdatomic.h>
+#include "tetris_metricas.h"
+#include "tetris_tempo.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+/// @brief Armazenamento local por thread.
+#define LOCAL_THREAD __declspec(thread)
+#else
+/// @brief Armazenamento local por thread.
+#define LOCAL_THREAD _Thread_local
+#endif
+
+// **** Variáveis internas. ****
+
+/// @brief Flag global de coleta. Alterada somente na inicialização, antes das threads de trabalho.
+static bool coletaAtiva = false;
+/// @brief Blocos de métricas, um por thread. Preservados mesmo após o término da thread.
+static Metricas blocos[TAM_MAX_THREADS_METRICAS];
+/// @brief Quantidade de blocos já entregues às threads.
+static atomic_int totalBlocos;
+/// @brief Bloco da thread atual. Obtido no primeiro registro da thread.
+static LOCAL_THREAD Metricas* blocoLocal = NULL;
+/// @brief Indica se a thread atual ficou sem bloco(todos já entregues): a thread não registra métricas.
+static LOCAL_THREAD bool semBloco = false;
+
+// **** Implementações das funções. ****
+
+/// @brief Calcula o logaritmo na base 2(parte inteira) de um valor maior que zero.
+static int log2Inteiro(uint64_t valor)
+{
+#ifdef _MSC_VER
+	unsigned long indice;
+	_BitScanReverse64(&indice, valor);
+	return (int)indice;
+#else
+	return 63 - __builtin_clzll(valor);
+#endif
+}
+
+/// @brief Calcula a faixa do histograma de uma latência. Valores menores que SUBFAIXAS_HISTOGRAMA
+/// têm faixa própria. Os demais caem na potência de 2 correspondente, dividida em subfaixas lineares.
+static int calcularFaixa(uint64_t ns)
+{
+	if (ns < SUBFAIXAS_HISTOGRAMA)
+	{
+		return (int)ns;
+	}
+	int expoente = log2Inteiro(ns);
+	int subfaixa = (int)((ns >> (expoente - 2)) & (SUBFAIXAS_HISTOGRAMA - 1));
+	return (expoente - 1) * SUBFAIXAS_HISTOGRAMA + subfaixa;
+}
+
+uint64_t limiteInferiorFaixa(int faixa)
+{
+	if (faixa < SUBFAIXAS_HISTOGRAMA)
+	{
+		return (uint64_t)faixa;
+	}
+	int expoente = faixa / SUBFAIXAS_HISTOGRAMA + 1;
+	int subfaixa = faixa % SUBFAIXAS_HISTOGRAMA;
+	return (uint64_t)(SUBFAIXAS_HISTOGRAMA + subfaixa) << (expoente - 2);
+}
+
+/// @brief Recupera o bloco de métricas da thread atual, reservando-o no primeiro uso.
+/// @returns Metricas. Bloco da thread, ou NULL se todos os blocos já foram entregues.
+static Metricas* blocoDaThread(void)
+{
+	if (blocoLocal == NULL && !semBloco)
+	{
+		// Um bloco nunca é compartilhado: os contadores são incrementados sem atomicidade.
+		int indice = atomic_fetch_add(&totalBlocos, 1);
+		if (indice < TAM_MAX_THREADS_METRICAS)
+		{
+			blocoLocal = &blocos[indice];
+		}
+		else
+		{
+			semBloco = true;
+		}
+	}
+	return blocoLocal;
+}
+
+void ativarMetricas(bool ativas)
+{
+	coletaAtiva = ativas;
+}
+
+bool metricasAtivas(void)
+{
+	return coletaAtiva;
+}
+
+int64_t iniciarMedicao(void)
+{
+	return coletaAtiva ? relogioMonotonicoNs() : 0;
+}
+
+void finalizarMedicao(CodigoMetrica metrica, ResultadoAcao resultado, int64_t inicioNs)
+{
+	if (!coletaAtiva)
+	{
+		return;
+	}
+
+	Metricas* bloco = blocoDaThread();
+	if (bloco == NULL)
+	{
+		return;
+	}
+
+	int64_t decorrido = relogioMonotonicoNs() - inicioNs;
+	uint64_t ns = decorrido > 0 ? (uint64_t)decorrido : 0;
+	MetricaAcao* m = &bloco->acoes[metrica];
+
+	m->chamadas++;
+	if (resultado == RESULTADO_SUCESSO)
+	{
+		m->sucessos++;
+	}
+	else
+	{
+		m->cancelamentos[resultado]++;
+	}
+	m->somaNs += ns;
+	if (ns > m->maximoNs)
+	{
+		m->maximoNs = ns;
+	}
+	m->faixas[calcularFaixa(ns)]++;
+}
+
+void consolidarMetricas(Metricas* destino)
+{
+	int total = atomic_load(&totalBlocos);
+	if (total > TAM_MAX_THREADS_METRICAS)
+	{
+		total = TAM_MAX_THREADS_METRICAS;
+	}
+
+	memset(destino, 0, sizeof(*destino));
+
+	for (int b = 0; b < total; b++)
+	{
+		for (int a = 0; a < TOTAL_METRICAS; a++)
+		{
+			const MetricaAcao* origem = &blocos[b].acoes[a];
+			MetricaAcao* soma = &destino->acoes[a];
+
+			soma->chamadas += origem->chamadas;
+			soma->sucessos += origem->sucessos;
+			for (int r = 0; r < TOTAL_RESULTADOS; r++)
+			{
+				soma->cancelamentos[r] += origem->cancelamentos[r];
+			}
+			soma->somaNs += origem->somaNs;
+			if (origem->maximoNs > soma->maximoNs)
+			{
+				soma->maximoNs = origem->maximoNs;
+			}
+			for (int f = 0; f < TOTAL_FAIXAS_HISTOGRAMA; f++)
+			{
+				soma->faixas[f] += origem->faixas[f];
+			}
+		}
+	}
+}
+
+void zerarMetricas(void)
+{
+	memset(blocos, 0, sizeof(blocos));
+}
+
+uint64_t percentilMetrica(const MetricaAcao* metrica, double percentil)
+{
+	if (metrica->chamadas == 0)
+	{
+		return 0;
+	}
+
+	// Método do posto mais próximo(nearest-rank), sobre as contagens acumuladas das faixas.
+	uint64_t posto = (uint64_t)(percentil / 100.0 * (double)metrica->chamadas + 0.999999);
+	if (posto < 1)
+	{
+		posto = 1;
+	}
+
+	uint64_t acumulado = 0;
+	for (int f = 0; f < TOTAL_FAIXAS_HISTOGRAMA; f++)
+	{
+		acumulado += metrica->faixas[f];
+		if (acumulado >= posto)
+		{
+			// Limite superior da faixa, sem ultrapassar o máximo observado.
+			uint64_t superior = f + 1 < TOTAL_FAIXAS_HISTOGRAMA ? limiteInferiorFaixa(f + 1) - 1 : UINT64_MAX;
+			return superior < metrica->maximoNs ? superior : metrica->maximoNs;
+		}
+	}
+
+	return metrica->maximoNs;
+}
+
+const char* nomeMetrica(CodigoMetrica metrica)
+{
+	switch (metrica)
+	{
+	case METRICA_JOGAR_PECA:
+		return "acaoJogarPeca";
+	case METRICA_RESERVAR_PECA:
+		return "acaoReservarPeca";
+	case METRICA_USAR_PECA_RESERVADA:
+		return "acaoUsarPecaReservada";
+	case METRICA_TROCAR_PECA_RESERVADA:
+		return "acaoTrocarPecaReservada";
+	case METRICA_TROCAR_PECAS_RESERVADAS:
+		return "acaoTrocarPecasReservadas";
+	case METRICA_AUTO_GERACAO:
+		return "autoGeracao";
+	default:
+		return "desconhecida";
+	}
+}
+
+void escreverMetricasJson(FILE* arquivo, const Metricas* metricas)
+{
+	fprintf(arquivo, "{\n  \"acoes\": [\n");
+
+	for (int a = 0; a < TOTAL_METRICAS; a++)
+	{
+		const MetricaAcao* m = &metricas->acoes[a];
+
+		fprintf(arquivo, "    {\n      \"nome\": \"%s\",\n", nomeMetrica((CodigoMetrica)a));
+		fprintf(arquivo, "      \"chamadas\": %llu,\n      \"sucessos\": %llu,\n",
+			(unsigned long long)m->chamadas, (unsigned long long)m->sucessos);
+
+		fprintf(arquivo, "      \"cancelamentos\": {");
+		bool primeiro = true;
+		for (int r = RESULTADO_SUCESSO + 1; r < TOTAL_RESULTADOS; r++)
+		{
+			fprintf(arquivo, "%s\"%s\": %llu", primeiro ? "" : ", ",
+				nomeResultado((ResultadoAcao)r), (unsigned long long)m->cancelamentos[r]);
+			primeiro = false;
+		}
+		fprintf(arquivo, "},\n");
+
+		fprintf(arquivo, "      \"latencia_ns\": {\"soma\": %llu, \"max\": %llu, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu,\n",
+			(unsigned long long)m->somaNs, (unsigned long long)m->maximoNs,
+			(unsigned long long)percentilMetrica(m, 50.0), (unsigned long long)percentilMetrica(m, 90.0),
+			(unsigned long long)percentilMetrica(m, 99.0), (unsigned long long)percentilMetrica(m, 99.9));
+
+		// Somente as faixas não vazias, como pares [limite inferior em ns, contagem].
+		fprintf(arquivo, "        \"faixas\": [");
+		primeiro = true;
+		for (int f = 0; f < TOTAL_FAIXAS_HISTOGRAMA; f++)
+		{
+			if (m->faixas[f] == 0)
+			{
+				continue;
+			}
+			fprintf(arquivo, "%s[%llu, %llu]", primeiro ? "" : ", ",
+				(unsigned long long)limiteInferiorFaixa(f), (unsigned long long)m->faixas[f]);
+			primeiro = false;
+		}
+		fprintf(arquivo, "]}\n    }%s\n", a + 1 < TOTAL_METRICAS ? "," : "");
+	}
+
+	fprintf(arquivo, "  ]\n}\n");
+}
@@ -0,0 +1,95 @@
+#ifndef TETRIS_METRICAS_H
+#define TETRIS_METRICAS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Métricas por ação: contadores de chamadas, sucessos e cancelamentos(por motivo), além de
+// histogramas de latência em faixas logarítmicas, com resolução de nanossegundos.
+// Cada thread registra em um bloco próprio(sem disputa); a consolidação soma todos os blocos.
+
+// **** Definições de constantes. ****
+
+/// @brief Subdivisões lineares de cada potência de 2 do histograma(precisão de ~25% por faixa).
+#define SUBFAIXAS_HISTOGRAMA 4
+
+/// @brief Quantidade de faixas do histograma. Cobre latências de 0 ns até 2^63 ns.
+#define TOTAL_FAIXAS_HISTOGRAMA (64 * SUBFAIXAS_HISTOGRAMA)
+
+/// @brief Quantidade máxima de threads com blocos de métricas. Os blocos não são reaproveitados quando
+/// uma thread termina(as suas contagens são preservadas), e as threads excedentes não registram métricas.
+#define TAM_MAX_THREADS_METRICAS 64
+
+// **** Declarações de estruturas. ****
+
+/// @brief Funções instrumentadas.
+typedef enum {
+	METRICA_JOGAR_PECA,
+	METRICA_RESERVAR_PECA,
+	METRICA_USAR_PECA_RESERVADA,
+	METRICA_TROCAR_PECA_RESERVADA,
+	METRICA_TROCAR_PECAS_RESERVADAS,
+	METRICA_AUTO_GERACAO,
+	TOTAL_METRICAS
+} CodigoMetrica;
+
+/// @brief Contadores e histograma de latência de uma função instrumentada.
+typedef struct {
+	uint64_t chamadas;
+	uint64_t sucessos;
+	/// @brief Cancelamentos por motivo, indexados por ResultadoAcao.
+	uint64_t cancelamentos[TOTAL_RESULTADOS];
+	uint64_t somaNs;
+	uint64_t maximoNs;
+	uint64_t faixas[TOTAL_FAIXAS_HISTOGRAMA];
+} MetricaAcao;
+
+/// @brief Conjunto das métricas de todas as funções instrumentadas.
+typedef struct {
+	MetricaAcao acoes[TOTAL_METRICAS];
+} Metricas;
+
+// **** Declarações das funções. ****
+
+/// @brief Habilita ou desabilita a coleta de métricas(desabilitada por padrão).
+/// Com a coleta desabilitada, cada medição custa apenas um teste de flag.
+/// @param bool. Verdadeiro(true) para habilitar.
+void ativarMetricas(bool ativas);
+/// @brief Verifica se a coleta de métricas está habilitada.
+/// @returns Verdadeiro(true) se habilitada.
+bool metricasAtivas(void);
+/// @brief Inicia a medição de uma função instrumentada.
+/// @returns Inteiro. Instante inicial, em nanossegundos(zero, se a coleta estiver desabilitada).
+int64_t iniciarMedicao(void);
+/// @brief Finaliza a medição de uma função instrumentada, registrando-a no bloco da thread atual.
+/// @param CodigoMetrica. Função instrumentada.
+/// @param ResultadoAcao. Resultado da função.
+/// @param Inteiro. Instante inicial, retornado por iniciarMedicao.
+void finalizarMedicao(CodigoMetrica metrica, ResultadoAcao resultado, int64_t inicioNs);
+/// @brief Soma os blocos de todas as threads. Exato quando as demais threads estão ociosas.
+/// @param Metricas. Ponteiro via referência, para conter a consolidação.
+void consolidarMetricas(Metricas* destino);
+/// @brief Zera as métricas de todas as threads.
+void zerarMetricas(void);
+/// @brief Estima um percentil de latência a partir do histograma(limite superior da faixa).
+/// @param MetricaAcao. Ponteiro usado na estimativa. Somente leitura.
+/// @param double. Percentil desejado, entre 0 e 100. Ex: 99.0.
+/// @returns Inteiro. Latência estimada, em nanossegundos. Zero, se não houver registros.
+uint64_t percentilMetrica(const MetricaAcao* metrica, double percentil);
+/// @brief Recupera o limite inferior, em nanossegundos, de uma faixa do histograma.
+/// @param Inteiro. Índice da faixa.
+/// @returns Inteiro. Limite inferior da faixa.
+uint64_t limiteInferiorFaixa(int faixa);
+/// @brief Recupera o nome de uma função instrumentada.
+/// @param CodigoMetrica. Função instrumentada.
+/// @returns Texto constante, com o nome.
+const char* nomeMetrica(CodigoMetrica metrica);
+/// @brief Escreve as métricas em formato JSON(legível por máquina).
+/// @param FILE. Arquivo de destino.
+/// @param Metricas. Ponteiro com as métricas a serem escritas. Somente leitura.
+void escreverMetricasJson(FILE* arquivo, const Metricas* metricas);
+
+#endif // TETRIS_METRICAS_H
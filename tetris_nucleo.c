@@ -0,0 +1,760 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "tetris_nucleo.h"
+#include "tetris_metricas.h"
+#include "tetris_rastro.h"
+
+// **** Implementações das funções. ****
+
+#if TAM_MAX_PILHA <= LIMITE_DESENROLAMENTO
+/// @brief Troca em grupo da fila com a pilha cheia, desenrolada para TAM_MAX_PILHA(ver tetris_fixas.h).
+DEFINIR_TROCA_GRUPO(trocarGrupo, Fila, Pilha, TAM_MAX_PILHA)
+#else
+/// @brief Troca em grupo genérica, para as pilhas acima de LIMITE_DESENROLAMENTO: sem os temporários
+/// de TAM_MAX_PILHA peças da rotina desenrolada.
+DEFINIR_TROCA_GRUPO_VARIAVEL(trocarGrupoVariavel, Fila, Pilha)
+
+/// @brief Troca em grupo da fila com a pilha cheia(TAM_MAX_PILHA peças), pela rotina genérica.
+static inline void trocarGrupo(Fila* fila, Pilha* pilha, bool inverter, Peca* paraPilha, Peca* paraFila)
+{
+	trocarGrupoVariavel(fila, pilha, TAM_MAX_PILHA, inverter, paraPilha, paraFila);
+}
+#endif
+
+/// @brief Contador global das identificações das peças: início do próximo bloco a ser reservado.
+static _Atomic int64_t proximoBlocoIds = 1;
+
+// **** Funções de Lógica Principal ****
+
+/// @brief Repõe uma peça no final da fila da sessão, com o gerador da sessão, se houver.
+static bool reporPeca(Sessao* sessao, Peca* gerada);
+
+void inicializarSessao(Sessao* sessao)
+{
+	inicializarAlocadorIds(&sessao->ids);
+	inicializarPontuacao(&sessao->pontuacao);
+	sessao->trocou = false;
+	sessao->gerador = NULL;
+	inicializarFila(&sessao->fila);
+	popularFila(&sessao->fila, &sessao->ids);
+	inicializarPilha(&sessao->pilha);
+}
+
+void inicializarSessaoComGerador(Sessao* sessao, GeradorPecas* gerador)
+{
+	inicializarAlocadorIds(&sessao->ids);
+	inicializarPontuacao(&sessao->pontuacao);
+	sessao->trocou = false;
+	sessao->gerador = gerador;
+	inicializarFila(&sessao->fila);
+	reabastecerFila(&sessao->fila, &sessao->ids, gerador);
+	inicializarPilha(&sessao->pilha);
+}
+
+ResultadoAcao aplicarAcao(Sessao* sessao, CodigoAcao acao, RegistroAcao* registro)
+{
+	switch (acao)
+	{
+	case ACAO_JOGAR_PECA:
+		return jogarPeca(sessao, registro);
+	case ACAO_RESERVAR_PECA:
+		return reservarPeca(sessao, registro);
+	case ACAO_USAR_PECA_RESERVADA:
+		return usarPecaReservada(sessao, registro);
+	case ACAO_TROCAR_PECA_RESERVADA:
+		return trocarPecaReservada(sessao, registro);
+	case ACAO_TROCAR_PECAS_RESERVADAS:
+		return trocarPecasReservadas(sessao, registro);
+	default:
+		return RESULTADO_ACAO_INVALIDA;
+	}
+}
+
+/// @brief Lógica de jogarPeca, sem instrumentação.
+static ResultadoAcao efetuarJogarPeca(Sessao* sessao, RegistroAcao* registro)
+{
+	Peca* peca = dequeue(&sessao->fila);
+
+	if (peca == NULL)
+	{
+		return RESULTADO_FILA_VAZIA;
+	}
+
+	Peca removida = *peca;
+	Peca gerada = { 0 };
+
+	// Ao desinfileirarmos um elemento, outro deverá ser enfileirado automaticamente.
+	// Acabamos de liberar uma alocação, então a reposição não tem como falhar.
+	bool reposta = reporPeca(sessao, &gerada);
+	int32_t pontos = pontuarColocacao(&sessao->pontuacao, removida.tipo, false);
+
+	if (registro != NULL)
+	{
+		registro->removida = removida;
+		registro->reposta = reposta;
+		registro->gerada = gerada;
+		registro->totalTrocas = 0;
+		registro->pontos = pontos;
+	}
+
+	return RESULTADO_SUCESSO;
+}
+
+/// @brief Lógica de reservarPeca, sem instrumentação.
+static ResultadoAcao efetuarReservarPeca(Sessao* sessao, RegistroAcao* registro)
+{
+	if (filaVazia(&sessao->fila))
+	{
+		return RESULTADO_FILA_VAZIA;
+	}
+	if (pilhaCheia(&sessao->pilha))
+	{
+		return RESULTADO_PILHA_CHEIA;
+	}
+
+	// Não precisaríamos reter o ponteiro para a peça em si, nesse cenário.
+	// Somente uma cópia segura dos valores.
+	Peca removida = *dequeue(&sessao->fila);
+	Peca gerada = { 0 };
+
+	push(&sessao->pilha, removida);
+	bool reposta = reporPeca(sessao, &gerada);
+
+	// Vamos atualizar o valor da flag para trocas futuras de grupos de peças, informando que a
+	// uma ordenação(inversão) precisará ser feita, para a um novo grupo de peças recém reservadas.
+	sessao->trocou = false;
+
+	if (registro != NULL)
+	{
+		registro->removida = removida;
+		registro->reposta = reposta;
+		registro->gerada = gerada;
+		registro->totalTrocas = 0;
+		registro->pontos = 0;
+	}
+
+	return RESULTADO_SUCESSO;
+}
+
+/// @brief Lógica de usarPecaReservada, sem instrumentação.
+static ResultadoAcao efetuarUsarPecaReservada(Sessao* sessao, RegistroAcao* registro)
+{
+	Peca* peca = pop(&sessao->pilha);
+
+	if (peca == NULL)
+	{
+		return RESULTADO_PILHA_VAZIA;
+	}
+
+	int32_t pontos = pontuarColocacao(&sessao->pontuacao, peca->tipo, true);
+
+	if (registro != NULL)
+	{
+		registro->removida = *peca;
+		registro->reposta = false;
+		registro->totalTrocas = 0;
+		registro->pontos = pontos;
+	}
+
+	return RESULTADO_SUCESSO;
+}
+
+/// @brief Lógica de trocarPecaReservada, sem instrumentação.
+static ResultadoAcao efetuarTrocarPecaReservada(Sessao* sessao, RegistroAcao* registro)
+{
+	Fila* fila = &sessao->fila;
+	Pilha* pilha = &sessao->pilha;
+
+	// Precisamos garantir ao menos 1 elemento existente em ambos os lados,
+	// tanto da fila quanto da pilha, para efetuarmos a troca.
+	if (filaVazia(fila))
+	{
+		return RESULTADO_FILA_VAZIA;
+	}
+	if (pilhaVazia(pilha))
+	{
+		return RESULTADO_PILHA_VAZIA;
+	}
+
+	// Troca simplificada peça da frente(início) da fila com o topo da pilha.
+	Peca frente = fila->itens[fila->inicio];
+	Peca topo = pilha->itens[pilha->topo];
+	fila->itens[fila->inicio] = topo;
+	pilha->itens[pilha->topo] = frente;
+
+	if (registro != NULL)
+	{
+		registro->reposta = false;
+		registro->totalTrocas = 1;
+		registro->pontos = 0;
+		registro->paraPilha[0] = frente;
+		registro->paraFila[0] = topo;
+	}
+
+	return RESULTADO_SUCESSO;
+}
+
+/// @brief Lógica de trocarPecasReservadas, sem instrumentação.
+static ResultadoAcao efetuarTrocarPecasReservadas(Sessao* sessao, RegistroAcao* registro)
+{
+	Fila* fila = &sessao->fila;
+	Pilha* pilha = &sessao->pilha;
+
+	// Precisamos garantir os 3 elementos existentes em ambos os lados,
+	// tanto da fila quanto da pilha, para efetuarmos a troca.
+	if (!(pilhaCheia(pilha) && fila->total >= TAM_MAX_PILHA))
+	{
+		return RESULTADO_PECAS_INSUFICIENTES;
+	}
+
+	// Efetuando as trocas, respeitando tanto a ordem circular da fila, quanto a ordem invertida da pilha.
+	// Se a inversão já houver sido efetivada anteriormente, para os grupos atuais,
+	// iremos apenas restaurar a sua ordem original. Caso contrário, significa que novas
+	// peças foram reservadas, e um novo grupo de elementos está efetivando uma nova troca.
+	// Com a pilha cheia, a quantidade é sempre TAM_MAX_PILHA: a rotina é desenrolada(até LIMITE_DESENROLAMENTO).
+	trocarGrupo(fila, pilha, sessao->trocou,
+		registro != NULL ? registro->paraPilha : NULL, registro != NULL ? registro->paraFila : NULL);
+
+	if (registro != NULL)
+	{
+		registro->reposta = false;
+		registro->totalTrocas = TAM_MAX_PILHA;
+		registro->pontos = 0;
+	}
+
+	sessao->trocou = true; // Atualizando o valor da flag para informar que a troca foi efetivada.
+
+	return RESULTADO_SUCESSO;
+}
+
+ResultadoAcao jogarPeca(Sessao* sessao, RegistroAcao* registro)
+{
+	int64_t inicio = iniciarMedicao();
+	ResultadoAcao resultado = efetuarJogarPeca(sessao, registro);
+	finalizarMedicao(METRICA_JOGAR_PECA, resultado, inicio);
+	return resultado;
+}
+
+ResultadoAcao reservarPeca(Sessao* sessao, RegistroAcao* registro)
+{
+	int64_t inicio = iniciarMedicao();
+	ResultadoAcao resultado = efetuarReservarPeca(sessao, registro);
+	finalizarMedicao(METRICA_RESERVAR_PECA, resultado, inicio);
+	return resultado;
+}
+
+ResultadoAcao usarPecaReservada(Sessao* sessao, RegistroAcao* registro)
+{
+	int64_t inicio = iniciarMedicao();
+	ResultadoAcao resultado = efetuarUsarPecaReservada(sessao, registro);
+	finalizarMedicao(METRICA_USAR_PECA_RESERVADA, resultado, inicio);
+	return resultado;
+}
+
+ResultadoAcao trocarPecaReservada(Sessao* sessao, RegistroAcao* registro)
+{
+	int64_t inicio = iniciarMedicao();
+	ResultadoAcao resultado = efetuarTrocarPecaReservada(sessao, registro);
+	finalizarMedicao(METRICA_TROCAR_PECA_RESERVADA, resultado, inicio);
+	return resultado;
+}
+
+ResultadoAcao trocarPecasReservadas(Sessao* sessao, RegistroAcao* registro)
+{
+	int64_t inicio = iniciarMedicao();
+	ResultadoAcao resultado = efetuarTrocarPecasReservadas(sessao, registro);
+	finalizarMedicao(METRICA_TROCAR_PECAS_RESERVADAS, resultado, inicio);
+	return resultado;
+}
+
+const char* descreverResultado(ResultadoAcao resultado)
+{
+	switch (resultado)
+	{
+	case RESULTADO_SUCESSO:
+		return "Ação efetuada com êxito.";
+	case RESULTADO_FILA_VAZIA:
+		return "Fila vazia.";
+	case RESULTADO_FILA_CHEIA:
+		return "Fila cheia.";
+	case RESULTADO_PILHA_VAZIA:
+		return "Pilha vazia.";
+	case RESULTADO_PILHA_CHEIA:
+		return "Pilha cheia.";
+	case RESULTADO_PECAS_INSUFICIENTES:
+		return "Peças insuficientes para a troca.";
+	default:
+		return "Ação inválida.";
+	}
+}
+
+const char* nomeResultado(ResultadoAcao resultado)
+{
+	switch (resultado)
+	{
+	case RESULTADO_SUCESSO:
+		return "sucesso";
+	case RESULTADO_FILA_VAZIA:
+		return "fila_vazia";
+	case RESULTADO_FILA_CHEIA:
+		return "fila_cheia";
+	case RESULTADO_PILHA_VAZIA:
+		return "pilha_vazia";
+	case RESULTADO_PILHA_CHEIA:
+		return "pilha_cheia";
+	case RESULTADO_PECAS_INSUFICIENTES:
+		return "pecas_insuficientes";
+	default:
+		return "acao_invalida";
+	}
+}
+
+void inicializarFila(Fila* f)
+{
+	f->inicio = 0;
+	f->fim = 0;
+	f->total = 0;
+}
+
+bool filaCheia(const Fila* fila)
+{
+	return fila->total == TAM_MAX_FILA;
+}
+
+bool filaVazia(const Fila* fila)
+{
+	return fila->total == 0;
+}
+
+bool enqueue(Fila* fila, Peca peca)
+{
+	if (filaCheia(fila))
+	{
+		return false;
+	}
+
+	fila->itens[fila->fim] = peca;
+	fila->fim = avancarFila(fila->fim);
+	fila->total++;
+
+	return true;
+}
+
+Peca* dequeue(Fila* fila)
+{
+	if (filaVazia(fila))
+	{
+		return NULL;
+	}
+
+	Peca* peca = &fila->itens[fila->inicio];
+	fila->inicio = avancarFila(fila->inicio);
+	fila->total--;
+
+	return peca;
+}
+
+void popularFila(Fila* fila, AlocadorIds* ids)
+{
+	reabastecerFila(fila, ids, NULL);
+}
+
+void inicializarPilha(Pilha* p)
+{
+	p->topo = -1;
+}
+
+bool push(Pilha* pilha, Peca peca)
+{
+	if (pilhaCheia(pilha))
+	{
+		return false;
+	}
+
+	pilha->topo++;
+	pilha->itens[pilha->topo] = peca;
+
+	return true;
+}
+
+Peca* pop(Pilha* p)
+{
+	if (pilhaVazia(p))
+	{
+		return NULL;
+	}
+
+	Peca* removida = &p->itens[p->topo];
+	p->topo--;
+
+	return removida;
+}
+
+const Peca* peek(const Pilha* p)
+{
+	if (pilhaVazia(p))
+	{
+		return NULL;
+	}
+
+	return &p->itens[p->topo];
+}
+
+bool pilhaCheia(const Pilha* pilha)
+{
+	return pilha->topo == TAM_MAX_PILHA - 1;
+}
+
+bool pilhaVazia(const Pilha* pilha)
+{
+	return pilha->topo == -1;
+}
+
+Peca gerarPeca(AlocadorIds* ids)
+{
+	iniciarRastro("gerarPeca");
+
+	int codPeca = rand() % 4 + 1; // Escolhendo uma "forma" de peça aleatoriamente.
+
+	Peca peca; // Vamos preparar os dados da peça para atribuição.
+
+	peca.id = alocarIdPeca(ids); // Atribuindo uma identificação única à peça a ser gerada.
+
+	// Optar somente entre os tipos de peça: 'I', 'O', 'T' ou 'L'.
+	switch (codPeca)
+	{
+	case 1:
+		peca.tipo = 'I';
+		break;
+	case 2:
+		peca.tipo = 'O';
+		break;
+	case 3:
+		peca.tipo = 'T';
+		break;
+	default:
+		peca.tipo = 'L';
+		break;
+	}
+
+	finalizarRastro("gerarPeca");
+
+	return peca; // Peça pronta para uso.
+}
+
+/// @brief Sorteia o número de 64 bits de um bloco de peças, misturando(finalizador do splitmix64)
+/// o índice do bloco com a semente. Os blocos são independentes entre si.
+static inline uint64_t sortearBloco(uint64_t semente, uint64_t bloco)
+{
+	uint64_t z = semente + (bloco + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/// @brief Recupera o código do tipo da peça de uma posição qualquer da sequência.
+static inline int codigoNaPosicao(uint64_t semente, uint64_t posicao)
+{
+	uint64_t bits = sortearBloco(semente, posicao / PECAS_POR_BLOCO_GERADOR);
+	return (int)((bits >> (2 * (posicao % PECAS_POR_BLOCO_GERADOR))) & 3);
+}
+
+/// @brief Recupera o código do tipo da peça de uma posição qualquer, pela tabela de aliases do gerador.
+/// Um número de 64 bits por peça: os 2 bits baixos escolhem a coluna, e os 32 bits altos são comparados
+/// com o limiar da coluna. A semente é alterada para não repetir os números da sequência uniforme.
+static inline int codigoPonderado(const GeradorPecas* gerador, uint64_t posicao)
+{
+	uint64_t bits = sortearBloco(gerador->semente ^ 0x5851F42D4C957F2DULL, posicao);
+	int coluna = (int)(bits & (TOTAL_TIPOS_PECA - 1));
+	return (bits >> 32) < gerador->limiares[coluna] ? coluna : gerador->aliases[coluna];
+}
+
+void inicializarGerador(GeradorPecas* gerador, uint64_t semente)
+{
+	gerador->semente = semente;
+	gerador->contador = 0;
+	definirPesosGerador(gerador, NULL);
+}
+
+bool definirPesosGerador(GeradorPecas* gerador, const uint16_t pesos[TOTAL_TIPOS_PECA])
+{
+	if (pesos == NULL)
+	{
+		gerador->ponderado = false;
+		for (int i = 0; i < TOTAL_TIPOS_PECA; i++)
+		{
+			gerador->pesos[i] = 0;
+			gerador->aliases[i] = (uint8_t)i;
+			gerador->limiares[i] = 1ULL << 32;
+		}
+		return true;
+	}
+
+	uint64_t total = 0;
+	for (int i = 0; i < TOTAL_TIPOS_PECA; i++)
+	{
+		total += pesos[i];
+	}
+	if (total == 0)
+	{
+		return false;
+	}
+
+	// Método de Vose, em aritmética inteira: os pesos são escalados pela quantidade de colunas, e a média
+	// passa a ser o total. Cada coluna abaixo da média é completada por uma acima dela(o seu alias).
+	// As somas são exatas: as colunas restantes ao final têm exatamente a média(limiar máximo).
+	uint64_t valores[TOTAL_TIPOS_PECA];
+	int pequenas[TOTAL_TIPOS_PECA];
+	int grandes[TOTAL_TIPOS_PECA];
+	int totalPequenas = 0;
+	int totalGrandes = 0;
+	for (int i = 0; i < TOTAL_TIPOS_PECA; i++)
+	{
+		valores[i] = (uint64_t)pesos[i] * TOTAL_TIPOS_PECA;
+		if (valores[i] < total)
+		{
+			pequenas[totalPequenas++] = i;
+		}
+		else
+		{
+			grandes[totalGrandes++] = i;
+		}
+		gerador->pesos[i] = pesos[i];
+		gerador->aliases[i] = (uint8_t)i;
+		gerador->limiares[i] = 1ULL << 32;
+	}
+
+	while (totalPequenas > 0 && totalGrandes > 0)
+	{
+		int pequena = pequenas[--totalPequenas];
+		int grande = grandes[--totalGrandes];
+		gerador->limiares[pequena] = (valores[pequena] << 32) / total;
+		gerador->aliases[pequena] = (uint8_t)grande;
+		valores[grande] -= total - valores[pequena];
+		if (valores[grande] < total)
+		{
+			pequenas[totalPequenas++] = grande;
+		}
+		else
+		{
+			grandes[totalGrandes++] = grande;
+		}
+	}
+
+	gerador->ponderado = true;
+	return true;
+}
+
+void inicializarAlocadorIds(AlocadorIds* ids)
+{
+	// Alocador vazio: a primeira alocação reserva um bloco.
+	ids->proximo = 0;
+	ids->limite = 0;
+	ids->emitidos = 0;
+}
+
+/// @brief Reserva identificações consecutivas do bloco atual do alocador(reservando um novo bloco, se esgotado).
+/// @param Inteiro. Quantidade desejada. Ponteiro via referência: recebe a quantidade obtida(até o fim do bloco).
+/// @returns Inteiro. Primeira identificação reservada.
+static inline int64_t reservarIds(AlocadorIds* ids, int* quantidade)
+{
+	if (ids->proximo >= ids->limite)
+	{
+		// Única operação compartilhada: as demais alocações do bloco são locais ao alocador.
+		ids->proximo = atomic_fetch_add_explicit(&proximoBlocoIds, TAM_BLOCO_IDS, memory_order_relaxed);
+		ids->limite = ids->proximo + TAM_BLOCO_IDS;
+	}
+
+	int64_t disponiveis = ids->limite - ids->proximo;
+	if (*quantidade > disponiveis)
+	{
+		*quantidade = (int)disponiveis;
+	}
+
+	int64_t primeiro = ids->proximo;
+	ids->proximo += *quantidade;
+	ids->emitidos += *quantidade;
+	return primeiro;
+}
+
+int64_t alocarIdPeca(AlocadorIds* ids)
+{
+	int quantidade = 1;
+	return reservarIds(ids, &quantidade);
+}
+
+/// @brief Lógica de gerarPecas, com identificações consecutivas a partir da base informada.
+static void gerarTrecho(Peca* destino, int quantidade, int64_t base, GeradorPecas* gerador)
+{
+	uint64_t semente = gerador->semente;
+	uint64_t posicao = gerador->contador;
+	int i = 0;
+
+	// Distribuição ponderada: um sorteio por peça, pela tabela de aliases.
+	if (gerador->ponderado)
+	{
+		for (; i < quantidade; i++, posicao++)
+		{
+			destino[i].tipo = TIPOS_PECA[codigoPonderado(gerador, posicao)];
+			destino[i].id = base + i;
+		}
+		gerador->contador = posicao;
+		return;
+	}
+
+	// Início desalinhado: completamos o bloco parcialmente consumido pelo lote anterior.
+	for (; i < quantidade && posicao % PECAS_POR_BLOCO_GERADOR != 0; i++, posicao++)
+	{
+		destino[i].tipo = TIPOS_PECA[codigoNaPosicao(semente, posicao)];
+		destino[i].id = base + i;
+	}
+
+	// Blocos completos: um único sorteio para cada 32 peças. O laço interno tem deslocamentos
+	// constantes após o desenrolamento, e as identificações são um prefixo simples(base + índice).
+	for (; quantidade - i >= PECAS_POR_BLOCO_GERADOR; i += PECAS_POR_BLOCO_GERADOR, posicao += PECAS_POR_BLOCO_GERADOR)
+	{
+		uint64_t bits = sortearBloco(semente, posicao / PECAS_POR_BLOCO_GERADOR);
+		Peca* bloco = &destino[i];
+		int64_t idBloco = base + i;
+
+		for (int j = 0; j < PECAS_POR_BLOCO_GERADOR; j++)
+		{
+			bloco[j].tipo = TIPOS_PECA[(bits >> (2 * j)) & 3];
+			bloco[j].id = idBloco + j;
+		}
+	}
+
+	// Final desalinhado: o bloco restante fica parcialmente consumido para o próximo lote.
+	for (; i < quantidade; i++, posicao++)
+	{
+		destino[i].tipo = TIPOS_PECA[codigoNaPosicao(semente, posicao)];
+		destino[i].id = base + i;
+	}
+
+	gerador->contador = posicao;
+}
+
+void gerarPecas(Peca* destino, int quantidade, AlocadorIds* ids, GeradorPecas* gerador)
+{
+	if (quantidade <= 0)
+	{
+		return;
+	}
+
+	iniciarRastro("gerarPecas");
+
+	// Um trecho por bloco de identificações: normalmente um único trecho.
+	for (int i = 0; i < quantidade;)
+	{
+		int trecho = quantidade - i;
+		int64_t base = reservarIds(ids, &trecho);
+		gerarTrecho(&destino[i], trecho, base, gerador);
+		i += trecho;
+	}
+
+	finalizarRastro("gerarPecas");
+}
+
+/// @brief Preenche um trecho contíguo de peças, com identificações consecutivas a partir da base informada.
+/// Sem gerador, os tipos são aleatórios(via rand), como em gerarPeca.
+static void preencherTrecho(Peca* destino, int quantidade, int64_t base, GeradorPecas* gerador)
+{
+	if (gerador != NULL)
+	{
+		gerarTrecho(destino, quantidade, base, gerador);
+		return;
+	}
+	for (int i = 0; i < quantidade; i++)
+	{
+		destino[i].tipo = TIPOS_PECA[rand() % TOTAL_TIPOS_PECA];
+		destino[i].id = base + i;
+	}
+}
+
+int reabastecerFila(Fila* fila, AlocadorIds* ids, GeradorPecas* gerador)
+{
+	int livres = TAM_MAX_FILA - fila->total;
+	if (livres == 0)
+	{
+		return 0;
+	}
+
+	iniciarRastro("reabastecerFila");
+
+	// As posições livres começam no fim da fila e formam no máximo dois trechos contíguos(até o final do
+	// vetor, e a partir do seu começo). As identificações são reservadas de uma só vez: somente o final de
+	// um bloco do alocador divide a reserva.
+	int preenchidas = 0;
+	while (preenchidas < livres)
+	{
+		int quantidade = livres - preenchidas;
+		int64_t base = reservarIds(ids, &quantidade);
+		while (quantidade > 0)
+		{
+			int posicao = fila->fim + preenchidas < TAM_MAX_FILA ? fila->fim + preenchidas : fila->fim + preenchidas - TAM_MAX_FILA;
+			int trecho = TAM_MAX_FILA - posicao < quantidade ? TAM_MAX_FILA - posicao : quantidade;
+			preencherTrecho(&fila->itens[posicao], trecho, base, gerador);
+			base += trecho;
+			preenchidas += trecho;
+			quantidade -= trecho;
+		}
+	}
+
+	// Com a fila cheia, o fim coincide com o início.
+	fila->fim = fila->inicio;
+	fila->total = TAM_MAX_FILA;
+
+	finalizarRastro("reabastecerFila");
+	return livres;
+}
+
+int sortearCodigoPeca(GeradorPecas* gerador)
+{
+	uint64_t posicao = gerador->contador++;
+	return gerador->ponderado ? codigoPonderado(gerador, posicao) : codigoNaPosicao(gerador->semente, posicao);
+}
+
+/// @brief Lógica de autoGeracao, com o gerador de peças opcional(NULL: gerarPeca).
+static bool efetuarAutoGeracao(Fila* fila, AlocadorIds* ids, GeradorPecas* gerador, Peca* gerada)
+{
+	int64_t inicio = iniciarMedicao();
+	iniciarRastro("autoGeracao");
+
+	// A fila é verificada antes da geração: uma peça só é criada se houver espaço,
+	// e nenhuma identificação(nem posição do gerador) precisa ser devolvida.
+	if (filaCheia(fila))
+	{
+		finalizarMedicao(METRICA_AUTO_GERACAO, RESULTADO_FILA_CHEIA, inicio);
+		finalizarRastro("autoGeracao");
+		return false;
+	}
+
+	Peca peca;
+	if (gerador != NULL)
+	{
+		gerarPecas(&peca, 1, ids, gerador);
+	}
+	else
+	{
+		peca = gerarPeca(ids);
+	}
+	enqueue(fila, peca);
+	if (gerada != NULL)
+	{
+		*gerada = peca;
+	}
+
+	finalizarMedicao(METRICA_AUTO_GERACAO, RESULTADO_SUCESSO, inicio);
+	finalizarRastro("autoGeracao");
+	return true;
+}
+
+bool autoGeracao(Fila* fila, AlocadorIds* ids, Peca* gerada)
+{
+	return efetuarAutoGeracao(fila, ids, NULL, gerada);
+}
+
+static bool reporPeca(Sessao* sessao, Peca* gerada)
+{
+	return efetuarAutoGeracao(&sessao->fila, &sessao->ids, sessao->gerador, gerada);
+}
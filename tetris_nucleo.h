@@ -0,0 +1,295 @@
+#ifndef TETRIS_NUCLEO_H
+#define TETRIS_NUCLEO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_fixas.h"
+#include "tetris_pontuacao.h"
+
+// Desafio Tetris Stack
+// Núcleo da lógica de fila e pilha, sem nenhuma saída de console.
+// As interfaces (menu interativo, modo tempo real, etc.) consultam o resultado
+// de cada ação e decidem como apresentá-lo ao jogador.
+
+// **** Definições de constantes. ****
+
+/// @brief Tamanho reservado para o máximo de elementos na fila.
+#define TAM_MAX_FILA 5
+
+/// @brief Tamanho reservado para o máximo de elementos na pilha.
+#define TAM_MAX_PILHA 3
+
+/// @brief Tipos de peça, indexados pelo código do tipo(de 0 a 3).
+#define TIPOS_PECA "IOTL"
+
+/// @brief Quantidade de tipos de peça.
+#define TOTAL_TIPOS_PECA 4
+
+/// @brief Quantidade de peças sorteadas a partir de cada número de 64 bits do gerador em lote(2 bits por peça).
+#define PECAS_POR_BLOCO_GERADOR 32
+
+/// @brief Quantidade de identificações reservadas do contador global a cada vez, por alocador.
+#define TAM_BLOCO_IDS 65536
+
+// **** Declarações de estruturas. ****
+
+/// @brief Define uma struct chamada Peca(alias), com os campos: tipo (char) e id (int64_t).
+typedef struct
+{
+	/// @brief Caractere que representa o tipo da peça('I', 'O', 'T', 'L').
+	char tipo;
+	/// @brief Número inteiro único que representa a ordem de criação da peça.
+	int64_t id;
+} Peca;
+/// @brief Define uma struct com um alias Fila, para uma fila circular com capacidade de TAM_MAX_FILA.
+/// Especializada em tempo de compilação(ver tetris_fixas.h): avancarFila e posicaoFila.
+DEFINIR_FILA_FIXA(Fila, TAM_MAX_FILA)
+/// @brief Define uma struct com um alias Pilha, para uma pilha com capacidade de TAM_MAX_PILHA.
+DEFINIR_PILHA_FIXA(Pilha, TAM_MAX_PILHA)
+
+/// @brief Estado do gerador de peças em lote. Baseado em contador: o tipo da peça de posição k
+/// depende somente da semente, de k e da distribuição, e a sequência não muda com o tamanho dos lotes.
+typedef struct {
+	uint64_t semente;
+	/// @brief Posição da próxima peça na sequência.
+	uint64_t contador;
+	/// @brief Indica uma distribuição ponderada dos tipos(definirPesosGerador). Caso contrário, uniforme.
+	bool ponderado;
+	/// @brief Pesos da distribuição ponderada(zeros, se uniforme), gravados nos quadros-chave da revisão.
+	uint16_t pesos[TOTAL_TIPOS_PECA];
+	/// @brief Tabela de aliases(método de Walker), indexada pelo código do tipo: o código sorteado é mantido
+	/// se a parte alta do número sorteado for menor que o limiar(de 0 a 2^32). Caso contrário, vira o alias.
+	uint8_t aliases[TOTAL_TIPOS_PECA];
+	uint64_t limiares[TOTAL_TIPOS_PECA];
+} GeradorPecas;
+
+/// @brief Alocador de identificações únicas das peças(fragmento do contador global).
+/// Cada sessão(ou thread) possui o seu próprio alocador, e reserva blocos de TAM_BLOCO_IDS identificações
+/// do contador global com uma única operação atômica. As identificações são únicas em todo o processo,
+/// e crescentes dentro de cada alocador, mas não necessariamente consecutivas entre blocos.
+typedef struct {
+	/// @brief Próxima identificação do bloco reservado.
+	int64_t proximo;
+	/// @brief Fim(exclusivo) do bloco reservado.
+	int64_t limite;
+	/// @brief Quantidade de identificações emitidas por este alocador.
+	int64_t emitidos;
+} AlocadorIds;
+
+/// @brief Agrupa todo o estado de uma partida do nível Mestre.
+typedef struct {
+	Fila fila;
+	/// @brief Pilha reserva.
+	Pilha pilha;
+	/// @brief Alocador das identificações únicas das peças da sessão.
+	AlocadorIds ids;
+	/// @brief Pontuação, atualizada a cada peça colocada(jogar e usar).
+	Pontuacao pontuacao;
+	/// @brief Flag informativa de troca de grupos de peças(ver acaoTrocarPecasReservadas).
+	bool trocou;
+	/// @brief Gerador de peças em lote, opcional. Se NULL, as peças são aleatórias(gerarPeca, via rand).
+	GeradorPecas* gerador;
+} Sessao;
+
+/// @brief Códigos das ações, iguais às opções do menu principal.
+typedef enum {
+	ACAO_SAIR = 0,
+	ACAO_JOGAR_PECA = 1,
+	ACAO_RESERVAR_PECA = 2,
+	ACAO_USAR_PECA_RESERVADA = 3,
+	ACAO_TROCAR_PECA_RESERVADA = 4,
+	ACAO_TROCAR_PECAS_RESERVADAS = 5,
+	TOTAL_ACOES
+} CodigoAcao;
+
+/// @brief Resultado de uma ação. Qualquer valor diferente de RESULTADO_SUCESSO indica
+/// que a ação foi abortada, e o estado da sessão permanece inalterado.
+typedef enum {
+	RESULTADO_SUCESSO = 0,
+	RESULTADO_FILA_VAZIA,
+	RESULTADO_FILA_CHEIA,
+	RESULTADO_PILHA_VAZIA,
+	RESULTADO_PILHA_CHEIA,
+	/// @brief A pilha ou a fila ainda não possuem peças para a troca em grupo.
+	RESULTADO_PECAS_INSUFICIENTES,
+	RESULTADO_ACAO_INVALIDA,
+	TOTAL_RESULTADOS
+} ResultadoAcao;
+
+/// @brief Detalhes opcionais de uma ação efetuada, para exibição(log) pelas interfaces.
+typedef struct {
+	/// @brief Peça removida da fila ou da pilha(jogar, reservar e usar).
+	Peca removida;
+	/// @brief Indica se uma nova peça foi gerada para repor a fila.
+	bool reposta;
+	/// @brief Nova peça inserida no final da fila, se houver reposição.
+	Peca gerada;
+	/// @brief Total de pares trocados entre a fila e a pilha.
+	int totalTrocas;
+	/// @brief Pontos ganhos pela ação(somente jogar e usar).
+	int32_t pontos;
+	/// @brief Peças movidas da fila para a pilha, na ordem das trocas.
+	Peca paraPilha[TAM_MAX_PILHA];
+	/// @brief Peças movidas da pilha para a fila, na ordem das trocas.
+	Peca paraFila[TAM_MAX_PILHA];
+} RegistroAcao;
+
+// **** Declarações das funções. ****
+
+// **** Funções de Lógica Principal ****
+
+/// @brief Inicializa a sessão, com a fila totalmente populada e a pilha vazia.
+/// @param Sessao. Ponteiro via referência, para efetuar a inicialização.
+void inicializarSessao(Sessao* sessao);
+/// @brief Inicializa a sessão, com a fila totalmente populada pelo gerador informado e a pilha vazia.
+/// Toda reposição da sessão usará o mesmo gerador, tornando a partida determinística pela semente.
+/// @param Sessao. Ponteiro via referência, para efetuar a inicialização.
+/// @param GeradorPecas. Ponteiro via referência, do gerador. Deve permanecer válido durante a sessão.
+void inicializarSessaoComGerador(Sessao* sessao, GeradorPecas* gerador);
+/// @brief Aplica uma ação à sessão, conforme o código da opção do menu.
+/// @param Sessao. Ponteiro via referência, para aplicar a ação.
+/// @param CodigoAcao. Ação a ser aplicada.
+/// @param RegistroAcao. Ponteiro opcional(pode ser NULL), para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao aplicarAcao(Sessao* sessao, CodigoAcao acao, RegistroAcao* registro);
+/// @brief Remove a peça da frente da fila e repõe automaticamente uma nova peça.
+/// @param Sessao. Ponteiro via referência, para aplicar a ação.
+/// @param RegistroAcao. Ponteiro opcional(pode ser NULL), para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao jogarPeca(Sessao* sessao, RegistroAcao* registro);
+/// @brief Move a peça da frente da fila para a pilha e repõe automaticamente uma nova peça.
+/// @param Sessao. Ponteiro via referência, para aplicar a ação.
+/// @param RegistroAcao. Ponteiro opcional(pode ser NULL), para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao reservarPeca(Sessao* sessao, RegistroAcao* registro);
+/// @brief Remove a peça do topo da pilha.
+/// @param Sessao. Ponteiro via referência, para aplicar a ação.
+/// @param RegistroAcao. Ponteiro opcional(pode ser NULL), para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao usarPecaReservada(Sessao* sessao, RegistroAcao* registro);
+/// @brief Troca a peça da frente da fila com a peça do topo da pilha.
+/// @param Sessao. Ponteiro via referência, para aplicar a ação.
+/// @param RegistroAcao. Ponteiro opcional(pode ser NULL), para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao trocarPecaReservada(Sessao* sessao, RegistroAcao* registro);
+/// @brief Troca as 3 primeiras peças da fila com as 3 peças da pilha.
+/// @param Sessao. Ponteiro via referência, para aplicar a ação.
+/// @param RegistroAcao. Ponteiro opcional(pode ser NULL), para conter os detalhes da ação.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento.
+ResultadoAcao trocarPecasReservadas(Sessao* sessao, RegistroAcao* registro);
+/// @brief Descreve o resultado de uma ação, para exibição.
+/// @param ResultadoAcao. Resultado a ser descrito.
+/// @returns Texto constante, com a descrição do resultado.
+const char* descreverResultado(ResultadoAcao resultado);
+/// @brief Recupera um nome curto e estável do resultado, para formatos legíveis por máquina. Ex: "fila_vazia".
+/// @param ResultadoAcao. Resultado a ser nomeado.
+/// @returns Texto constante, com o nome do resultado.
+const char* nomeResultado(ResultadoAcao resultado);
+
+/// @brief Inicializa a fila. Baseado no conteúdo da plataforma.
+/// @param Fila. Ponteiro via referência, para efetuar a inicialização.
+void inicializarFila(Fila* fila);
+/// @brief Verifica se a fila está cheia. Baseado no conteúdo da plataforma.
+/// @param Fila. Ponteiro usado para efetuar a verificação. Somente leitura.
+/// @returns Verdadeiro(true) se a fila está cheia. Caso contrário, Falso(false).
+bool filaCheia(const Fila* fila);
+/// @brief Verifica se a fila está vazia. Baseado no conteúdo da plataforma.
+/// @param Fila. Ponteiro usado para efetuar a verificação. Somente leitura.
+/// @returns Verdadeiro(true) se a fila está vazia. Caso contrário, Falso(false).
+bool filaVazia(const Fila* fila);
+/// @brief Enfileira(ou sobrescreve) o elemento se houver alocações disponíveis na fila. Baseado no conteúdo da plataforma.
+/// @param Fila. Ponteiro via referência, usado no enfileiramento.
+/// @param Peca. Elemento a ser enfileirado.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool enqueue(Fila* f, Peca p);
+/// @brief Marca para sobrescrever(desenfileirar) o primeiro elemento de acordo com a ordem atual da fila.
+/// Baseado no conteúdo da plataforma.
+/// @param Fila. Ponteiro via referência, usado no desenfileiramento.
+/// @returns Peca. Ponteiro a conter o elemento desenfileirado, ou NULL se a fila estiver vazia.
+Peca* dequeue(Fila* fila);
+/// @brief Verifica e enfileira totalmente se necessário com novos elementos a fila em questão.
+/// @param Fila. Ponteiro via referência, a ser usado para efetuar o enfileiramento.
+/// @param AlocadorIds. Ponteiro via referência, do alocador das identificações únicas.
+void popularFila(Fila* fila, AlocadorIds* ids);
+/// @brief Cria aleatoriamente um novo elemento do tipo Peca, para uso posterior.
+/// @param AlocadorIds. Ponteiro via referência, do alocador das identificações únicas.
+/// @returns Peca. Conforme as especificações.
+Peca gerarPeca(AlocadorIds* ids);
+/// @brief Inicializa o alocador de identificações. O primeiro bloco é reservado na primeira alocação.
+/// @param AlocadorIds. Ponteiro via referência, para efetuar a inicialização.
+void inicializarAlocadorIds(AlocadorIds* ids);
+/// @brief Aloca uma identificação única de peça. Somente a reserva de um novo bloco acessa o contador global.
+/// @param AlocadorIds. Ponteiro via referência, do alocador.
+/// @returns Inteiro. Identificação única(a partir de 1).
+int64_t alocarIdPeca(AlocadorIds* ids);
+/// @brief Inicializa o gerador de peças em lote.
+/// @param GeradorPecas. Ponteiro via referência, para efetuar a inicialização.
+/// @param Inteiro. Semente da sequência.
+void inicializarGerador(GeradorPecas* gerador, uint64_t semente);
+/// @brief Define a distribuição dos tipos de peça do gerador, montando a sua tabela de aliases.
+/// O sorteio de cada peça custa um número aleatório, uma leitura da tabela e uma comparação, para qualquer
+/// distribuição. A posição do gerador é mantida: a distribuição pode ser trocada no meio da sessão.
+/// @param GeradorPecas. Ponteiro via referência, do gerador.
+/// @param Inteiro. Vetor com o peso de cada tipo, indexado pelo código(ordem de TIPOS_PECA). Ex: { 4, 1, 2, 2 }.
+/// Ou NULL, para a distribuição uniforme(mesma sequência de um gerador recém-inicializado).
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se todos os pesos forem zero(gerador inalterado).
+bool definirPesosGerador(GeradorPecas* gerador, const uint16_t pesos[TOTAL_TIPOS_PECA]);
+/// @brief Cria em lote novos elementos do tipo Peca, com identificações crescentes do alocador.
+/// Os tipos vêm do gerador baseado em contador(GeradorPecas), e não de rand() como em gerarPeca: as duas
+/// sequências diferem. É a mesma sequência de sortearCodigoPeca, e não depende do tamanho dos lotes.
+/// @param Peca. Vetor de destino, com espaço para a quantidade solicitada.
+/// @param Inteiro. Quantidade de peças a serem criadas.
+/// @param AlocadorIds. Ponteiro via referência, do alocador das identificações únicas.
+/// @param GeradorPecas. Ponteiro via referência, com o estado do gerador.
+void gerarPecas(Peca* destino, int quantidade, AlocadorIds* ids, GeradorPecas* gerador);
+/// @brief Completa a fila em uma única operação: as posições livres são preenchidas diretamente(no máximo
+/// dois trechos contíguos do vetor circular), com as identificações reservadas de uma só vez. Sem gerador,
+/// os tipos e as identificações são os de repetidas chamadas de gerarPeca(rand); com gerador, os de gerarPecas
+/// (a sequência de sortearCodigoPeca). Propositalmente, não registra as métricas nem o rastro de autoGeracao
+/// por peça(somente um trecho "reabastecerFila" no rastro): METRICA_AUTO_GERACAO não conta os reinícios de sessão.
+/// @param Fila. Ponteiro via referência, da fila a ser completada.
+/// @param AlocadorIds. Ponteiro via referência, do alocador das identificações únicas.
+/// @param GeradorPecas. Ponteiro via referência, do gerador em lote. Ou NULL, para tipos aleatórios(via rand).
+/// @returns Inteiro. Quantidade de peças inseridas(zero, se a fila já estava cheia).
+int reabastecerFila(Fila* fila, AlocadorIds* ids, GeradorPecas* gerador);
+/// @brief Sorteia o tipo da próxima peça do gerador em lote, avançando-o em uma posição.
+/// Mesma sequência de tipos de gerarPecas.
+/// @param GeradorPecas. Ponteiro via referência, com o estado do gerador.
+/// @returns Inteiro. Código do tipo(de 0 a 3), índice em TIPOS_PECA.
+int sortearCodigoPeca(GeradorPecas* gerador);
+/// @brief Efetua a tentativa de criar automaticamente um novo elemento do tipo Peca na fila,
+/// além de efetuar controle e verificação de identificação única.
+/// @param Fila. Ponteiro via referência, usado no enfileiramento.
+/// @param AlocadorIds. Ponteiro via referência, do alocador das identificações únicas.
+/// @param Peca. Ponteiro opcional(pode ser NULL), para conter a peça gerada.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool autoGeracao(Fila* fila, AlocadorIds* ids, Peca* gerada);
+/// @brief Inicializa a pilha. Baseado no conteúdo da plataforma.
+/// @param Pilha. Ponteiro via referência, para efetuar a inicialização.
+void inicializarPilha(Pilha* p);
+/// @brief Insere(ou sobrescreve) o elemento se houver alocações disponíveis na pilha.
+/// Baseado no conteúdo da plataforma.
+/// @param Pilha. Ponteiro via referência, usado na inserção.
+/// @param Peca. Elemento a ser inserido.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool push(Pilha* pilha, Peca peca);
+/// @brief Marca para sobrescrever(remover) o primeiro elemento de acordo com a ordem atual da pilha.
+/// Baseado no conteúdo da plataforma.
+/// @param Pilha. Ponteiro via referência, usado na remoção.
+/// @returns Peca. Ponteiro a conter o elemento removido, ou NULL se a pilha estiver vazia.
+Peca* pop(Pilha* p);
+/// @brief Recupera o primeiro elemento de acordo com a ordem atual da pilha, apenas para espiar.
+/// Baseado no conteúdo da plataforma.
+/// @param Pilha. Ponteiro usado na recuperação. Somente leitura.
+/// @returns Peca. Ponteiro a conter o elemento recuperado, ou NULL se a pilha estiver vazia.
+const Peca* peek(const Pilha* p);
+/// @brief Verifica se a pilha está cheia. Baseado no conteúdo da plataforma.
+/// @param Pilha. Ponteiro usado para efetuar a verificação. Somente leitura.
+/// @returns Verdadeiro(true) se a pilha está cheia. Caso contrário, Falso(false).
+bool pilhaCheia(const Pilha* p);
+/// @brief Verifica se a pilha está vazia. Baseado no conteúdo da plataforma.
+/// @param Pilha. Ponteiro usado para efetuar a verificação. Somente leitura.
+/// @returns Verdadeiro(true) se a pilha está vazia. Caso contrário, Falso(false).
+bool pilhaVazia(const Pilha* p);
+
+#endif // TETRIS_NUCLEO_H
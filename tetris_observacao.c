@@ -0,0 +1,206 @@
+#include <string.h>
+#include "tetris_observacao.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// **** Definições de constantes. ****
+
+/// @brief Assinatura do arquivo da região.
+static const char assinaturaObservacao[8] = { 'T', 'T', 'R', 'O', 'B', 'S', 0, 0 };
+
+// **** Implementações das funções. ****
+
+/// @brief Calcula o tamanho do arquivo de uma região com a quantidade de slots informada.
+static size_t calcularTamanhoRegiao(int totalSlots)
+{
+	return sizeof(CabecalhoObservacao) + (size_t)totalSlots * sizeof(SlotObservacao);
+}
+
+/// @brief Preenche os ponteiros da região a partir do endereço base mapeado.
+static void associarRegiao(RegiaoObservacao* regiao, void* base, size_t tamanho)
+{
+	regiao->base = base;
+	regiao->tamanho = tamanho;
+	regiao->cabecalho = (CabecalhoObservacao*)base;
+	regiao->slots = (SlotObservacao*)((char*)base + sizeof(CabecalhoObservacao));
+	regiao->totalSlots = (int)regiao->cabecalho->totalSlots;
+}
+
+#ifdef _WIN32
+// Plataforma Windows: a região depende do mmap(POSIX).
+
+bool criarRegiaoObservacao(RegiaoObservacao* regiao, const char* caminho, int totalSlots)
+{
+	memset(regiao, 0, sizeof(*regiao));
+	return false;
+}
+
+bool abrirRegiaoObservacao(RegiaoObservacao* regiao, const char* caminho)
+{
+	memset(regiao, 0, sizeof(*regiao));
+	return false;
+}
+
+void fecharRegiaoObservacao(RegiaoObservacao* regiao)
+{
+}
+
+#else
+
+bool criarRegiaoObservacao(RegiaoObservacao* regiao, const char* caminho, int totalSlots)
+{
+	memset(regiao, 0, sizeof(*regiao));
+	if (totalSlots <= 0)
+	{
+		return false;
+	}
+
+	int descritor = open(caminho, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (descritor < 0)
+	{
+		return false;
+	}
+
+	// O arquivo recém-truncado é estendido com zeros: todos os slots começam vazios(passo zero).
+	size_t tamanho = calcularTamanhoRegiao(totalSlots);
+	void* base = MAP_FAILED;
+	if (ftruncate(descritor, (off_t)tamanho) == 0)
+	{
+		base = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, descritor, 0);
+	}
+	close(descritor);
+	if (base == MAP_FAILED)
+	{
+		return false;
+	}
+
+	CabecalhoObservacao* cabecalho = (CabecalhoObservacao*)base;
+	cabecalho->versao = VERSAO_OBSERVACAO;
+	cabecalho->totalSlots = (uint32_t)totalSlots;
+	cabecalho->tamanhoSlot = (uint32_t)sizeof(SlotObservacao);
+	// A assinatura por último: um leitor não aceita a região antes do cabeçalho completo.
+	atomic_thread_fence(memory_order_release);
+	memcpy(cabecalho->assinatura, assinaturaObservacao, sizeof(assinaturaObservacao));
+
+	associarRegiao(regiao, base, tamanho);
+	return true;
+}
+
+bool abrirRegiaoObservacao(RegiaoObservacao* regiao, const char* caminho)
+{
+	memset(regiao, 0, sizeof(*regiao));
+
+	int descritor = open(caminho, O_RDONLY);
+	if (descritor < 0)
+	{
+		return false;
+	}
+
+	struct stat informacoes;
+	void* base = MAP_FAILED;
+	if (fstat(descritor, &informacoes) == 0 && (size_t)informacoes.st_size >= sizeof(CabecalhoObservacao))
+	{
+		base = mmap(NULL, (size_t)informacoes.st_size, PROT_READ, MAP_SHARED, descritor, 0);
+	}
+	close(descritor);
+	if (base == MAP_FAILED)
+	{
+		return false;
+	}
+
+	size_t tamanho = (size_t)informacoes.st_size;
+	const CabecalhoObservacao* cabecalho = (const CabecalhoObservacao*)base;
+	if (memcmp(cabecalho->assinatura, assinaturaObservacao, sizeof(assinaturaObservacao)) != 0
+		|| cabecalho->versao != VERSAO_OBSERVACAO || cabecalho->tamanhoSlot != sizeof(SlotObservacao)
+		|| calcularTamanhoRegiao((int)cabecalho->totalSlots) > tamanho)
+	{
+		munmap(base, tamanho);
+		return false;
+	}
+
+	associarRegiao(regiao, base, tamanho);
+	return true;
+}
+
+void fecharRegiaoObservacao(RegiaoObservacao* regiao)
+{
+	if (regiao->base != NULL)
+	{
+		munmap(regiao->base, regiao->tamanho);
+	}
+	memset(regiao, 0, sizeof(*regiao));
+}
+
+#endif
+
+void publicarObservacao(RegiaoObservacao* regiao, int slot, const Sessao* sessao, CodigoAcao ultimaAcao)
+{
+	if (slot < 0 || slot >= regiao->totalSlots)
+	{
+		return;
+	}
+
+	SlotObservacao* destino = &regiao->slots[slot];
+
+	// A observação é montada fora da seção de escrita, que se resume a uma única cópia.
+	Observacao observacao;
+	memset(&observacao, 0, sizeof(observacao));
+	observacao.passo = destino->observacao.passo + 1;
+	observacao.geradas = sessao->ids.emitidos;
+	observacao.pontos = sessao->pontuacao.pontos;
+	observacao.linhas = sessao->pontuacao.linhas;
+	observacao.nivel = sessao->pontuacao.nivel;
+	observacao.combo = sessao->pontuacao.combo;
+	observacao.totalFila = (uint8_t)sessao->fila.total;
+	observacao.totalPilha = (uint8_t)(sessao->pilha.topo + 1);
+	observacao.ultimaAcao = (uint8_t)ultimaAcao;
+	for (int i = 0, idx = sessao->fila.inicio; i < sessao->fila.total; i++, idx = avancarFila(idx))
+	{
+		observacao.fila[i].id = sessao->fila.itens[idx].id;
+		observacao.fila[i].tipo = sessao->fila.itens[idx].tipo;
+	}
+	for (int i = 0; i <= sessao->pilha.topo; i++)
+	{
+		observacao.pilha[i].id = sessao->pilha.itens[i].id;
+		observacao.pilha[i].tipo = sessao->pilha.itens[i].tipo;
+	}
+
+	// Seqlock: versão ímpar durante a escrita. Um único escritor por slot.
+	uint32_t versao = atomic_load_explicit(&destino->versao, memory_order_relaxed);
+	atomic_store_explicit(&destino->versao, versao + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	memcpy(&destino->observacao, &observacao, sizeof(observacao));
+	atomic_store_explicit(&destino->versao, versao + 2, memory_order_release);
+}
+
+bool lerObservacao(const RegiaoObservacao* regiao, int slot, Observacao* destino)
+{
+	if (slot < 0 || slot >= regiao->totalSlots)
+	{
+		return false;
+	}
+
+	SlotObservacao* origem = &regiao->slots[slot];
+
+	for (int tentativa = 0; tentativa < TENTATIVAS_MAX_LEITURA; tentativa++)
+	{
+		uint32_t inicio = atomic_load_explicit(&origem->versao, memory_order_acquire);
+		if (inicio & 1)
+		{
+			continue; // Escrita em andamento.
+		}
+
+		memcpy(destino, &origem->observacao, sizeof(*destino));
+		atomic_thread_fence(memory_order_acquire);
+
+		if (atomic_load_explicit(&origem->versao, memory_order_relaxed) == inicio)
+		{
+			return true;
+		}
+	}
+	return false;
+}
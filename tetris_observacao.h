@@ -0,0 +1,115 @@
+#ifndef TETRIS_OBSERVACAO_H
+#define TETRIS_OBSERVACAO_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Região de observação em memória compartilhada(arquivo mapeado com mmap), para agentes externos.
+// Cada sessão publica o estado da fila e da pilha em um slot próprio, a cada passo, protegido por
+// um seqlock: o contador de versão fica ímpar durante a escrita. O leitor mapeia o mesmo arquivo
+// e lê os slots diretamente, sem chamadas de sistema por observação, repetindo a leitura se a
+// versão mudar no meio dela. Os campos têm tamanho fixo, para que o leiaute seja estável entre processos.
+
+// **** Definições de constantes. ****
+
+/// @brief Versão do leiaute da região, gravada no cabeçalho.
+#define VERSAO_OBSERVACAO 3
+
+/// @brief Alinhamento dos slots e do cabeçalho(linha de cache), para que escritores de slots
+/// diferentes não disputem a mesma linha.
+#define ALINHAMENTO_OBSERVACAO 64
+
+/// @brief Tentativas máximas de leitura de um slot. Um escritor encerrado no meio da publicação deixa a
+/// versão ímpar para sempre: a leitura desiste, em vez de repetir indefinidamente.
+#define TENTATIVAS_MAX_LEITURA (1 << 20)
+
+// **** Declarações de estruturas. ****
+
+/// @brief Peça no leiaute da região compartilhada.
+typedef struct {
+	int64_t id;
+	char tipo;
+	uint8_t reservado[7];
+} PecaObservada;
+
+/// @brief Estado de uma sessão no leiaute da região compartilhada.
+typedef struct {
+	/// @brief Total de publicações do slot. Zero, se a sessão ainda não publicou.
+	uint32_t passo;
+	uint8_t totalFila;
+	uint8_t totalPilha;
+	/// @brief Última ação aplicada(CodigoAcao), ou ACAO_SAIR na publicação inicial.
+	uint8_t ultimaAcao;
+	uint8_t reservado;
+	/// @brief Total de peças geradas na sessão.
+	int64_t geradas;
+	/// @brief Pontuação da sessão(ver tetris_pontuacao.h).
+	int64_t pontos;
+	int32_t linhas;
+	int16_t nivel;
+	int16_t combo;
+	/// @brief Peças da fila, da frente para o fim.
+	PecaObservada fila[TAM_MAX_FILA];
+	/// @brief Peças da pilha, da base para o topo.
+	PecaObservada pilha[TAM_MAX_PILHA];
+} Observacao;
+
+/// @brief Slot de uma sessão: o seqlock e a observação.
+typedef struct {
+	_Alignas(ALINHAMENTO_OBSERVACAO) _Atomic uint32_t versao;
+	Observacao observacao;
+} SlotObservacao;
+
+/// @brief Cabeçalho da região, no início do arquivo.
+typedef struct {
+	_Alignas(ALINHAMENTO_OBSERVACAO) char assinatura[8];
+	uint32_t versao;
+	uint32_t totalSlots;
+	/// @brief Tamanho de cada slot, para validação pelo leitor.
+	uint32_t tamanhoSlot;
+} CabecalhoObservacao;
+
+/// @brief Região mapeada, do lado do escritor ou do leitor.
+typedef struct {
+	void* base;
+	size_t tamanho;
+	CabecalhoObservacao* cabecalho;
+	SlotObservacao* slots;
+	int totalSlots;
+} RegiaoObservacao;
+
+// **** Declarações das funções. ****
+
+/// @brief Cria(ou recria) o arquivo da região e o mapeia para escrita, com todos os slots vazios.
+/// @param RegiaoObservacao. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Caminho do arquivo. Ex: /dev/shm/tetris.obs.
+/// @param Inteiro. Quantidade de slots(sessões).
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário(ou se a plataforma não for suportada), Falso(false).
+bool criarRegiaoObservacao(RegiaoObservacao* regiao, const char* caminho, int totalSlots);
+/// @brief Mapeia, somente para leitura, uma região criada por outro processo.
+/// @param RegiaoObservacao. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Caminho do arquivo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o arquivo não existir ou for inválido.
+bool abrirRegiaoObservacao(RegiaoObservacao* regiao, const char* caminho);
+/// @brief Publica o estado atual de uma sessão no seu slot.
+/// @param RegiaoObservacao. Ponteiro via referência, usado na publicação.
+/// @param Inteiro. Índice do slot da sessão.
+/// @param Sessao. Ponteiro da sessão publicada. Somente leitura.
+/// @param CodigoAcao. Última ação aplicada à sessão.
+void publicarObservacao(RegiaoObservacao* regiao, int slot, const Sessao* sessao, CodigoAcao ultimaAcao);
+/// @brief Lê uma observação consistente de um slot, repetindo a leitura enquanto houver escrita concorrente.
+/// @param RegiaoObservacao. Ponteiro usado na leitura. Somente leitura.
+/// @param Inteiro. Índice do slot.
+/// @param Observacao. Ponteiro via referência, para conter a observação lida.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o slot não existir, ou se não houver
+/// leitura consistente em TENTATIVAS_MAX_LEITURA tentativas.
+bool lerObservacao(const RegiaoObservacao* regiao, int slot, Observacao* destino);
+/// @brief Desfaz o mapeamento da região. O arquivo é mantido, para os demais processos.
+/// @param RegiaoObservacao. Ponteiro via referência, a ser finalizado.
+void fecharRegiaoObservacao(RegiaoObservacao* regiao);
+
+#endif // TETRIS_OBSERVACAO_H
@@ -0,0 +1,241 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+// Se estivermos no windows, vamos incluir usar uma saída de console com padrão adequado para utf-8.
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include "tetris_nucleo.h"
+#include "tetris_tempo.h"
+#include "tetris_transicoes.h"
+
+// Desafio Tetris Stack
+// Enumeração da árvore de ações(perft, como nos motores de xadrez): a partir de um estado inicial com
+// semente fixa, aplica todas as sequências de ações do nível Mestre(jogar, reservar, usar, trocar 1 e
+// trocar 3) até a profundidade informada, e conta as folhas. Uma ação é legal se for efetuada com
+// sucesso(as ações canceladas, ex: pilha cheia ou vazia, não geram nós).
+//
+// As contagens e a assinatura das folhas(soma dos resumos dos estados: tipos da fila e da pilha, e flag
+// de troca) dependem somente da semente e da profundidade: servem de referência para validar otimizações
+// das estruturas, e a taxa de nós por segundo mede as transições de estado do núcleo. Com --tabela, a
+// enumeração usa a tabela de transições(tetris_transicoes.h), e deve chegar às mesmas contagens e assinaturas.
+
+// **** Definições de constantes. ****
+
+/// @brief Valores padrão das opções.
+#define PROFUNDIDADE_PADRAO 12
+#define SEMENTE_PADRAO 1
+
+/// @brief Profundidade máxima aceita.
+#define PROFUNDIDADE_MAXIMA 32
+
+// **** Declarações de estruturas. ****
+
+/// @brief Nó da enumeração: a sessão e o seu gerador de peças, copiados juntos a cada ação(copia e aplica).
+typedef struct {
+	Sessao sessao;
+	GeradorPecas gerador;
+} NoPerft;
+
+/// @brief Nó da enumeração pela tabela de transições: o índice do estado e o gerador de peças.
+typedef struct {
+	int32_t estado;
+	GeradorPecas gerador;
+} NoTabela;
+
+/// @brief Totais de uma enumeração.
+typedef struct {
+	uint64_t folhas;
+	/// @brief Soma dos resumos dos estados das folhas(independente da ordem).
+	uint64_t assinatura;
+} TotaisPerft;
+
+// **** Declarações das funções. ****
+
+/// @brief Enumera as sequências de ações a partir de um nó, até a profundidade informada.
+/// @param NoPerft. Ponteiro do nó de origem. Somente leitura.
+/// @param Inteiro. Profundidade restante.
+/// @param TotaisPerft. Ponteiro via referência, com os totais a acumular.
+void enumerarAcoes(const NoPerft* no, int profundidade, TotaisPerft* totais);
+/// @brief Enumera as sequências de ações a partir de um nó, pela tabela de transições.
+/// @param TabelaTransicoes. Ponteiro da tabela. Somente leitura.
+/// @param NoTabela. Ponteiro do nó de origem. Somente leitura.
+/// @param Inteiro. Profundidade restante.
+/// @param TotaisPerft. Ponteiro via referência, com os totais a acumular.
+void enumerarAcoesTabela(const TabelaTransicoes* tabela, const NoTabela* no, int profundidade, TotaisPerft* totais);
+/// @brief Calcula o resumo de um estado(as identificações das peças e a pontuação não participam).
+/// @param Inteiro. Índice do estado(ver indexarEstado).
+/// @returns Inteiro. Resumo de 64 bits.
+uint64_t resumirEstado(int32_t estado);
+
+/// @brief Ponto de entrada do programa.
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: --profundidade N, --semente N, --tabela.
+/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, em caso de falha. Ex: EXIT_FAILURE.
+int main(int argc, char* argv[]);
+
+// **** Implementações das funções. ****
+
+int main(int argc, char* argv[]) {
+
+	// Configurações de caracteres para ajuste de ortografia para saída do console(UTF-8).
+#ifdef _WIN32
+	// Plataforma Windows.
+	SetConsoleOutputCP(CP_UTF8);
+#endif
+
+	int profundidade = PROFUNDIDADE_PADRAO;
+	uint64_t semente = SEMENTE_PADRAO;
+	bool usarTabela = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--profundidade") == 0 && i + 1 < argc
+			&& atoi(argv[i + 1]) > 0 && atoi(argv[i + 1]) <= PROFUNDIDADE_MAXIMA)
+		{
+			profundidade = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc)
+		{
+			semente = strtoull(argv[++i], NULL, 10);
+			continue;
+		}
+		if (strcmp(argv[i], "--tabela") == 0)
+		{
+			usarTabela = true;
+			continue;
+		}
+		printf("Uso: %s [--profundidade N] [--semente N] [--tabela]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	NoPerft raiz;
+	inicializarGerador(&raiz.gerador, semente);
+	inicializarSessaoComGerador(&raiz.sessao, &raiz.gerador);
+
+	TabelaTransicoes tabela = { NULL };
+	NoTabela raizTabela = { indexarEstado(&raiz.sessao), raiz.gerador };
+	if (usarTabela)
+	{
+		int64_t inicioNs = relogioMonotonicoNs();
+		if (!gerarTabelaTransicoes(&tabela))
+		{
+			printf("\n==== ⚠️  Memória insuficiente para a tabela de transições. ====\n");
+			return EXIT_FAILURE;
+		}
+		printf("Tabela de transições: %d estados, gerada em %.3f s.\n", TOTAL_ESTADOS,
+			(relogioMonotonicoNs() - inicioNs) / 1e9);
+	}
+
+	printf("==== Perft%s: semente %" PRIu64 ", profundidade %d. ====\n", usarTabela ? " pela tabela" : "",
+		semente, profundidade);
+	printf("%12s %16s %18s %10s %14s\n", "Profundidade", "Folhas", "Assinatura", "Tempo(s)", "Nós/s");
+	fflush(stdout);
+
+	// Os nós internos também são visitados: a taxa considera todos os nós da árvore até a profundidade.
+	uint64_t nos = 1;
+	for (int p = 1; p <= profundidade; p++)
+	{
+		TotaisPerft totais = { 0, 0 };
+		int64_t inicioNs = relogioMonotonicoNs();
+		if (usarTabela)
+		{
+			enumerarAcoesTabela(&tabela, &raizTabela, p, &totais);
+		}
+		else
+		{
+			enumerarAcoes(&raiz, p, &totais);
+		}
+		int64_t duracaoNs = relogioMonotonicoNs() - inicioNs;
+
+		nos += totais.folhas;
+		printf("%12d %16" PRIu64 " 0x%016" PRIx64 " %10.3f %14.0f\n", p, totais.folhas, totais.assinatura,
+			duracaoNs / 1e9, duracaoNs > 0 ? nos * 1e9 / duracaoNs : 0.0);
+		fflush(stdout);
+	}
+
+	// Divisão por ação inicial, para localizar divergências entre implementações.
+	printf("\n==== Divisão na profundidade %d ====\n", profundidade);
+	for (int acao = ACAO_JOGAR_PECA; acao < TOTAL_ACOES; acao++)
+	{
+		TotaisPerft totais = { 0, 0 };
+		if (usarTabela)
+		{
+			NoTabela filho = raizTabela;
+			int codigo = (acao == ACAO_JOGAR_PECA || acao == ACAO_RESERVAR_PECA) ? sortearCodigoPeca(&filho.gerador) : 0;
+			filho.estado = transicaoEstado(&tabela, raizTabela.estado, (CodigoAcao)acao, codigo);
+			if (filho.estado >= 0)
+			{
+				enumerarAcoesTabela(&tabela, &filho, profundidade - 1, &totais);
+			}
+		}
+		else
+		{
+			NoPerft filho = raiz;
+			filho.sessao.gerador = &filho.gerador;
+			if (aplicarAcao(&filho.sessao, (CodigoAcao)acao, NULL) == RESULTADO_SUCESSO)
+			{
+				enumerarAcoes(&filho, profundidade - 1, &totais);
+			}
+		}
+		printf("Ação %d: %" PRIu64 "\n", acao, totais.folhas);
+	}
+
+	liberarTabelaTransicoes(&tabela);
+	return EXIT_SUCCESS;
+}
+
+void enumerarAcoes(const NoPerft* no, int profundidade, TotaisPerft* totais)
+{
+	if (profundidade == 0)
+	{
+		totais->folhas++;
+		totais->assinatura += resumirEstado(indexarEstado(&no->sessao));
+		return;
+	}
+
+	for (int acao = ACAO_JOGAR_PECA; acao < TOTAL_ACOES; acao++)
+	{
+		// A sessão copiada passa a usar o gerador da cópia: as peças futuras seguem iguais em cada ramo.
+		NoPerft filho = *no;
+		filho.sessao.gerador = &filho.gerador;
+		if (aplicarAcao(&filho.sessao, (CodigoAcao)acao, NULL) == RESULTADO_SUCESSO)
+		{
+			enumerarAcoes(&filho, profundidade - 1, totais);
+		}
+	}
+}
+
+void enumerarAcoesTabela(const TabelaTransicoes* tabela, const NoTabela* no, int profundidade, TotaisPerft* totais)
+{
+	if (profundidade == 0)
+	{
+		totais->folhas++;
+		totais->assinatura += resumirEstado(no->estado);
+		return;
+	}
+
+	for (int acao = ACAO_JOGAR_PECA; acao < TOTAL_ACOES; acao++)
+	{
+		// Somente jogar e reservar consomem uma posição do gerador, como nas sessões.
+		NoTabela filho = *no;
+		int codigo = (acao == ACAO_JOGAR_PECA || acao == ACAO_RESERVAR_PECA) ? sortearCodigoPeca(&filho.gerador) : 0;
+		filho.estado = transicaoEstado(tabela, no->estado, (CodigoAcao)acao, codigo);
+		if (filho.estado >= 0)
+		{
+			enumerarAcoesTabela(tabela, &filho, profundidade - 1, totais);
+		}
+	}
+}
+
+uint64_t resumirEstado(int32_t estado)
+{
+	// Finalizador do splitmix64: o índice do estado já é único(hash perfeito).
+	uint64_t resumo = (uint64_t)estado + 0x9E3779B97F4A7C15ULL;
+	resumo = (resumo ^ (resumo >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	resumo = (resumo ^ (resumo >> 27)) * 0x94D049BB133111EBULL;
+	return resumo ^ (resumo >> 31);
+}
@@ -0,0 +1,70 @@
+#include "tetris_pontuacao.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Quadros entre os passos da gravidade, indexados por nível - 1(60 quadros por segundo).
+static const uint8_t quadrosGravidade[NIVEL_MAXIMO] = {
+	6, 6, 5, 5, 5, 4, 4, 4, 3, 3,
+	3, 3, 2, 2, 2, 2, 2, 1, 1, 1
+};
+
+/// @brief Pontos base de cada colocação, indexados por [linha][classe]: 0 simples, 1 peça 'I', 2 giro T.
+static const int32_t pontosColocacao[2][3] = {
+	{ 0, 0, PONTOS_GIRO_T },
+	{ PONTOS_LINHA, PONTOS_LINHA_DIFICIL, PONTOS_GIRO_T_LINHA }
+};
+
+// **** Implementações das funções. ****
+
+void inicializarPontuacao(Pontuacao* pontuacao)
+{
+	pontuacao->pontos = 0;
+	pontuacao->linhas = 0;
+	pontuacao->nivel = 1;
+	pontuacao->combo = -1;
+	pontuacao->ultimoTipo = 0;
+	pontuacao->dificilAnterior = false;
+}
+
+int32_t pontuarColocacao(Pontuacao* pontuacao, char tipo, bool daReserva)
+{
+	// Sem desvios: o tipo das peças é imprevisível, e a atualização é consultada a cada passo pelos bots.
+	int linha = tipo == pontuacao->ultimoTipo;
+	int giroT = daReserva & (tipo == 'T');
+	int dificil = giroT | (tipo == 'I');
+
+	int32_t base = pontosColocacao[linha][2 * giroT + (tipo == 'I')];
+	// Costas com costas: somente entre linhas difíceis. Uma colocação sem linha não o desarma.
+	base += (base / 2) & -(int32_t)(linha & dificil & pontuacao->dificilAnterior);
+	pontuacao->dificilAnterior = linha ? dificil : pontuacao->dificilAnterior;
+
+	// Uma colocação sem linha encerra o combo(-1). Cada linha consecutiva avança uma etapa, até COMBO_MAXIMO.
+	int combo = linha ? pontuacao->combo + 1 : -1;
+	combo = combo < COMBO_MAXIMO ? combo : COMBO_MAXIMO;
+	pontuacao->combo = (int16_t)combo;
+	base += PONTOS_COMBO * combo * linha;
+
+	// Os pontos usam o nível anterior à linha.
+	int32_t ganhos = base * pontuacao->nivel;
+	pontuacao->pontos += ganhos;
+	// Sessões de bilhões de passos: a contagem satura, em vez de transbordar.
+	pontuacao->linhas += linha & (pontuacao->linhas < INT32_MAX);
+	int nivel = 1 + pontuacao->linhas / LINHAS_POR_NIVEL;
+	pontuacao->nivel = (int16_t)(nivel < NIVEL_MAXIMO ? nivel : NIVEL_MAXIMO);
+	pontuacao->ultimoTipo = tipo;
+
+	return ganhos;
+}
+
+int quadrosPorPassoGravidade(int nivel)
+{
+	if (nivel < 1)
+	{
+		nivel = 1;
+	}
+	else if (nivel > NIVEL_MAXIMO)
+	{
+		nivel = NIVEL_MAXIMO;
+	}
+	return quadrosGravidade[nivel - 1];
+}
@@ -0,0 +1,70 @@
+#ifndef TETRIS_PONTUACAO_H
+#define TETRIS_PONTUACAO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Desafio Tetris Stack
+// Pontuação incremental do nível Mestre: uma pequena máquina de estados, atualizada a cada peça colocada
+// (jogada da fila ou usada da pilha), sem consultar o histórico.
+//
+// Não há tabuleiro no desafio, então as regras clássicas são adaptadas à fila e à pilha:
+//   linha:          a peça colocada encaixa na anterior, se for do mesmo tipo.
+//   linha difícil:  linha com uma peça 'I', ou com um giro T.
+//   giro T:         uma peça 'T' colocada a partir da pilha de reserva(com ou sem linha).
+//   combo:          linhas em colocações consecutivas, até COMBO_MAXIMO etapas. Uma colocação sem linha encerra o combo.
+//   costas com costas: linhas difíceis consecutivas(sem linha simples entre elas) valem 50% a mais.
+//   nível:          sobe a cada LINHAS_POR_NIVEL linhas, multiplica os pontos e acelera a gravidade.
+
+// **** Definições de constantes. ****
+
+#define PONTOS_LINHA 100
+#define PONTOS_LINHA_DIFICIL 400
+#define PONTOS_GIRO_T 400
+#define PONTOS_GIRO_T_LINHA 800
+/// @brief Pontos por etapa do combo(a primeira linha do combo é a etapa 0).
+#define PONTOS_COMBO 50
+
+/// @brief Etapa máxima do combo: as linhas seguintes mantêm a etapa. Cabe em um byte no protocolo do
+/// servidor(etapa + 1), e os pontos do combo não crescem sem limite.
+#define COMBO_MAXIMO 254
+
+/// @brief Quantidade de linhas para subir de nível.
+#define LINHAS_POR_NIVEL 10
+
+/// @brief Nível máximo. O nível inicial é 1.
+#define NIVEL_MAXIMO 20
+
+// **** Declarações de estruturas. ****
+
+/// @brief Estado da pontuação de uma partida.
+typedef struct {
+	int64_t pontos;
+	/// @brief Linhas completadas, até INT32_MAX(saturado).
+	int32_t linhas;
+	int16_t nivel;
+	/// @brief Etapa atual do combo(até COMBO_MAXIMO), ou -1 se não houver combo em andamento.
+	int16_t combo;
+	/// @brief Tipo da última peça colocada, ou 0 se nenhuma.
+	char ultimoTipo;
+	/// @brief Se a última linha foi difícil(costas com costas armado).
+	bool dificilAnterior;
+} Pontuacao;
+
+// **** Declarações das funções. ****
+
+/// @brief Inicializa a pontuação: zero pontos, nível 1, sem combo.
+/// @param Pontuacao. Ponteiro via referência, para efetuar a inicialização.
+void inicializarPontuacao(Pontuacao* pontuacao);
+/// @brief Atualiza a pontuação com uma peça colocada.
+/// @param Pontuacao. Ponteiro via referência, da pontuação.
+/// @param Caractere. Tipo da peça colocada('I', 'O', 'T', 'L').
+/// @param Booleano. Verdadeiro(true), se a peça veio da pilha de reserva.
+/// @returns Inteiro. Pontos ganhos pela colocação.
+int32_t pontuarColocacao(Pontuacao* pontuacao, char tipo, bool daReserva);
+/// @brief Recupera a quantidade de quadros entre os passos da gravidade, para o nível informado.
+/// @param Inteiro. Nível(de 1 a NIVEL_MAXIMO).
+/// @returns Inteiro. Quantidade de quadros(ao menos 1).
+int quadrosPorPassoGravidade(int nivel);
+
+#endif // TETRIS_PONTUACAO_H
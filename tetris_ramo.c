@@ -0,0 +1,237 @@
+#include <string.h>
+#include "tetris_ramo.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Componentes alterados por cada ação efetuada com sucesso, indexados por CodigoAcao.
+/// As ações canceladas não alteram nenhum componente.
+static const bool alteraFila[TOTAL_ACOES] = { false, true, true, false, true, true };
+static const bool alteraPilha[TOTAL_ACOES] = { false, false, true, true, true, true };
+
+// **** Implementações das funções. ****
+
+bool inicializarMemoriaRamos(MemoriaRamos* memoria, uint32_t capacidadeComponentes, uint32_t capacidadeNos)
+{
+	memset(memoria, 0, sizeof(*memoria));
+	if (!inicializarPool(&memoria->filas, sizeof(FilaCompartilhada), capacidadeComponentes)
+		|| !inicializarPool(&memoria->pilhas, sizeof(PilhaCompartilhada), capacidadeComponentes)
+		|| !inicializarPool(&memoria->nos, sizeof(NoHistorico), capacidadeNos))
+	{
+		finalizarMemoriaRamos(memoria);
+		return false;
+	}
+	return true;
+}
+
+void finalizarMemoriaRamos(MemoriaRamos* memoria)
+{
+	finalizarPool(&memoria->filas);
+	finalizarPool(&memoria->pilhas);
+	finalizarPool(&memoria->nos);
+}
+
+/// @brief Libera uma referência da fila, e a fila, se não houver outras.
+static void soltarFila(MemoriaRamos* memoria, FilaCompartilhada* fila)
+{
+	if (fila != NULL && --fila->referencias == 0)
+	{
+		liberarPool(&memoria->filas, fila);
+	}
+}
+
+/// @brief Libera uma referência da pilha, e a pilha, se não houver outras.
+static void soltarPilha(MemoriaRamos* memoria, PilhaCompartilhada* pilha)
+{
+	if (pilha != NULL && --pilha->referencias == 0)
+	{
+		liberarPool(&memoria->pilhas, pilha);
+	}
+}
+
+/// @brief Libera uma referência do histórico. Os nós são liberados até o primeiro que ainda é compartilhado.
+static void soltarHistorico(MemoriaRamos* memoria, NoHistorico* no)
+{
+	while (no != NULL && --no->referencias == 0)
+	{
+		NoHistorico* anterior = no->anterior;
+		liberarPool(&memoria->nos, no);
+		no = anterior;
+	}
+}
+
+/// @brief Reserva uma fila exclusiva para o ramo, se a atual for compartilhada.
+/// @returns Ponteiro da nova fila, ou a atual, se exclusiva. NULL, se o pool estiver esgotado.
+static FilaCompartilhada* reservarFila(const Ramo* ramo)
+{
+	if (ramo->fila->referencias == 1)
+	{
+		return ramo->fila;
+	}
+	FilaCompartilhada* copia = alocarPool(&ramo->memoria->filas);
+	if (copia != NULL)
+	{
+		copia->referencias = 1;
+	}
+	return copia;
+}
+
+/// @brief Reserva uma pilha exclusiva para o ramo, se a atual for compartilhada.
+/// @returns Ponteiro da nova pilha, ou a atual, se exclusiva. NULL, se o pool estiver esgotado.
+static PilhaCompartilhada* reservarPilha(const Ramo* ramo)
+{
+	if (ramo->pilha->referencias == 1)
+	{
+		return ramo->pilha;
+	}
+	PilhaCompartilhada* copia = alocarPool(&ramo->memoria->pilhas);
+	if (copia != NULL)
+	{
+		copia->referencias = 1;
+	}
+	return copia;
+}
+
+bool criarRamo(Ramo* ramo, MemoriaRamos* memoria, const Sessao* origem, uint64_t semente)
+{
+	memset(ramo, 0, sizeof(*ramo));
+
+	ramo->memoria = memoria;
+	ramo->fila = alocarPool(&memoria->filas);
+	ramo->pilha = alocarPool(&memoria->pilhas);
+	if (ramo->fila == NULL || ramo->pilha == NULL)
+	{
+		liberarPool(&memoria->filas, ramo->fila);
+		liberarPool(&memoria->pilhas, ramo->pilha);
+		memset(ramo, 0, sizeof(*ramo));
+		return false;
+	}
+
+	ramo->fila->referencias = 1;
+	ramo->fila->fila = origem->fila;
+	ramo->pilha->referencias = 1;
+	ramo->pilha->pilha = origem->pilha;
+	inicializarGerador(&ramo->gerador, semente);
+	ramo->ids = origem->ids;
+	ramo->pontuacao = origem->pontuacao;
+	ramo->trocou = origem->trocou;
+	return true;
+}
+
+void bifurcarRamo(Ramo* destino, const Ramo* origem)
+{
+	*destino = *origem;
+	destino->fila->referencias++;
+	destino->pilha->referencias++;
+	if (destino->historico != NULL)
+	{
+		destino->historico->referencias++;
+	}
+}
+
+ResultadoAcao aplicarAcaoRamo(Ramo* ramo, CodigoAcao acao)
+{
+	MemoriaRamos* memoria = ramo->memoria;
+	NoHistorico* no = alocarPool(&memoria->nos);
+	if (no == NULL)
+	{
+		return RESULTADO_ACAO_INVALIDA;
+	}
+
+	// A ação é aplicada a uma sessão temporária. O gerador é uma cópia: o ramo só avança se tudo der certo.
+	GeradorPecas gerador = ramo->gerador;
+	Sessao sessao;
+	sessao.fila = ramo->fila->fila;
+	sessao.pilha = ramo->pilha->pilha;
+	sessao.ids = ramo->ids;
+	sessao.pontuacao = ramo->pontuacao;
+	sessao.trocou = ramo->trocou;
+	sessao.gerador = &gerador;
+
+	ResultadoAcao resultado = aplicarAcao(&sessao, acao, NULL);
+
+	// Somente os componentes alterados pela ação são gravados(e, se compartilhados, copiados).
+	// As cópias são reservadas antes de qualquer gravação: com os pools esgotados, o ramo permanece inalterado.
+	bool sucesso = resultado == RESULTADO_SUCESSO;
+	bool filaAlterada = sucesso && alteraFila[acao];
+	bool pilhaAlterada = sucesso && alteraPilha[acao];
+	FilaCompartilhada* fila = filaAlterada ? reservarFila(ramo) : ramo->fila;
+	PilhaCompartilhada* pilha = pilhaAlterada ? reservarPilha(ramo) : ramo->pilha;
+	if (fila == NULL || pilha == NULL)
+	{
+		if (fila != ramo->fila)
+		{
+			liberarPool(&memoria->filas, fila);
+		}
+		if (pilha != ramo->pilha)
+		{
+			liberarPool(&memoria->pilhas, pilha);
+		}
+		liberarPool(&memoria->nos, no);
+		return RESULTADO_ACAO_INVALIDA;
+	}
+
+	if (fila != ramo->fila)
+	{
+		soltarFila(memoria, ramo->fila);
+		ramo->fila = fila;
+	}
+	if (pilha != ramo->pilha)
+	{
+		soltarPilha(memoria, ramo->pilha);
+		ramo->pilha = pilha;
+	}
+	fila->fila = sessao.fila;
+	pilha->pilha = sessao.pilha;
+	ramo->gerador = gerador;
+	ramo->ids = sessao.ids;
+	ramo->pontuacao = sessao.pontuacao;
+	ramo->trocou = sessao.trocou;
+
+	// O novo nó passa a referenciar o histórico anterior, herdando a referência do ramo.
+	no->referencias = 1;
+	no->profundidade = ramo->historico != NULL ? ramo->historico->profundidade + 1 : 1;
+	no->acao = acao;
+	no->resultado = resultado;
+	no->anterior = ramo->historico;
+	ramo->historico = no;
+
+	return resultado;
+}
+
+void materializarRamo(Ramo* ramo, Sessao* destino)
+{
+	destino->fila = ramo->fila->fila;
+	destino->pilha = ramo->pilha->pilha;
+	destino->ids = ramo->ids;
+	destino->pontuacao = ramo->pontuacao;
+	destino->trocou = ramo->trocou;
+	destino->gerador = &ramo->gerador;
+}
+
+int historicoRamo(const Ramo* ramo, CodigoAcao* destino, int capacidade)
+{
+	if (ramo->historico == NULL || capacidade <= 0)
+	{
+		return 0;
+	}
+
+	int total = ramo->historico->profundidade < capacidade ? ramo->historico->profundidade : capacidade;
+	const NoHistorico* no = ramo->historico;
+	for (int i = total - 1; i >= 0; i--, no = no->anterior)
+	{
+		destino[i] = no->acao;
+	}
+	return total;
+}
+
+void liberarRamo(Ramo* ramo)
+{
+	if (ramo->memoria == NULL)
+	{
+		return;
+	}
+	soltarFila(ramo->memoria, ramo->fila);
+	soltarPilha(ramo->memoria, ramo->pilha);
+	soltarHistorico(ramo->memoria, ramo->historico);
+	memset(ramo, 0, sizeof(*ramo));
+}
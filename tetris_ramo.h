@@ -0,0 +1,112 @@
+#ifndef TETRIS_RAMO_H
+#define TETRIS_RAMO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_memoria.h"
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Ramos de uma sessão, para a análise de alternativas("e se eu reservasse em vez de jogar?").
+// Um ramo é um identificador leve: a fila, a pilha e o histórico de ações ficam em componentes
+// com contagem de referências, compartilhados entre os ramos até que um deles altere o componente
+// (cópia na escrita). O histórico é uma lista encadeada da ação mais recente para a mais antiga,
+// e o prefixo comum é compartilhado. A sequência de peças vem do gerador em lote, copiado por valor:
+// ramos bifurcados no mesmo ponto recebem as mesmas peças futuras.
+// Os componentes vêm de pools reservados na inicialização(MemoriaRamos): bifurcar, aplicar ações e
+// liberar ramos não chamam o alocador do sistema. Com os pools esgotados, as operações falham como
+// se não houvesse memória.
+// Os ramos não são seguros para uso concorrente entre threads.
+
+// **** Declarações de estruturas. ****
+
+/// @brief Fila compartilhável entre ramos.
+typedef struct {
+	int referencias;
+	Fila fila;
+} FilaCompartilhada;
+
+/// @brief Pilha compartilhável entre ramos.
+typedef struct {
+	int referencias;
+	Pilha pilha;
+} PilhaCompartilhada;
+
+/// @brief Ação do histórico de um ramo. Os nós anteriores são compartilhados entre ramos.
+typedef struct NoHistorico {
+	int referencias;
+	/// @brief Quantidade de ações do histórico, até este nó(inclusive).
+	int profundidade;
+	CodigoAcao acao;
+	ResultadoAcao resultado;
+	struct NoHistorico* anterior;
+} NoHistorico;
+
+/// @brief Pools dos componentes dos ramos, compartilhados por todos os ramos de uma análise.
+typedef struct {
+	Pool filas;
+	Pool pilhas;
+	Pool nos;
+} MemoriaRamos;
+
+/// @brief Identificador de um ramo.
+typedef struct {
+	/// @brief Pools de onde vêm os componentes do ramo.
+	MemoriaRamos* memoria;
+	FilaCompartilhada* fila;
+	PilhaCompartilhada* pilha;
+	/// @brief Ação mais recente, ou NULL se o ramo ainda não possui ações.
+	NoHistorico* historico;
+	GeradorPecas gerador;
+	/// @brief Alocador de identificações, copiado na bifurcação: a mesma peça futura recebe a mesma
+	/// identificação em ramos bifurcados no mesmo ponto.
+	AlocadorIds ids;
+	Pontuacao pontuacao;
+	bool trocou;
+} Ramo;
+
+// **** Declarações das funções. ****
+
+/// @brief Reserva os pools dos componentes dos ramos.
+/// @param MemoriaRamos. Ponteiro via referência, para efetuar a inicialização.
+/// @param Inteiro. Quantidade máxima de filas e de pilhas distintas(cada uma) em uso simultâneo.
+/// @param Inteiro. Quantidade máxima de nós de histórico em uso simultâneo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória.
+bool inicializarMemoriaRamos(MemoriaRamos* memoria, uint32_t capacidadeComponentes, uint32_t capacidadeNos);
+/// @brief Libera os pools dos componentes. Todos os ramos devem ter sido liberados.
+/// @param MemoriaRamos. Ponteiro via referência, a ser finalizado.
+void finalizarMemoriaRamos(MemoriaRamos* memoria);
+/// @brief Cria o ramo raiz a partir do estado atual de uma sessão. A sessão não é alterada.
+/// @param Ramo. Ponteiro via referência, para efetuar a inicialização.
+/// @param MemoriaRamos. Ponteiro via referência, dos pools dos componentes.
+/// @param Sessao. Ponteiro da sessão de origem. Somente leitura.
+/// @param Inteiro. Semente das peças futuras do ramo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se os pools estiverem esgotados.
+bool criarRamo(Ramo* ramo, MemoriaRamos* memoria, const Sessao* origem, uint64_t semente);
+/// @brief Bifurca um ramo, em tempo constante: os componentes são compartilhados, sem cópias.
+/// @param Ramo. Ponteiro via referência, a conter o novo ramo.
+/// @param Ramo. Ponteiro do ramo de origem. Somente leitura(exceto as contagens de referências).
+void bifurcarRamo(Ramo* destino, const Ramo* origem);
+/// @brief Aplica uma ação ao ramo. Somente os componentes alterados pela ação são copiados,
+/// e somente se estiverem compartilhados com outros ramos.
+/// @param Ramo. Ponteiro via referência, do ramo.
+/// @param CodigoAcao. Ação a ser aplicada.
+/// @returns ResultadoAcao. RESULTADO_SUCESSO, ou o motivo do cancelamento(o histórico também registra
+/// as ações canceladas). RESULTADO_ACAO_INVALIDA, se os pools estiverem esgotados.
+ResultadoAcao aplicarAcaoRamo(Ramo* ramo, CodigoAcao acao);
+/// @brief Copia o estado atual do ramo para uma sessão(ex: para exibição).
+/// A sessão resultante usa o gerador do ramo, e não deve ser usada após a liberação do ramo.
+/// @param Ramo. Ponteiro via referência, do ramo.
+/// @param Sessao. Ponteiro via referência, a conter o estado.
+void materializarRamo(Ramo* ramo, Sessao* destino);
+/// @brief Recupera as ações do histórico do ramo, da mais antiga para a mais recente.
+/// @param Ramo. Ponteiro do ramo. Somente leitura.
+/// @param CodigoAcao. Vetor de destino.
+/// @param Inteiro. Capacidade do vetor. Se o histórico for maior, somente as ações mais recentes são copiadas.
+/// @returns Inteiro. Quantidade de ações copiadas.
+int historicoRamo(const Ramo* ramo, CodigoAcao* destino, int capacidade);
+/// @brief Libera o ramo. Os componentes são liberados quando nenhum outro ramo os referencia.
+/// @param Ramo. Ponteiro via referência, a ser finalizado.
+void liberarRamo(Ramo* ramo);
+
+#endif // TETRIS_RAMO_H
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdatomic.h>
+#include "tetris_rastro.h"
+#include "tetris_tempo.h"
+#ifdef _MSC_VER
+/// @brief Armazenamento local por thread.
+#define LOCAL_THREAD __declspec(thread)
+#else
+/// @brief Armazenamento local por thread.
+#define LOCAL_THREAD _Thread_local
+#endif
+
+// **** Declarações de estruturas. ****
+
+/// @brief Anel de eventos de uma thread.
+typedef struct {
+	EventoRastro eventos[TAM_MAX_EVENTOS_RASTRO];
+	/// @brief Total de eventos gravados(pode exceder a capacidade).
+	uint64_t total;
+} AnelRastro;
+
+// **** Variáveis internas. ****
+
+/// @brief Flag global do rastro. Alterada somente na inicialização, antes das threads de trabalho.
+static bool rastroAtivo = false;
+/// @brief Instante de referência(zero) dos eventos exportados.
+static int64_t inicioRastroNs = 0;
+/// @brief Anéis de eventos, um por thread, pré-alocados.
+static AnelRastro aneis[TAM_MAX_THREADS_RASTRO];
+/// @brief Quantidade de anéis já entregues às threads.
+static atomic_int totalAneis;
+/// @brief Anel da thread atual. Obtido no primeiro evento da thread.
+static LOCAL_THREAD AnelRastro* anelLocal = NULL;
+/// @brief Indica se a thread atual excedeu a quantidade de anéis e não é rastreada.
+static LOCAL_THREAD bool semAnel = false;
+
+// **** Implementações das funções. ****
+
+/// @brief Grava um evento no anel da thread atual.
+static void gravarEvento(const char* nome, char fase)
+{
+	if (anelLocal == NULL)
+	{
+		if (semAnel)
+		{
+			return;
+		}
+		int indice = atomic_fetch_add(&totalAneis, 1);
+		if (indice >= TAM_MAX_THREADS_RASTRO)
+		{
+			semAnel = true;
+			return;
+		}
+		anelLocal = &aneis[indice];
+	}
+
+	EventoRastro* evento = &anelLocal->eventos[anelLocal->total % TAM_MAX_EVENTOS_RASTRO];
+	evento->instanteNs = relogioMonotonicoNs();
+	evento->nome = nome;
+	evento->fase = fase;
+	anelLocal->total++;
+}
+
+void ativarRastro(bool ativo)
+{
+	rastroAtivo = ativo;
+	if (ativo)
+	{
+		inicioRastroNs = relogioMonotonicoNs();
+	}
+}
+
+void iniciarRastro(const char* nome)
+{
+	if (rastroAtivo)
+	{
+		gravarEvento(nome, 'B');
+	}
+}
+
+void finalizarRastro(const char* nome)
+{
+	if (rastroAtivo)
+	{
+		gravarEvento(nome, 'E');
+	}
+}
+
+bool exportarRastroJson(const char* caminho)
+{
+	FILE* arquivo = fopen(caminho, "w");
+	if (arquivo == NULL)
+	{
+		return false;
+	}
+
+	int total = atomic_load(&totalAneis);
+	if (total > TAM_MAX_THREADS_RASTRO)
+	{
+		total = TAM_MAX_THREADS_RASTRO;
+	}
+
+	fprintf(arquivo, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+	bool primeiro = true;
+
+	for (int t = 0; t < total; t++)
+	{
+		const AnelRastro* anel = &aneis[t];
+		uint64_t inicio = anel->total > TAM_MAX_EVENTOS_RASTRO ? anel->total - TAM_MAX_EVENTOS_RASTRO : 0;
+		// Profundidade de aninhamento. Se o anel deu a volta, os fins cujos inícios foram
+		// sobrescritos são descartados, para manter os pares consistentes.
+		int profundidade = 0;
+
+		for (uint64_t i = inicio; i < anel->total; i++)
+		{
+			const EventoRastro* evento = &anel->eventos[i % TAM_MAX_EVENTOS_RASTRO];
+
+			if (evento->fase == 'E')
+			{
+				if (profundidade == 0)
+				{
+					continue;
+				}
+				profundidade--;
+			}
+			else
+			{
+				profundidade++;
+			}
+
+			// O formato usa microssegundos. As casas decimais preservam a resolução de nanossegundos.
+			int64_t relativo = evento->instanteNs - inicioRastroNs;
+			fprintf(arquivo, "%s{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %lld.%03lld, \"pid\": 1, \"tid\": %d}",
+				primeiro ? "" : ",\n", evento->nome, evento->fase,
+				(long long)(relativo / 1000), (long long)(relativo % 1000), t + 1);
+			primeiro = false;
+		}
+	}
+
+	fprintf(arquivo, "\n]}\n");
+	fclose(arquivo);
+
+	return true;
+}
@@ -0,0 +1,50 @@
+#ifndef TETRIS_RASTRO_H
+#define TETRIS_RASTRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Desafio Tetris Stack
+// Rastro(trace) da sessão no formato Chrome trace-event(chrome://tracing, Perfetto).
+// Os eventos de início e fim são gravados em um anel pré-alocado por thread, e
+// convertidos para JSON somente ao final, na exportação.
+
+// **** Definições de constantes. ****
+
+/// @brief Capacidade do anel de eventos de cada thread. Ao encher, os eventos mais antigos são sobrescritos.
+#define TAM_MAX_EVENTOS_RASTRO 32768
+
+/// @brief Quantidade máxima de threads com anel próprio. As excedentes não são rastreadas.
+#define TAM_MAX_THREADS_RASTRO 8
+
+// **** Declarações de estruturas. ****
+
+/// @brief Um evento do rastro.
+typedef struct {
+	/// @brief Instante do evento, em nanossegundos do relógio monotônico.
+	int64_t instanteNs;
+	/// @brief Nome do trecho rastreado. Deve ser um texto constante(literal).
+	const char* nome;
+	/// @brief Fase do evento: 'B'(início) ou 'E'(fim).
+	char fase;
+} EventoRastro;
+
+// **** Declarações das funções. ****
+
+/// @brief Habilita ou desabilita o rastro(desabilitado por padrão). Com o rastro desabilitado,
+/// cada marcação custa apenas um teste de flag.
+/// @param bool. Verdadeiro(true) para habilitar.
+void ativarRastro(bool ativo);
+/// @brief Marca o início de um trecho rastreado, na thread atual.
+/// @param Texto. Nome do trecho. Deve ser um texto constante(literal).
+void iniciarRastro(const char* nome);
+/// @brief Marca o fim de um trecho rastreado, na thread atual.
+/// @param Texto. Nome do trecho, o mesmo usado em iniciarRastro.
+void finalizarRastro(const char* nome);
+/// @brief Escreve todos os eventos retidos no formato Chrome trace-event JSON.
+/// Deve ser chamada ao final, com as demais threads já ociosas.
+/// @param Texto. Caminho do arquivo de destino.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool exportarRastroJson(const char* caminho);
+
+#endif // TETRIS_RASTRO_H
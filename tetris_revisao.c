@@ -0,0 +1,360 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_revisao.h"
+#include "tetris_memoria.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// **** Definições de constantes. ****
+
+/// @brief Tamanho do cabeçalho do arquivo, em bytes.
+#define TAM_CABECALHO_REVISAO 16
+
+/// @brief Tamanho do rodapé do arquivo, em bytes.
+#define TAM_RODAPE_REVISAO 24
+
+// **** Implementações das funções. ****
+
+// **** Codificação ****
+
+/// @brief Escreve um inteiro em little-endian, com a quantidade de bytes informada.
+static inline uint8_t* escreverInteiro(uint8_t* destino, uint64_t valor, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+	{
+		destino[i] = (uint8_t)(valor >> (8 * i));
+	}
+	return destino + bytes;
+}
+
+/// @brief Lê um inteiro em little-endian, com a quantidade de bytes informada.
+static inline uint64_t lerInteiro(const uint8_t** origem, int bytes)
+{
+	uint64_t valor = 0;
+	for (int i = 0; i < bytes; i++)
+	{
+		valor |= (uint64_t)(*origem)[i] << (8 * i);
+	}
+	*origem += bytes;
+	return valor;
+}
+
+/// @brief Codifica o quadro-chave de uma sessão.
+static void codificarQuadro(uint8_t* quadro, const Sessao* sessao, uint64_t numeroAcao)
+{
+	uint8_t* p = escreverInteiro(quadro, numeroAcao, 8);
+	p = escreverInteiro(p, (uint64_t)sessao->fila.inicio, 1);
+	p = escreverInteiro(p, (uint64_t)sessao->fila.total, 1);
+	for (int i = 0; i < TAM_MAX_FILA; i++)
+	{
+		p = escreverInteiro(p, (uint8_t)sessao->fila.itens[i].tipo, 1);
+		p = escreverInteiro(p, (uint64_t)sessao->fila.itens[i].id, 8);
+	}
+	p = escreverInteiro(p, (uint8_t)sessao->pilha.topo, 1);
+	for (int i = 0; i < TAM_MAX_PILHA; i++)
+	{
+		p = escreverInteiro(p, (uint8_t)sessao->pilha.itens[i].tipo, 1);
+		p = escreverInteiro(p, (uint64_t)sessao->pilha.itens[i].id, 8);
+	}
+	p = escreverInteiro(p, sessao->trocou ? 1 : 0, 1);
+	p = escreverInteiro(p, (uint64_t)sessao->ids.proximo, 8);
+	p = escreverInteiro(p, (uint64_t)sessao->ids.limite, 8);
+	p = escreverInteiro(p, (uint64_t)sessao->ids.emitidos, 8);
+	p = escreverInteiro(p, sessao->gerador->semente, 8);
+	p = escreverInteiro(p, sessao->gerador->contador, 8);
+	p = escreverInteiro(p, sessao->gerador->ponderado ? 1 : 0, 1);
+	for (int i = 0; i < TOTAL_TIPOS_PECA; i++)
+	{
+		p = escreverInteiro(p, sessao->gerador->pesos[i], 2);
+	}
+	const Pontuacao* pontuacao = &sessao->pontuacao;
+	p = escreverInteiro(p, (uint64_t)pontuacao->pontos, 8);
+	p = escreverInteiro(p, (uint32_t)pontuacao->linhas, 4);
+	p = escreverInteiro(p, (uint16_t)pontuacao->nivel, 2);
+	p = escreverInteiro(p, (uint16_t)pontuacao->combo, 2);
+	p = escreverInteiro(p, (uint8_t)pontuacao->ultimoTipo, 1);
+	escreverInteiro(p, pontuacao->dificilAnterior ? 1 : 0, 1);
+}
+
+/// @brief Restaura a sessão a partir de um quadro-chave.
+/// @returns Verdadeiro(true), se o quadro for consistente. Caso contrário, Falso(false).
+static bool decodificarQuadro(const uint8_t* quadro, Sessao* sessao, GeradorPecas* gerador)
+{
+	const uint8_t* p = quadro + 8;
+	memset(sessao, 0, sizeof(*sessao));
+	sessao->fila.inicio = (int)lerInteiro(&p, 1);
+	sessao->fila.total = (int)lerInteiro(&p, 1);
+	for (int i = 0; i < TAM_MAX_FILA; i++)
+	{
+		sessao->fila.itens[i].tipo = (char)lerInteiro(&p, 1);
+		sessao->fila.itens[i].id = (int64_t)lerInteiro(&p, 8);
+	}
+	// O fim da fila não é gravado: é sempre a posição após o último elemento.
+	sessao->fila.fim = (sessao->fila.inicio + sessao->fila.total) % TAM_MAX_FILA;
+	sessao->pilha.topo = (int8_t)lerInteiro(&p, 1);
+	for (int i = 0; i < TAM_MAX_PILHA; i++)
+	{
+		sessao->pilha.itens[i].tipo = (char)lerInteiro(&p, 1);
+		sessao->pilha.itens[i].id = (int64_t)lerInteiro(&p, 8);
+	}
+	sessao->trocou = lerInteiro(&p, 1) != 0;
+	sessao->ids.proximo = (int64_t)lerInteiro(&p, 8);
+	sessao->ids.limite = (int64_t)lerInteiro(&p, 8);
+	sessao->ids.emitidos = (int64_t)lerInteiro(&p, 8);
+	inicializarGerador(gerador, lerInteiro(&p, 8));
+	gerador->contador = lerInteiro(&p, 8);
+	bool ponderado = lerInteiro(&p, 1) != 0;
+	uint16_t pesos[TOTAL_TIPOS_PECA];
+	for (int i = 0; i < TOTAL_TIPOS_PECA; i++)
+	{
+		pesos[i] = (uint16_t)lerInteiro(&p, 2);
+	}
+	// Pesos todos zero em um gerador ponderado: quadro inconsistente.
+	bool distribuicaoValida = !ponderado || definirPesosGerador(gerador, pesos);
+	sessao->gerador = gerador;
+	Pontuacao* pontuacao = &sessao->pontuacao;
+	pontuacao->pontos = (int64_t)lerInteiro(&p, 8);
+	pontuacao->linhas = (int32_t)lerInteiro(&p, 4);
+	pontuacao->nivel = (int16_t)lerInteiro(&p, 2);
+	pontuacao->combo = (int16_t)lerInteiro(&p, 2);
+	pontuacao->ultimoTipo = (char)lerInteiro(&p, 1);
+	pontuacao->dificilAnterior = lerInteiro(&p, 1) != 0;
+
+	return distribuicaoValida && sessao->fila.inicio < TAM_MAX_FILA && sessao->fila.total <= TAM_MAX_FILA
+		&& sessao->pilha.topo >= -1 && sessao->pilha.topo < TAM_MAX_PILHA;
+}
+
+// **** Gravação ****
+
+/// @brief Escreve bytes no arquivo, acompanhando a posição.
+static void escreverRevisao(GravadorRevisao* gravador, const void* dados, size_t tamanho)
+{
+	if (!gravador->falhou && fwrite(dados, 1, tamanho, gravador->arquivo) != tamanho)
+	{
+		gravador->falhou = true;
+	}
+	gravador->posicao += tamanho;
+}
+
+/// @brief Grava um quadro-chave da sessão, e o inclui no índice.
+static void gravarQuadro(GravadorRevisao* gravador, const Sessao* sessao)
+{
+	// O índice não cresce durante a partida: ao atingir a capacidade máxima, a gravação falha.
+	if (gravador->totalQuadros == gravador->capacidadeIndice)
+	{
+		gravador->falhou = true;
+		return;
+	}
+	gravador->indice[2 * gravador->totalQuadros] = gravador->totalAcoes;
+	gravador->indice[2 * gravador->totalQuadros + 1] = gravador->posicao;
+	gravador->totalQuadros++;
+
+	uint8_t quadro[TAM_QUADRO_CHAVE];
+	codificarQuadro(quadro, sessao, gravador->totalAcoes);
+	escreverRevisao(gravador, quadro, sizeof(quadro));
+	gravador->acoesDesdeQuadro = 0;
+	gravador->limiteIds = sessao->ids.limite;
+	memcpy(gravador->pesos, sessao->gerador->pesos, sizeof(gravador->pesos));
+}
+
+bool abrirRevisao(GravadorRevisao* gravador, const char* caminho, const Sessao* sessao, uint32_t intervalo)
+{
+	memset(gravador, 0, sizeof(*gravador));
+	if (sessao->gerador == NULL || intervalo == 0)
+	{
+		return false;
+	}
+
+	// O índice é reservado com a capacidade máxima: as páginas ainda não usadas não ocupam memória física.
+	gravador->indice = alocarMemoria((size_t)TAM_MAX_QUADROS_REVISAO * 2 * sizeof(uint64_t));
+	gravador->arquivo = fopen(caminho, "wb");
+	if (gravador->indice == NULL || gravador->arquivo == NULL)
+	{
+		liberarMemoria(gravador->indice);
+		if (gravador->arquivo != NULL)
+		{
+			fclose(gravador->arquivo);
+		}
+		memset(gravador, 0, sizeof(*gravador));
+		return false;
+	}
+	gravador->capacidadeIndice = TAM_MAX_QUADROS_REVISAO;
+	gravador->intervalo = intervalo;
+
+	uint8_t cabecalho[TAM_CABECALHO_REVISAO] = { 'T', 'T', 'K', 'F', VERSAO_REVISAO };
+	escreverInteiro(&cabecalho[8], intervalo, 4);
+	escreverRevisao(gravador, cabecalho, sizeof(cabecalho));
+	gravarQuadro(gravador, sessao);
+
+	return !gravador->falhou;
+}
+
+void gravarAcaoRevisao(GravadorRevisao* gravador, const Sessao* sessao, CodigoAcao acao)
+{
+	uint8_t codigo = (uint8_t)acao;
+	escreverRevisao(gravador, &codigo, 1);
+	gravador->totalAcoes++;
+	gravador->acoesDesdeQuadro++;
+
+	// Um novo bloco de identificações(reservado no contador global), ou uma nova distribuição dos tipos,
+	// não seriam reproduzidos pelas ações.
+	if (gravador->acoesDesdeQuadro >= gravador->intervalo || sessao->ids.limite != gravador->limiteIds
+		|| memcmp(sessao->gerador->pesos, gravador->pesos, sizeof(gravador->pesos)) != 0)
+	{
+		gravarQuadro(gravador, sessao);
+	}
+}
+
+bool fecharRevisao(GravadorRevisao* gravador)
+{
+	uint64_t posicaoIndice = gravador->posicao;
+	for (uint32_t i = 0; i < gravador->totalQuadros; i++)
+	{
+		uint8_t entrada[TAM_ENTRADA_QUADRO];
+		escreverInteiro(escreverInteiro(entrada, gravador->indice[2 * i], 8), gravador->indice[2 * i + 1], 8);
+		escreverRevisao(gravador, entrada, sizeof(entrada));
+	}
+
+	uint8_t rodape[TAM_RODAPE_REVISAO];
+	uint8_t* p = escreverInteiro(rodape, posicaoIndice, 8);
+	p = escreverInteiro(p, gravador->totalQuadros, 4);
+	p = escreverInteiro(p, gravador->totalAcoes, 8);
+	memcpy(p, "TTKI", 4);
+	escreverRevisao(gravador, rodape, sizeof(rodape));
+
+	bool sucesso = !gravador->falhou;
+	if (fclose(gravador->arquivo) != 0)
+	{
+		sucesso = false;
+	}
+	liberarMemoria(gravador->indice);
+	memset(gravador, 0, sizeof(*gravador));
+	return sucesso;
+}
+
+// **** Leitura ****
+
+#ifdef _WIN32
+// Plataforma Windows: a leitura depende do mmap(POSIX).
+
+bool abrirLeitorRevisao(LeitorRevisao* leitor, const char* caminho)
+{
+	memset(leitor, 0, sizeof(*leitor));
+	return false;
+}
+
+void fecharLeitorRevisao(LeitorRevisao* leitor)
+{
+}
+
+#else
+
+bool abrirLeitorRevisao(LeitorRevisao* leitor, const char* caminho)
+{
+	memset(leitor, 0, sizeof(*leitor));
+
+	int descritor = open(caminho, O_RDONLY);
+	if (descritor < 0)
+	{
+		return false;
+	}
+
+	struct stat informacoes;
+	void* base = MAP_FAILED;
+	if (fstat(descritor, &informacoes) == 0
+		&& (size_t)informacoes.st_size >= TAM_CABECALHO_REVISAO + TAM_QUADRO_CHAVE + TAM_RODAPE_REVISAO)
+	{
+		base = mmap(NULL, (size_t)informacoes.st_size, PROT_READ, MAP_SHARED, descritor, 0);
+	}
+	close(descritor);
+	if (base == MAP_FAILED)
+	{
+		return false;
+	}
+
+	// Somente o cabeçalho e o rodapé são conferidos: o índice e os quadros são lidos sob demanda.
+	size_t tamanho = (size_t)informacoes.st_size;
+	const uint8_t* bytes = base;
+	const uint8_t* p = bytes + tamanho - TAM_RODAPE_REVISAO;
+	uint64_t posicaoIndice = lerInteiro(&p, 8);
+	uint32_t totalQuadros = (uint32_t)lerInteiro(&p, 4);
+	uint64_t totalAcoes = lerInteiro(&p, 8);
+	bool valido = memcmp(bytes, "TTKF", 4) == 0 && bytes[4] == VERSAO_REVISAO && memcmp(p, "TTKI", 4) == 0
+		&& totalQuadros > 0 && posicaoIndice >= TAM_CABECALHO_REVISAO
+		&& posicaoIndice + (uint64_t)totalQuadros * TAM_ENTRADA_QUADRO + TAM_RODAPE_REVISAO == tamanho;
+	if (!valido)
+	{
+		munmap(base, tamanho);
+		return false;
+	}
+
+	leitor->base = bytes;
+	leitor->tamanho = tamanho;
+	leitor->indice = bytes + posicaoIndice;
+	leitor->totalQuadros = totalQuadros;
+	leitor->totalAcoes = totalAcoes;
+	return true;
+}
+
+void fecharLeitorRevisao(LeitorRevisao* leitor)
+{
+	if (leitor->base != NULL)
+	{
+		munmap((void*)leitor->base, leitor->tamanho);
+	}
+	memset(leitor, 0, sizeof(*leitor));
+}
+
+#endif
+
+bool buscarAcaoRevisao(const LeitorRevisao* leitor, uint64_t acao, Sessao* sessao, GeradorPecas* gerador)
+{
+	if (leitor->base == NULL || acao > leitor->totalAcoes)
+	{
+		return false;
+	}
+
+	// Busca binária pelo último quadro-chave com número de ação menor ou igual ao solicitado.
+	uint32_t inicio = 0, fim = leitor->totalQuadros;
+	while (fim - inicio > 1)
+	{
+		uint32_t meio = inicio + (fim - inicio) / 2;
+		const uint8_t* entrada = leitor->indice + (size_t)meio * TAM_ENTRADA_QUADRO;
+		if (lerInteiro(&entrada, 8) <= acao)
+		{
+			inicio = meio;
+		}
+		else
+		{
+			fim = meio;
+		}
+	}
+
+	const uint8_t* entrada = leitor->indice + (size_t)inicio * TAM_ENTRADA_QUADRO;
+	uint64_t numeroQuadro = lerInteiro(&entrada, 8);
+	uint64_t posicao = lerInteiro(&entrada, 8);
+	uint64_t restantes = acao - numeroQuadro;
+	const uint8_t* indice = leitor->indice;
+	if (numeroQuadro > acao || posicao + TAM_QUADRO_CHAVE + restantes > (uint64_t)(indice - leitor->base))
+	{
+		return false;
+	}
+
+	const uint8_t* quadro = leitor->base + posicao;
+	if (!decodificarQuadro(quadro, sessao, gerador))
+	{
+		return false;
+	}
+
+	// Somente as ações entre o quadro-chave e a ação solicitada são reaplicadas.
+	const uint8_t* acoes = quadro + TAM_QUADRO_CHAVE;
+	for (uint64_t i = 0; i < restantes; i++)
+	{
+		aplicarAcao(sessao, (CodigoAcao)acoes[i], NULL);
+	}
+	return true;
+}
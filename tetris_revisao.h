@@ -0,0 +1,120 @@
+#ifndef TETRIS_REVISAO_H
+#define TETRIS_REVISAO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Gravação para revisão, com busca rápida: além das ações(1 byte cada), o arquivo contém quadros-chave
+// periódicos com o estado completo da sessão(fila, pilha, identificações, flag de troca, gerador de peças
+// e pontuação), e um índice dos quadros-chave ao final. A sessão gravada deve usar o gerador de peças em
+// lote(inicializarSessaoComGerador): as peças após um quadro-chave dependem somente do estado do gerador.
+//
+// O leitor mapeia o arquivo em memória(mmap), sem cópias: para chegar à ação N, busca no índice(busca
+// binária) o último quadro-chave até N, restaura somente esse quadro e reaplica somente as ações seguintes.
+// Um quadro-chave também é gravado sempre que a sessão reserva um novo bloco de identificações, para que as
+// ações reaplicadas nunca dependam do contador global(as identificações restauradas são as gravadas), e sempre
+// que a distribuição dos tipos do gerador muda.
+//
+// Leiaute do arquivo(inteiros em little-endian):
+//   cabeçalho:   "TTKF", versão(1 byte), 3 bytes reservados, intervalo entre quadros-chave(4 bytes), 4 bytes reservados.
+//   corpo:       quadro-chave(TAM_QUADRO_CHAVE bytes), seguido das ações(1 byte cada) até o próximo quadro-chave.
+//   quadro-chave: número da ação(8 bytes: ações aplicadas até ele), início(1) e total(1) da fila, peças da fila
+//                (tipo 1 byte e id 8 bytes, por posição do vetor), topo da pilha(1), peças da pilha, trocou(1),
+//                identificações(próxima, limite e emitidas, 8 bytes cada), gerador(semente e contador, 8 bytes
+//                cada, ponderado 1 byte e os pesos dos tipos, 2 bytes cada, ver definirPesosGerador) e pontuação
+//                (pontos 8, linhas 4, nível 2, combo 2, último tipo 1, costas com costas 1).
+//   índice:      por quadro-chave, número da ação(8 bytes) e posição(8 bytes).
+//   rodapé:      posição do índice(8 bytes), total de quadros-chave(4 bytes), total de ações(8 bytes), "TTKI".
+
+// **** Definições de constantes. ****
+
+/// @brief Versão do formato gravada no cabeçalho.
+#define VERSAO_REVISAO 2
+
+/// @brief Intervalo padrão entre os quadros-chave, em ações.
+#define INTERVALO_PADRAO_QUADROS 1024
+
+/// @brief Tamanho de um quadro-chave, em bytes.
+#define TAM_QUADRO_CHAVE (8 + 2 + 9 * TAM_MAX_FILA + 1 + 9 * TAM_MAX_PILHA + 1 + 24 + 16 + 1 + 2 * TOTAL_TIPOS_PECA + 18)
+
+/// @brief Tamanho de cada entrada do índice, em bytes.
+#define TAM_ENTRADA_QUADRO 16
+
+/// @brief Quantidade máxima de quadros-chave de uma gravação(o índice é reservado na abertura, sem
+/// realocações). Com o intervalo padrão, cerca de 1 bilhão de ações.
+#ifndef TAM_MAX_QUADROS_REVISAO
+#define TAM_MAX_QUADROS_REVISAO 1048576
+#endif
+
+// **** Declarações de estruturas. ****
+
+/// @brief Gravador para revisão.
+typedef struct {
+	FILE* arquivo;
+	/// @brief Índice dos quadros-chave(número da ação e posição, intercalados).
+	uint64_t* indice;
+	uint32_t totalQuadros;
+	uint32_t capacidadeIndice;
+	uint32_t intervalo;
+	uint32_t acoesDesdeQuadro;
+	uint64_t totalAcoes;
+	/// @brief Posição atual no arquivo, em bytes.
+	uint64_t posicao;
+	/// @brief Limite do bloco de identificações no último quadro-chave(um novo bloco exige um quadro-chave).
+	int64_t limiteIds;
+	/// @brief Pesos do gerador no último quadro-chave(uma nova distribuição exige um quadro-chave).
+	uint16_t pesos[TOTAL_TIPOS_PECA];
+	bool falhou;
+} GravadorRevisao;
+
+/// @brief Leitor para revisão, sobre o arquivo mapeado em memória.
+typedef struct {
+	const uint8_t* base;
+	size_t tamanho;
+	/// @brief Índice dos quadros-chave, no próprio mapeamento.
+	const uint8_t* indice;
+	uint32_t totalQuadros;
+	uint64_t totalAcoes;
+} LeitorRevisao;
+
+// **** Declarações das funções. ****
+
+/// @brief Cria o arquivo de revisão, e grava o cabeçalho e o quadro-chave inicial da sessão.
+/// @param GravadorRevisao. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Caminho do arquivo de destino.
+/// @param Sessao. Ponteiro da sessão inicializada, com gerador de peças. Somente leitura.
+/// @param Inteiro. Intervalo entre os quadros-chave, em ações. Ex: INTERVALO_PADRAO_QUADROS.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool abrirRevisao(GravadorRevisao* gravador, const char* caminho, const Sessao* sessao, uint32_t intervalo);
+/// @brief Grava uma ação aplicada à sessão(com sucesso ou não) e, se for o caso, um quadro-chave.
+/// @param GravadorRevisao. Ponteiro via referência, usado na gravação.
+/// @param Sessao. Ponteiro da sessão, após a ação. Somente leitura.
+/// @param CodigoAcao. Ação aplicada.
+void gravarAcaoRevisao(GravadorRevisao* gravador, const Sessao* sessao, CodigoAcao acao);
+/// @brief Grava o índice e o rodapé, e fecha o arquivo.
+/// @param GravadorRevisao. Ponteiro via referência, a ser finalizado.
+/// @returns Verdadeiro(true), se toda a gravação foi escrita com sucesso. Caso contrário, Falso(false).
+bool fecharRevisao(GravadorRevisao* gravador);
+
+/// @brief Mapeia um arquivo de revisão em memória e valida o rodapé e o índice.
+/// @param LeitorRevisao. Ponteiro via referência, para efetuar a inicialização.
+/// @param Texto. Caminho do arquivo.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o arquivo não existir ou for inválido.
+bool abrirLeitorRevisao(LeitorRevisao* leitor, const char* caminho);
+/// @brief Restaura o estado da sessão após uma quantidade de ações: o quadro-chave anterior mais próximo
+/// e as ações seguintes a ele.
+/// @param LeitorRevisao. Ponteiro do leitor. Somente leitura.
+/// @param Inteiro. Quantidade de ações aplicadas(de 0 a totalAcoes).
+/// @param Sessao. Ponteiro via referência, a conter a sessão restaurada.
+/// @param GeradorPecas. Ponteiro via referência, a conter o gerador da sessão restaurada(com a sua distribuição).
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se a ação não existir ou o arquivo for inválido.
+bool buscarAcaoRevisao(const LeitorRevisao* leitor, uint64_t acao, Sessao* sessao, GeradorPecas* gerador);
+/// @brief Desfaz o mapeamento do arquivo.
+/// @param LeitorRevisao. Ponteiro via referência, a ser finalizado.
+void fecharLeitorRevisao(LeitorRevisao* leitor);
+
+#endif // TETRIS_REVISAO_H
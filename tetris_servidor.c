@@ -0,0 +1,414 @@
+#ifdef __linux__
+// Necessário para accept4.
+#define _GNU_SOURCE
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_servidor.h"
+#include "tetris_rastro.h"
+#ifdef __linux__
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+// **** Implementações das funções. ****
+
+#ifndef __linux__
+// Demais plataformas: o servidor depende do epoll.
+
+bool executarServidor(const char* caminho, RegiaoObservacao* observacao, ExportadorColunas* colunas,
+	const uint16_t* pesos, EstatisticasServidor* estatisticas)
+{
+	memset(estatisticas, 0, sizeof(*estatisticas));
+	return false;
+}
+
+#else
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade máxima de eventos tratados a cada espera do epoll.
+#define TAM_MAX_EVENTOS_EPOLL 256
+
+// **** Declarações de estruturas. ****
+
+/// @brief Estado de uma conexão: a sessão do cliente e os buffers de entrada e saída.
+typedef struct Conexao {
+	int descritor;
+	Sessao sessao;
+	/// @brief Gerador de peças da sessão, se houver uma distribuição ponderada(pesosServidor).
+	GeradorPecas gerador;
+	uint8_t entrada[TAM_MAX_REQUISICAO];
+	uint32_t tamanhoEntrada;
+	uint8_t saida[TAM_MAX_RESPOSTA];
+	uint32_t tamanhoSaida;
+	uint32_t enviados;
+	/// @brief Indica se o epoll aguarda escrita(EPOLLOUT), em vez de leitura(EPOLLIN).
+	bool aguardandoEscrita;
+	/// @brief Próxima conexão livre, enquanto a conexão não está em uso.
+	struct Conexao* proximaLivre;
+} Conexao;
+
+// **** Variáveis internas. ****
+
+/// @brief Conexões pré-alocadas. Nenhuma alocação ocorre durante a execução do servidor.
+static Conexao conexoes[TAM_MAX_CONEXOES];
+/// @brief Lista de conexões livres.
+static Conexao* conexoesLivres = NULL;
+/// @brief Sinaliza o encerramento do laço de eventos.
+static volatile sig_atomic_t encerrarServidor = 0;
+/// @brief Região de observação da execução atual, ou NULL.
+static RegiaoObservacao* regiaoObservacao = NULL;
+/// @brief Exportação em colunas da execução atual, ou NULL.
+static ExportadorColunas* colunasServidor = NULL;
+/// @brief Pesos dos tipos de peça das sessões da execução atual, ou NULL(peças aleatórias).
+static const uint16_t* pesosServidor = NULL;
+
+// **** Implementações das funções. ****
+
+/// @brief Solicita o encerramento do laço de eventos, ao receber um sinal.
+static void tratarSinalServidor(int sinal)
+{
+	encerrarServidor = 1;
+}
+
+/// @brief Escreve um inteiro de 64 bits em little-endian.
+static uint8_t* escreverInteiro(uint8_t* destino, uint64_t valor)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		destino[i] = (uint8_t)(valor >> (8 * i));
+	}
+	return destino + 8;
+}
+
+/// @brief Escreve uma peça(tipo e id) na resposta.
+static uint8_t* escreverPeca(uint8_t* destino, Peca peca)
+{
+	*destino++ = (uint8_t)peca.tipo;
+	return escreverInteiro(destino, (uint64_t)peca.id);
+}
+
+/// @brief Aplica um lote de ações à sessão da conexão e monta a resposta no buffer de saída.
+static void responderLote(Conexao* conexao, const uint8_t* acoes, uint16_t quantidade)
+{
+	uint8_t* saida = conexao->saida;
+	*saida++ = (uint8_t)quantidade;
+	*saida++ = (uint8_t)(quantidade >> 8);
+
+	iniciarRastro("loteServidor");
+	for (uint16_t i = 0; i < quantidade; i++)
+	{
+		CodigoAcao acao = (CodigoAcao)acoes[i];
+		RegistroAcao registro;
+		ResultadoAcao resultado = aplicarAcao(&conexao->sessao, acao, colunasServidor != NULL ? &registro : NULL);
+		*saida++ = (uint8_t)resultado;
+		if (colunasServidor != NULL && acao > ACAO_SAIR && acao < TOTAL_ACOES)
+		{
+			registrarColunas(colunasServidor, &conexao->sessao, acao, resultado, &registro);
+		}
+		if (regiaoObservacao != NULL)
+		{
+			publicarObservacao(regiaoObservacao, (int)(conexao - conexoes), &conexao->sessao, acao);
+		}
+	}
+	finalizarRastro("loteServidor");
+
+	const Fila* fila = &conexao->sessao.fila;
+	const Pilha* pilha = &conexao->sessao.pilha;
+
+	saida = escreverInteiro(saida, (uint64_t)conexao->sessao.ids.emitidos);
+	*saida++ = (uint8_t)fila->total;
+	for (int i = 0, idx = fila->inicio; i < fila->total; i++, idx = avancarFila(idx))
+	{
+		saida = escreverPeca(saida, fila->itens[idx]);
+	}
+	*saida++ = (uint8_t)(pilha->topo + 1);
+	for (int i = 0; i <= pilha->topo; i++)
+	{
+		saida = escreverPeca(saida, pilha->itens[i]);
+	}
+
+	const Pontuacao* pontuacao = &conexao->sessao.pontuacao;
+	saida = escreverInteiro(saida, (uint64_t)pontuacao->pontos);
+	saida = escreverInteiro(saida, (uint64_t)pontuacao->linhas);
+	*saida++ = (uint8_t)pontuacao->nivel;
+	*saida++ = (uint8_t)(pontuacao->combo + 1);
+
+	conexao->tamanhoSaida = (uint32_t)(saida - conexao->saida);
+	conexao->enviados = 0;
+}
+
+/// @brief Envia o quanto for possível da resposta pendente, sem bloquear.
+/// @returns Verdadeiro(true), se a conexão continua válida. Falso(false), em caso de falha.
+static bool enviarResposta(Conexao* conexao)
+{
+	while (conexao->enviados < conexao->tamanhoSaida)
+	{
+		ssize_t enviados = send(conexao->descritor, conexao->saida + conexao->enviados,
+			conexao->tamanhoSaida - conexao->enviados, MSG_NOSIGNAL);
+		if (enviados < 0)
+		{
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		conexao->enviados += (uint32_t)enviados;
+	}
+
+	conexao->tamanhoSaida = 0;
+	conexao->enviados = 0;
+	return true;
+}
+
+/// @brief Processa as requisições completas da entrada, uma de cada vez: enquanto houver resposta
+/// pendente, as próximas requisições aguardam no buffer.
+/// @returns Verdadeiro(true), se a conexão continua válida. Falso(false), se a requisição for inválida.
+static bool processarRequisicoes(Conexao* conexao, EstatisticasServidor* estatisticas)
+{
+	while (conexao->tamanhoSaida == 0 && conexao->tamanhoEntrada >= 2)
+	{
+		uint16_t quantidade = (uint16_t)(conexao->entrada[0] | conexao->entrada[1] << 8);
+		if (quantidade > TAM_MAX_LOTE)
+		{
+			estatisticas->invalidas++;
+			return false;
+		}
+
+		uint32_t tamanho = 2u + quantidade;
+		if (conexao->tamanhoEntrada < tamanho)
+		{
+			break;
+		}
+
+		responderLote(conexao, conexao->entrada + 2, quantidade);
+		estatisticas->lotes++;
+		estatisticas->acoes += quantidade;
+
+		conexao->tamanhoEntrada -= tamanho;
+		memmove(conexao->entrada, conexao->entrada + tamanho, conexao->tamanhoEntrada);
+
+		if (!enviarResposta(conexao))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// @brief Atualiza os eventos de interesse da conexão: escrita, enquanto houver resposta pendente.
+/// Caso contrário, leitura.
+static void atualizarInteresse(int epoll, Conexao* conexao)
+{
+	bool aguardandoEscrita = conexao->tamanhoSaida > 0;
+	if (aguardandoEscrita == conexao->aguardandoEscrita)
+	{
+		return; // Sem alteração, sem chamada de sistema.
+	}
+	conexao->aguardandoEscrita = aguardandoEscrita;
+
+	struct epoll_event evento = { 0 };
+	evento.events = aguardandoEscrita ? EPOLLOUT : EPOLLIN;
+	evento.data.ptr = conexao;
+	epoll_ctl(epoll, EPOLL_CTL_MOD, conexao->descritor, &evento);
+}
+
+/// @brief Fecha a conexão e a devolve à lista de livres.
+static void fecharConexao(int epoll, Conexao* conexao)
+{
+	epoll_ctl(epoll, EPOLL_CTL_DEL, conexao->descritor, NULL);
+	close(conexao->descritor);
+	conexao->descritor = -1;
+	conexao->proximaLivre = conexoesLivres;
+	conexoesLivres = conexao;
+}
+
+/// @brief Aceita todas as conexões pendentes, cada uma com uma nova sessão.
+static void aceitarConexoes(int epoll, int servidor, EstatisticasServidor* estatisticas)
+{
+	for (;;)
+	{
+		int descritor = accept4(servidor, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (descritor < 0)
+		{
+			return;
+		}
+
+		if (conexoesLivres == NULL)
+		{
+			estatisticas->recusadas++;
+			close(descritor);
+			continue;
+		}
+
+		Conexao* conexao = conexoesLivres;
+		conexoesLivres = conexao->proximaLivre;
+		conexao->descritor = descritor;
+		conexao->tamanhoEntrada = 0;
+		conexao->tamanhoSaida = 0;
+		conexao->enviados = 0;
+		conexao->aguardandoEscrita = false;
+		if (pesosServidor != NULL)
+		{
+			// Cada conexão tem o seu gerador, com semente sorteada(srand do chamador).
+			inicializarGerador(&conexao->gerador, ((uint64_t)rand() << 32) ^ (uint64_t)rand());
+			definirPesosGerador(&conexao->gerador, pesosServidor);
+			inicializarSessaoComGerador(&conexao->sessao, &conexao->gerador);
+		}
+		else
+		{
+			inicializarSessao(&conexao->sessao);
+		}
+		if (regiaoObservacao != NULL)
+		{
+			publicarObservacao(regiaoObservacao, (int)(conexao - conexoes), &conexao->sessao, ACAO_SAIR);
+		}
+
+		struct epoll_event evento = { 0 };
+		evento.events = EPOLLIN;
+		evento.data.ptr = conexao;
+		if (epoll_ctl(epoll, EPOLL_CTL_ADD, descritor, &evento) != 0)
+		{
+			close(descritor);
+			conexao->proximaLivre = conexoesLivres;
+			conexoesLivres = conexao;
+			continue;
+		}
+
+		estatisticas->conexoes++;
+	}
+}
+
+/// @brief Trata um evento de uma conexão.
+/// @returns Verdadeiro(true), se a conexão continua válida. Falso(false), se deve ser fechada.
+static bool tratarConexao(Conexao* conexao, uint32_t eventos, EstatisticasServidor* estatisticas)
+{
+	if (eventos & (EPOLLERR | EPOLLHUP))
+	{
+		return false;
+	}
+
+	if (eventos & EPOLLOUT)
+	{
+		if (!enviarResposta(conexao))
+		{
+			return false;
+		}
+	}
+
+	if (eventos & EPOLLIN)
+	{
+		ssize_t lidos = recv(conexao->descritor, conexao->entrada + conexao->tamanhoEntrada,
+			TAM_MAX_REQUISICAO - conexao->tamanhoEntrada, 0);
+		if (lidos == 0)
+		{
+			return false; // O cliente encerrou a conexão.
+		}
+		if (lidos < 0)
+		{
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		conexao->tamanhoEntrada += (uint32_t)lidos;
+	}
+
+	return processarRequisicoes(conexao, estatisticas);
+}
+
+bool executarServidor(const char* caminho, RegiaoObservacao* observacao, ExportadorColunas* colunas,
+	const uint16_t* pesos, EstatisticasServidor* estatisticas)
+{
+	memset(estatisticas, 0, sizeof(*estatisticas));
+
+	struct sockaddr_un endereco = { 0 };
+	if (strlen(caminho) >= sizeof(endereco.sun_path))
+	{
+		return false;
+	}
+	endereco.sun_family = AF_UNIX;
+	strcpy(endereco.sun_path, caminho);
+
+	int servidor = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (servidor < 0)
+	{
+		return false;
+	}
+
+	// Um socket deixado por uma execução anterior impediria o bind.
+	unlink(caminho);
+	int epoll = -1;
+	if (bind(servidor, (struct sockaddr*)&endereco, sizeof(endereco)) != 0
+		|| listen(servidor, SOMAXCONN) != 0
+		|| (epoll = epoll_create1(EPOLL_CLOEXEC)) < 0)
+	{
+		close(servidor);
+		unlink(caminho);
+		return false;
+	}
+
+	struct epoll_event evento = { 0 };
+	evento.events = EPOLLIN;
+	evento.data.ptr = NULL; // NULL identifica o socket do servidor.
+	epoll_ctl(epoll, EPOLL_CTL_ADD, servidor, &evento);
+
+	regiaoObservacao = observacao;
+	pesosServidor = pesos;
+	colunasServidor = colunas;
+	conexoesLivres = NULL;
+	for (int i = TAM_MAX_CONEXOES - 1; i >= 0; i--)
+	{
+		conexoes[i].descritor = -1;
+		conexoes[i].proximaLivre = conexoesLivres;
+		conexoesLivres = &conexoes[i];
+	}
+
+	// Sem SA_RESTART: o sinal interrompe o epoll_wait, e o laço verifica a flag.
+	struct sigaction acao = { 0 };
+	acao.sa_handler = tratarSinalServidor;
+	sigemptyset(&acao.sa_mask);
+	sigaction(SIGINT, &acao, NULL);
+	sigaction(SIGTERM, &acao, NULL);
+	encerrarServidor = 0;
+
+	struct epoll_event eventos[TAM_MAX_EVENTOS_EPOLL];
+	while (!encerrarServidor)
+	{
+		int total = epoll_wait(epoll, eventos, TAM_MAX_EVENTOS_EPOLL, -1);
+
+		for (int i = 0; i < total; i++)
+		{
+			Conexao* conexao = eventos[i].data.ptr;
+			if (conexao == NULL)
+			{
+				aceitarConexoes(epoll, servidor, estatisticas);
+				continue;
+			}
+
+			if (tratarConexao(conexao, eventos[i].events, estatisticas))
+			{
+				atualizarInteresse(epoll, conexao);
+			}
+			else
+			{
+				fecharConexao(epoll, conexao);
+			}
+		}
+	}
+
+	for (int i = 0; i < TAM_MAX_CONEXOES; i++)
+	{
+		if (conexoes[i].descritor >= 0)
+		{
+			close(conexoes[i].descritor);
+		}
+	}
+	close(epoll);
+	close(servidor);
+	unlink(caminho);
+
+	return true;
+}
+
+#endif
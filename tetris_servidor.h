@@ -0,0 +1,74 @@
+#ifndef TETRIS_SERVIDOR_H
+#define TETRIS_SERVIDOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_colunas.h"
+#include "tetris_nucleo.h"
+#include "tetris_observacao.h"
+
+// Desafio Tetris Stack
+// Servidor local para bots, em socket Unix(AF_UNIX), com laço de eventos epoll(somente Linux).
+// Cada conexão possui a sua própria sessão. O cliente envia um lote de ações, o servidor as aplica
+// e responde, em uma única mensagem, os resultados e o estado da fila e da pilha.
+//
+// Protocolo binário(inteiros em little-endian):
+//   requisição: quantidade de ações(2 bytes, até TAM_MAX_LOTE), e um byte por ação(CodigoAcao, de 1 a 5).
+//               Uma requisição sem ações apenas consulta o estado.
+//   resposta:   quantidade de ações(2 bytes), um byte de resultado por ação(ResultadoAcao),
+//               total de peças geradas na sessão(8 bytes), total da fila(1 byte) e as peças da frente para o fim,
+//               total da pilha(1 byte) e as peças da base para o topo. Cada peça: tipo(1 byte) e id(8 bytes).
+//               Por fim, a pontuação: pontos(8 bytes), linhas(8 bytes), nível(1 byte) e etapa do combo + 1
+//               (1 byte, 0 se não houver combo).
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade máxima de ações em um lote.
+#define TAM_MAX_LOTE 1024
+
+/// @brief Quantidade máxima de conexões simultâneas.
+#define TAM_MAX_CONEXOES 4096
+
+/// @brief Tamanho de uma peça na resposta(tipo e id).
+#define TAM_PECA_PROTOCOLO 9
+
+/// @brief Tamanho da pontuação na resposta(pontos, linhas, nível e combo).
+#define TAM_PONTUACAO_PROTOCOLO 18
+
+/// @brief Tamanho máximo de uma requisição, em bytes.
+#define TAM_MAX_REQUISICAO (2 + TAM_MAX_LOTE)
+
+/// @brief Tamanho máximo de uma resposta, em bytes.
+#define TAM_MAX_RESPOSTA (2 + TAM_MAX_LOTE + 8 + 1 + TAM_MAX_FILA * TAM_PECA_PROTOCOLO + 1 + TAM_MAX_PILHA * TAM_PECA_PROTOCOLO + TAM_PONTUACAO_PROTOCOLO)
+
+// **** Declarações de estruturas. ****
+
+/// @brief Contadores do servidor, para o resumo ao encerrar.
+typedef struct {
+	uint64_t conexoes;
+	/// @brief Conexões recusadas por excederem TAM_MAX_CONEXOES.
+	uint64_t recusadas;
+	uint64_t lotes;
+	uint64_t acoes;
+	/// @brief Conexões encerradas por requisições inválidas.
+	uint64_t invalidas;
+} EstatisticasServidor;
+
+// **** Declarações das funções. ****
+
+/// @brief Executa o servidor até receber um sinal de encerramento(SIGINT ou SIGTERM).
+/// O arquivo do socket é removido ao encerrar.
+/// @param Texto. Caminho do socket Unix a ser criado.
+/// @param RegiaoObservacao. Ponteiro opcional(pode ser NULL), para a publicação do estado de cada conexão,
+/// após cada ação, no slot de mesmo índice da conexão.
+/// @param ExportadorColunas. Ponteiro opcional(pode ser NULL), para a exportação em colunas das ações
+/// válidas(de 1 a 5) de todas as conexões, na ordem em que são aplicadas.
+/// @param Inteiro. Pesos dos tipos de peça das sessões(vetor de TOTAL_TIPOS_PECA, ver definirPesosGerador),
+/// ou NULL, para as peças aleatórias(gerarPeca).
+/// @param EstatisticasServidor. Ponteiro via referência, para conter os contadores do servidor.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se o socket não pôde ser criado,
+/// ou se a plataforma não for suportada.
+bool executarServidor(const char* caminho, RegiaoObservacao* observacao, ExportadorColunas* colunas,
+	const uint16_t* pesos, EstatisticasServidor* estatisticas);
+
+#endif // TETRIS_SERVIDOR_H
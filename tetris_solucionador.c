@@ -0,0 +1,256 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+// Se estivermos no windows, vamos incluir usar uma saída de console com padrão adequado para utf-8.
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "tetris_grafo.h"
+#include "tetris_memoria.h"
+#include "tetris_tempo.h"
+#include "tetris_transicoes.h"
+
+// Desafio Tetris Stack
+// Solucionador do grafo de estados(tetris_grafo.h): distâncias e alcançabilidade de todos os estados.
+//
+// Sem objetivo, a busca parte dos estados iniciais das sessões(fila cheia, pilha vazia, sem troca) e
+// calcula o mínimo de ações até cada estado. Com --pilha TIPOS, a busca é retrógrada: parte dos estados
+// cuja pilha contém exatamente os tipos informados(da base ao topo), e calcula o mínimo de ações de cada
+// estado até o objetivo. Os estados alcançáveis que não chegam ao objetivo são becos sem saída.
+//
+// Com --acoes, somente as ações informadas formam o grafo(ex: --acoes 45, somente as trocas), para
+// analisar regras isoladas. Com --distancias ARQUIVO, a distância de cada estado(1 byte, na ordem dos
+// índices de tetris_transicoes.h, DISTANCIA_INALCANCAVEL se não houver caminho) é gravada em arquivo.
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de estados iniciais: todas as configurações da fila, com a pilha vazia e sem troca.
+#define TOTAL_ESTADOS_INICIAIS TOTAL_CONFIGURACOES_FILA
+
+// **** Declarações das funções. ****
+
+/// @brief Interpreta a máscara de ações(dígitos de 1 a 5).
+/// @param Texto. Dígitos das ações. Ex: "45".
+/// @returns Inteiro. Máscara(bit de cada CodigoAcao), ou 0 se o texto for inválido.
+uint32_t interpretarAcoes(const char* texto);
+/// @brief Exibe o histograma das distâncias.
+/// @param Inteiro. Distâncias de todos os estados. Somente leitura.
+void mostrarHistograma(const uint8_t* distancias);
+/// @brief Grava as distâncias de todos os estados em arquivo.
+/// @param Texto. Caminho do arquivo.
+/// @param Inteiro. Distâncias de todos os estados. Somente leitura.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário, Falso(false).
+bool gravarDistancias(const char* caminho, const uint8_t* distancias);
+
+/// @brief Ponto de entrada do programa.
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: --pilha TIPOS, --acoes DIGITOS, --distancias ARQUIVO.
+/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, em caso de falha. Ex: EXIT_FAILURE.
+int main(int argc, char* argv[]);
+
+// **** Implementações das funções. ****
+
+int main(int argc, char* argv[]) {
+
+	// Configurações de caracteres para ajuste de ortografia para saída do console(UTF-8).
+#ifdef _WIN32
+	// Plataforma Windows.
+	SetConsoleOutputCP(CP_UTF8);
+#endif
+
+	const char* objetivo = NULL;
+	const char* arquivoDistancias = NULL;
+	uint32_t mascara = TODAS_ACOES_GRAFO;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--pilha") == 0 && i + 1 < argc && strlen(argv[i + 1]) <= TAM_MAX_PILHA
+			&& strspn(argv[i + 1], TIPOS_PECA) == strlen(argv[i + 1]))
+		{
+			objetivo = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "--acoes") == 0 && i + 1 < argc && interpretarAcoes(argv[i + 1]) != 0)
+		{
+			mascara = interpretarAcoes(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--distancias") == 0 && i + 1 < argc)
+		{
+			arquivoDistancias = argv[++i];
+			continue;
+		}
+		printf("Uso: %s [--pilha TIPOS] [--acoes DIGITOS] [--distancias ARQUIVO]\n", argv[0]);
+		printf("Ex: %s --pilha ITL --acoes 1245\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	int threads = 1;
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#endif
+
+	int64_t inicioNs = relogioMonotonicoNs();
+	TabelaTransicoes tabela;
+	GrafoEstados grafo;
+	GrafoEstados direto = { NULL, NULL, 0 };
+	uint8_t* distancias = alocarMemoria(TOTAL_ESTADOS);
+	uint8_t* alcancaveis = alocarMemoria(TOTAL_ESTADOS);
+	int32_t* origens = alocarMemoria((size_t)TOTAL_ESTADOS * sizeof(int32_t));
+	if (distancias == NULL || alcancaveis == NULL || origens == NULL || !gerarTabelaTransicoes(&tabela))
+	{
+		printf("\n==== ⚠️  Memória insuficiente para o grafo de estados. ====\n");
+		return EXIT_FAILURE;
+	}
+	bool construido = construirGrafo(&tabela, mascara, objetivo != NULL, &grafo)
+		&& (objetivo == NULL || construirGrafo(&tabela, mascara, false, &direto));
+	if (!construido)
+	{
+		printf("\n==== ⚠️  Memória insuficiente para o grafo de estados. ====\n");
+		return EXIT_FAILURE;
+	}
+	int64_t construcaoNs = relogioMonotonicoNs() - inicioNs;
+
+	// Estados iniciais das sessões: pilha vazia(índice 0) e sem troca.
+	int32_t iniciais[TOTAL_ESTADOS_INICIAIS];
+	for (int32_t f = 0; f < TOTAL_ESTADOS_INICIAIS; f++)
+	{
+		iniciais[f] = f * 2;
+	}
+
+	int32_t totalOrigens = 0;
+	if (objetivo == NULL)
+	{
+		memcpy(origens, iniciais, sizeof(iniciais));
+		totalOrigens = TOTAL_ESTADOS_INICIAIS;
+	}
+	else
+	{
+		int totalPilha = (int)strlen(objetivo);
+		for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+		{
+			EstadoTipos tipos;
+			decodificarEstado(estado, &tipos);
+			if (tipos.totalPilha == totalPilha && memcmp(tipos.pilha, objetivo, (size_t)totalPilha) == 0)
+			{
+				origens[totalOrigens++] = estado;
+			}
+		}
+	}
+
+	printf("==== Solucionador: %d estados, %d arestas, %d threads(grafo construído em %.3f s). ====\n",
+		TOTAL_ESTADOS, grafo.totalArestas, threads, construcaoNs / 1e9);
+
+	inicioNs = relogioMonotonicoNs();
+	int32_t alcancados = buscarLargura(&grafo, origens, totalOrigens, distancias);
+	int32_t totalAlcancaveis = objetivo != NULL ? buscarLargura(&direto, iniciais, TOTAL_ESTADOS_INICIAIS, alcancaveis) : alcancados;
+	int64_t buscaNs = relogioMonotonicoNs() - inicioNs;
+	if (alcancados < 0 || totalAlcancaveis < 0)
+	{
+		printf("\n==== ⚠️  Memória insuficiente para a busca. ====\n");
+		return EXIT_FAILURE;
+	}
+
+	if (objetivo == NULL)
+	{
+		printf("\n==== Distâncias a partir dos %d estados iniciais ====\n", TOTAL_ESTADOS_INICIAIS);
+		mostrarHistograma(distancias);
+		printf("Alcançáveis: %d. Inalcançáveis: %d.\n", alcancados, TOTAL_ESTADOS - alcancados);
+
+		// Becos: estados alcançáveis sem nenhuma ação efetuada com sucesso(entre as ações consideradas).
+		int32_t becos = 0;
+		for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+		{
+			becos += distancias[estado] != DISTANCIA_INALCANCAVEL && grafo.inicio[estado] == grafo.inicio[estado + 1];
+		}
+		printf("Becos sem saída(sem ações possíveis): %d.\n", becos);
+	}
+	else
+	{
+		printf("\n==== Distâncias até a pilha %s(%d estados de objetivo) ====\n", objetivo, totalOrigens);
+		mostrarHistograma(distancias);
+
+		int minimo = DISTANCIA_INALCANCAVEL;
+		for (int32_t f = 0; f < TOTAL_ESTADOS_INICIAIS; f++)
+		{
+			minimo = distancias[iniciais[f]] < minimo ? distancias[iniciais[f]] : minimo;
+		}
+		int32_t becos = 0;
+		for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+		{
+			becos += alcancaveis[estado] != DISTANCIA_INALCANCAVEL && distancias[estado] == DISTANCIA_INALCANCAVEL;
+		}
+		if (minimo == DISTANCIA_INALCANCAVEL)
+		{
+			printf("Mínimo de ações a partir de um estado inicial: sem caminho.\n");
+		}
+		else
+		{
+			printf("Mínimo de ações a partir de um estado inicial: %d.\n", minimo);
+		}
+		printf("Estados alcançáveis: %d. Becos sem saída(alcançáveis, sem caminho até o objetivo): %d.\n",
+			totalAlcancaveis, becos);
+	}
+	printf("Busca: %.3f s.\n", buscaNs / 1e9);
+
+	bool sucesso = arquivoDistancias == NULL || gravarDistancias(arquivoDistancias, distancias);
+	if (!sucesso)
+	{
+		printf("\n==== ⚠️  Não foi possível gravar as distâncias em %s. ====\n", arquivoDistancias);
+	}
+
+	liberarGrafo(&grafo);
+	liberarGrafo(&direto);
+	liberarTabelaTransicoes(&tabela);
+	liberarMemoria(distancias);
+	liberarMemoria(alcancaveis);
+	liberarMemoria(origens);
+	return sucesso ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+uint32_t interpretarAcoes(const char* texto)
+{
+	uint32_t mascara = 0;
+	for (const char* c = texto; *c != '\0'; c++)
+	{
+		int acao = *c - '0';
+		if (acao < ACAO_JOGAR_PECA || acao >= TOTAL_ACOES)
+		{
+			return 0;
+		}
+		mascara |= 1u << acao;
+	}
+	return mascara;
+}
+
+void mostrarHistograma(const uint8_t* distancias)
+{
+	int32_t contagens[DISTANCIA_INALCANCAVEL + 1] = { 0 };
+	for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+	{
+		contagens[distancias[estado]]++;
+	}
+	for (int d = 0; d < DISTANCIA_INALCANCAVEL; d++)
+	{
+		if (contagens[d] > 0)
+		{
+			printf("Distância %3d: %7d estados\n", d, contagens[d]);
+		}
+	}
+}
+
+bool gravarDistancias(const char* caminho, const uint8_t* distancias)
+{
+	FILE* arquivo = fopen(caminho, "wb");
+	if (arquivo == NULL)
+	{
+		return false;
+	}
+	bool sucesso = fwrite(distancias, 1, TOTAL_ESTADOS, arquivo) == TOTAL_ESTADOS;
+	return (fclose(arquivo) == 0) && sucesso;
+}
@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "tetris_rastro.h"
+#include "tetris_tela.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade máxima de células inalteradas que são reescritas, em vez de reposicionar o cursor.
+/// Um posicionamento ANSI("\x1b[LL;CCH") custa até 8 bytes, então lacunas curtas saem mais baratas reescritas.
+#define LACUNA_MAXIMA_REESCRITA 4
+
+// **** Implementações das funções. ****
+
+/// @brief Calcula o tamanho, em bytes, de um caractere UTF-8 a partir do seu primeiro byte.
+static int tamanhoCaractereUtf8(unsigned char inicial)
+{
+	if (inicial < 0x80)
+	{
+		return 1;
+	}
+	if ((inicial & 0xE0) == 0xC0)
+	{
+		return 2;
+	}
+	if ((inicial & 0xF0) == 0xE0)
+	{
+		return 3;
+	}
+	return 4;
+}
+
+/// @brief Acrescenta bytes ao buffer de saída.
+static void acrescentarSaida(Tela* tela, const char* bytes, size_t tamanho)
+{
+	memcpy(tela->saida + tela->tamanhoSaida, bytes, tamanho);
+	tela->tamanhoSaida += tamanho;
+}
+
+/// @brief Acrescenta ao buffer de saída o posicionamento do cursor(linha e coluna a partir de 0).
+static void acrescentarPosicionamento(Tela* tela, int linha, int coluna)
+{
+	tela->tamanhoSaida += (size_t)snprintf(tela->saida + tela->tamanhoSaida,
+		sizeof(tela->saida) - tela->tamanhoSaida, "\x1b[%d;%dH", linha + 1, coluna + 1);
+}
+
+/// @brief Acrescenta ao buffer de saída o conteúdo de uma célula do quadro atual.
+static void acrescentarCelula(Tela* tela, int linha, int coluna)
+{
+	const char* bytes = tela->atual[linha][coluna].bytes;
+	acrescentarSaida(tela, bytes, strlen(bytes));
+}
+
+/// @brief Compara duas células.
+static bool celulasIguais(const Celula* a, const Celula* b)
+{
+	return strcmp(a->bytes, b->bytes) == 0;
+}
+
+/// @brief Envia todo o conteúdo do buffer ao terminal. Normalmente uma única chamada de write.
+static void enviarSaida(const char* bytes, size_t tamanho)
+{
+	// Qualquer texto pendente no buffer do stdio precisa sair antes do quadro.
+	fflush(stdout);
+
+	while (tamanho > 0)
+	{
+#ifdef _WIN32
+		int escritos = _write(1, bytes, (unsigned int)tamanho);
+#else
+		ssize_t escritos = write(STDOUT_FILENO, bytes, tamanho);
+#endif
+		if (escritos <= 0)
+		{
+			return;
+		}
+		bytes += escritos;
+		tamanho -= (size_t)escritos;
+	}
+}
+
+void inicializarTela(Tela* tela)
+{
+	tela->sincronizada = false;
+	tela->cursorLinha = 0;
+	tela->cursorColuna = 0;
+	tela->tamanhoSaida = 0;
+	memset(tela->linhaInvalida, 0, sizeof(tela->linhaInvalida));
+	limparQuadro(tela);
+}
+
+void limparQuadro(Tela* tela)
+{
+	for (int l = 0; l < TELA_LINHAS; l++)
+	{
+		for (int c = 0; c < TELA_COLUNAS; c++)
+		{
+			tela->atual[l][c].bytes[0] = ' ';
+			tela->atual[l][c].bytes[1] = '\0';
+		}
+	}
+}
+
+int escreverTela(Tela* tela, int linha, int coluna, const char* texto)
+{
+	if (linha < 0 || linha >= TELA_LINHAS)
+	{
+		return coluna;
+	}
+
+	const unsigned char* p = (const unsigned char*)texto;
+	while (*p != '\0' && coluna < TELA_COLUNAS)
+	{
+		int tamanho = tamanhoCaractereUtf8(*p);
+		Celula* celula = &tela->atual[linha][coluna];
+		int i = 0;
+
+		// Copiando o caractere, sem ultrapassar um eventual '\0' de uma sequência truncada.
+		for (; i < tamanho && p[i] != '\0'; i++)
+		{
+			celula->bytes[i] = (char)p[i];
+		}
+		celula->bytes[i] = '\0';
+
+		p += i;
+		coluna++;
+	}
+
+	return coluna;
+}
+
+int escreverTelaFormatado(Tela* tela, int linha, int coluna, const char* formato, ...)
+{
+	char texto[TELA_COLUNAS * TAM_MAX_CELULA + 1];
+	va_list argumentos;
+
+	va_start(argumentos, formato);
+	vsnprintf(texto, sizeof(texto), formato, argumentos);
+	va_end(argumentos);
+
+	return escreverTela(tela, linha, coluna, texto);
+}
+
+void posicionarCursorTela(Tela* tela, int linha, int coluna)
+{
+	tela->cursorLinha = linha;
+	tela->cursorColuna = coluna;
+}
+
+void invalidarLinhaTela(Tela* tela, int linha)
+{
+	if (linha >= 0 && linha < TELA_LINHAS)
+	{
+		tela->linhaInvalida[linha] = true;
+	}
+}
+
+size_t apresentarTela(Tela* tela)
+{
+	iniciarRastro("renderizacao");
+	tela->tamanhoSaida = 0;
+
+	if (!tela->sincronizada)
+	{
+		// Primeiro quadro: limpa o terminal. A partir daí, o quadro anterior é uma tela em branco,
+		// e somente as células não vazias são emitidas.
+		acrescentarSaida(tela, "\x1b[2J", 4);
+		for (int l = 0; l < TELA_LINHAS; l++)
+		{
+			for (int c = 0; c < TELA_COLUNAS; c++)
+			{
+				strcpy(tela->anterior[l][c].bytes, " ");
+			}
+		}
+	}
+
+	// Posição conhecida do cursor no terminal, durante a montagem(-1: desconhecida).
+	int linhaCursor = -1, colunaCursor = -1;
+
+	for (int l = 0; l < TELA_LINHAS; l++)
+	{
+		if (tela->linhaInvalida[l])
+		{
+			// Conteúdo desconhecido no terminal: reescrevemos a linha até o último caractere
+			// não vazio e limpamos o restante com "\x1b[K".
+			int ultima = TELA_COLUNAS - 1;
+			while (ultima >= 0 && strcmp(tela->atual[l][ultima].bytes, " ") == 0)
+			{
+				ultima--;
+			}
+
+			acrescentarPosicionamento(tela, l, 0);
+			for (int c = 0; c <= ultima; c++)
+			{
+				acrescentarCelula(tela, l, c);
+			}
+			acrescentarSaida(tela, "\x1b[K", 3);
+
+			tela->linhaInvalida[l] = false;
+			linhaCursor = l;
+			colunaCursor = ultima + 1;
+			continue;
+		}
+
+		// Indica se já houve alguma célula emitida nesta linha.
+		bool emitiuLinha = false;
+
+		for (int c = 0; c < TELA_COLUNAS; c++)
+		{
+			if (celulasIguais(&tela->atual[l][c], &tela->anterior[l][c]))
+			{
+				continue;
+			}
+
+			if (emitiuLinha && linhaCursor == l && colunaCursor <= c && c - colunaCursor <= LACUNA_MAXIMA_REESCRITA)
+			{
+				// Lacuna curta desde a última célula emitida: reescrevemos as células inalteradas.
+				for (int g = colunaCursor; g < c; g++)
+				{
+					acrescentarCelula(tela, l, g);
+				}
+			}
+			else if (linhaCursor != l || colunaCursor != c)
+			{
+				acrescentarPosicionamento(tela, l, c);
+			}
+
+			acrescentarCelula(tela, l, c);
+			emitiuLinha = true;
+			linhaCursor = l;
+			colunaCursor = c + 1;
+		}
+	}
+
+	// Nada mudou: não há o que enviar ao terminal.
+	if (tela->tamanhoSaida == 0)
+	{
+		finalizarRastro("renderizacao");
+		return 0;
+	}
+
+	acrescentarPosicionamento(tela, tela->cursorLinha, tela->cursorColuna);
+	enviarSaida(tela->saida, tela->tamanhoSaida);
+
+	memcpy(tela->anterior, tela->atual, sizeof(tela->atual));
+	tela->sincronizada = true;
+
+	finalizarRastro("renderizacao");
+	return tela->tamanhoSaida;
+}
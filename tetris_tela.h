@@ -0,0 +1,90 @@
+#ifndef TETRIS_TELA_H
+#define TETRIS_TELA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Desafio Tetris Stack
+// Renderizador de tela por diferenças: mantém o quadro anterior, compara célula a célula
+// com o quadro atual e emite somente as células alteradas, com posicionamento de cursor ANSI.
+// O quadro inteiro é montado em um único buffer e enviado com uma única escrita(write).
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de linhas da tela.
+#define TELA_LINHAS 24
+
+/// @brief Quantidade de colunas da tela.
+#define TELA_COLUNAS 80
+
+/// @brief Tamanho máximo, em bytes, de um caractere UTF-8 em uma célula.
+#define TAM_MAX_CELULA 4
+
+/// @brief Tamanho do buffer de saída. Comporta o pior caso: todas as células alteradas,
+/// cada uma com um posicionamento de cursor.
+#define TAM_MAX_SAIDA_TELA (TELA_LINHAS * TELA_COLUNAS * (TAM_MAX_CELULA + 12) + 64)
+
+// **** Declarações de estruturas. ****
+
+/// @brief Uma célula da tela, com um único caractere UTF-8(de largura simples) terminado em '\0'.
+typedef struct {
+	char bytes[TAM_MAX_CELULA + 1];
+} Celula;
+
+/// @brief Tela com o quadro atual(em montagem) e o quadro anterior(já exibido no terminal).
+typedef struct {
+	Celula atual[TELA_LINHAS][TELA_COLUNAS];
+	Celula anterior[TELA_LINHAS][TELA_COLUNAS];
+	/// @brief Linhas cujo conteúdo no terminal é desconhecido(ex: eco da digitação), redesenhadas por completo.
+	bool linhaInvalida[TELA_LINHAS];
+	/// @brief Indica se o quadro anterior reflete o terminal. Se não, a tela é limpa e redesenhada.
+	bool sincronizada;
+	/// @brief Linha(a partir de 0) onde o cursor ficará após a apresentação do quadro.
+	int cursorLinha;
+	/// @brief Coluna(a partir de 0) onde o cursor ficará após a apresentação do quadro.
+	int cursorColuna;
+	/// @brief Buffer de saída do quadro, enviado com uma única escrita.
+	char saida[TAM_MAX_SAIDA_TELA];
+	size_t tamanhoSaida;
+} Tela;
+
+// **** Declarações das funções. ****
+
+/// @brief Inicializa a tela. O primeiro quadro apresentado limpa o terminal e é desenhado por completo.
+/// @param Tela. Ponteiro via referência, para efetuar a inicialização.
+void inicializarTela(Tela* tela);
+/// @brief Preenche o quadro atual com espaços, para a montagem de um novo quadro.
+/// @param Tela. Ponteiro via referência, a ser limpo.
+void limparQuadro(Tela* tela);
+/// @brief Escreve um texto UTF-8 no quadro atual, a partir da posição informada. O texto é cortado
+/// no final da linha, e '\n' não é interpretado.
+/// @param Tela. Ponteiro via referência, usado na escrita.
+/// @param Inteiro. Linha(a partir de 0).
+/// @param Inteiro. Coluna(a partir de 0).
+/// @param Texto. Conteúdo a ser escrito.
+/// @returns Inteiro. A coluna seguinte ao último caractere escrito.
+int escreverTela(Tela* tela, int linha, int coluna, const char* texto);
+/// @brief Escreve um texto formatado(ao estilo printf) no quadro atual.
+/// @param Tela. Ponteiro via referência, usado na escrita.
+/// @param Inteiro. Linha(a partir de 0).
+/// @param Inteiro. Coluna(a partir de 0).
+/// @param Texto. Formato, seguido dos argumentos.
+/// @returns Inteiro. A coluna seguinte ao último caractere escrito.
+int escreverTelaFormatado(Tela* tela, int linha, int coluna, const char* formato, ...);
+/// @brief Define a posição do cursor após a apresentação do quadro.
+/// @param Tela. Ponteiro via referência.
+/// @param Inteiro. Linha(a partir de 0).
+/// @param Inteiro. Coluna(a partir de 0).
+void posicionarCursorTela(Tela* tela, int linha, int coluna);
+/// @brief Marca uma linha como desconhecida no terminal(ex: após o eco de uma digitação),
+/// forçando o seu redesenho completo no próximo quadro.
+/// @param Tela. Ponteiro via referência.
+/// @param Inteiro. Linha(a partir de 0).
+void invalidarLinhaTela(Tela* tela, int linha);
+/// @brief Compara o quadro atual com o anterior e envia ao terminal somente as células alteradas,
+/// com uma única escrita. O quadro atual passa a ser o anterior.
+/// @param Tela. Ponteiro via referência, a ser apresentada.
+/// @returns Inteiro. Quantidade de bytes enviados ao terminal.
+size_t apresentarTela(Tela* tela);
+
+#endif // TETRIS_TELA_H
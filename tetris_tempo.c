@@ -0,0 +1,108 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_tempo.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+// **** Implementações das funções. ****
+
+int64_t relogioMonotonicoNs(void)
+{
+#ifdef _WIN32
+	// Plataforma Windows.
+	static LARGE_INTEGER frequencia;
+	LARGE_INTEGER contador;
+	if (frequencia.QuadPart == 0)
+	{
+		QueryPerformanceFrequency(&frequencia);
+	}
+	QueryPerformanceCounter(&contador);
+	// Separando segundos e o resto, para evitar estouro na multiplicação.
+	return (contador.QuadPart / frequencia.QuadPart) * NS_POR_SEGUNDO
+		+ (contador.QuadPart % frequencia.QuadPart) * NS_POR_SEGUNDO / frequencia.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * NS_POR_SEGUNDO + ts.tv_nsec;
+#endif
+}
+
+void inicializarAgendador(Agendador* agendador, int64_t periodoNs)
+{
+	agendador->inicio = relogioMonotonicoNs();
+	agendador->periodo = periodoNs;
+	agendador->quadro = 0;
+	agendador->perdidos = 0;
+}
+
+int64_t proximoPrazo(const Agendador* agendador)
+{
+	return agendador->inicio + (agendador->quadro + 1) * agendador->periodo;
+}
+
+int64_t avancarAgendador(Agendador* agendador, int64_t agoraNs)
+{
+	int64_t atual = (agoraNs - agendador->inicio) / agendador->periodo;
+	int64_t vencidos = atual - agendador->quadro;
+
+	if (vencidos <= 0)
+	{
+		return 0;
+	}
+
+	// Mais de um quadro vencido significa que o laço atrasou. Os quadros intermediários
+	// são contabilizados, mas a grade de prazos continua alinhada ao instante inicial.
+	agendador->perdidos += vencidos - 1;
+	agendador->quadro = atual;
+
+	return vencidos;
+}
+
+void inicializarAmostrasLatencia(AmostrasLatencia* latencias)
+{
+	latencias->total = 0;
+}
+
+void registrarLatencia(AmostrasLatencia* latencias, int64_t latenciaNs)
+{
+	latencias->amostras[latencias->total % TAM_MAX_AMOSTRAS_LATENCIA] = latenciaNs;
+	latencias->total++;
+}
+
+/// @brief Função de comparação para ordenação crescente de latências via qsort.
+static int compararLatencias(const void* a, const void* b)
+{
+	int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+	return (x > y) - (x < y);
+}
+
+int64_t percentilLatencia(const AmostrasLatencia* latencias, double percentil)
+{
+	int64_t retidas = latencias->total < TAM_MAX_AMOSTRAS_LATENCIA ? latencias->total : TAM_MAX_AMOSTRAS_LATENCIA;
+
+	if (retidas == 0)
+	{
+		return 0;
+	}
+
+	// Ordenamos uma cópia, para não perder a ordem circular das amostras.
+	static int64_t ordenadas[TAM_MAX_AMOSTRAS_LATENCIA];
+	memcpy(ordenadas, latencias->amostras, (size_t)retidas * sizeof(int64_t));
+	qsort(ordenadas, (size_t)retidas, sizeof(int64_t), compararLatencias);
+
+	// Método do posto mais próximo(nearest-rank).
+	int64_t posto = (int64_t)(percentil / 100.0 * (double)retidas + 0.999999);
+	if (posto < 1)
+	{
+		posto = 1;
+	}
+	if (posto > retidas)
+	{
+		posto = retidas;
+	}
+
+	return ordenadas[posto - 1];
+}
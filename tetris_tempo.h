@@ -0,0 +1,73 @@
+#ifndef TETRIS_TEMPO_H
+#define TETRIS_TEMPO_H
+
+#include <stdint.h>
+
+// Desafio Tetris Stack
+// Relógio monotônico, agendador de quadros com período fixo e registro de latências.
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de nanossegundos em um segundo.
+#define NS_POR_SEGUNDO 1000000000LL
+
+/// @brief Quantidade máxima de amostras de latência retidas. As mais antigas são sobrescritas.
+#define TAM_MAX_AMOSTRAS_LATENCIA 4096
+
+// **** Declarações de estruturas. ****
+
+/// @brief Agendador de quadros com período fixo. Os prazos são sempre calculados a partir
+/// do instante inicial(inicio + quadro * periodo), e não do instante do último quadro,
+/// portanto atrasos pontuais não se acumulam(sem deriva).
+typedef struct {
+	/// @brief Instante inicial, em nanossegundos do relógio monotônico.
+	int64_t inicio;
+	/// @brief Duração de cada quadro, em nanossegundos.
+	int64_t periodo;
+	/// @brief Número do último quadro processado.
+	int64_t quadro;
+	/// @brief Total de quadros que venceram sem serem processados a tempo(atrasos).
+	int64_t perdidos;
+} Agendador;
+
+/// @brief Amostras de latência, em nanossegundos, para cálculo de percentis.
+typedef struct {
+	int64_t amostras[TAM_MAX_AMOSTRAS_LATENCIA];
+	/// @brief Total de amostras registradas(pode exceder a capacidade).
+	int64_t total;
+} AmostrasLatencia;
+
+// **** Declarações das funções. ****
+
+/// @brief Recupera o instante atual de um relógio monotônico(não sofre ajustes de data e hora).
+/// @returns Inteiro. Instante atual, em nanossegundos.
+int64_t relogioMonotonicoNs(void);
+
+/// @brief Inicializa o agendador a partir do instante atual.
+/// @param Agendador. Ponteiro via referência, para efetuar a inicialização.
+/// @param Inteiro. Duração de cada quadro, em nanossegundos.
+void inicializarAgendador(Agendador* agendador, int64_t periodoNs);
+/// @brief Calcula o prazo absoluto do próximo quadro.
+/// @param Agendador. Ponteiro usado no cálculo. Somente leitura.
+/// @returns Inteiro. Prazo do próximo quadro, em nanossegundos do relógio monotônico.
+int64_t proximoPrazo(const Agendador* agendador);
+/// @brief Avança o agendador até o instante informado.
+/// @param Agendador. Ponteiro via referência, para efetuar o avanço.
+/// @param Inteiro. Instante atual, em nanossegundos do relógio monotônico.
+/// @returns Inteiro. Quantidade de quadros vencidos desde o último avanço(zero se nenhum).
+int64_t avancarAgendador(Agendador* agendador, int64_t agoraNs);
+
+/// @brief Inicializa o registro de amostras de latência.
+/// @param AmostrasLatencia. Ponteiro via referência, para efetuar a inicialização.
+void inicializarAmostrasLatencia(AmostrasLatencia* latencias);
+/// @brief Registra uma nova amostra de latência.
+/// @param AmostrasLatencia. Ponteiro via referência, para efetuar o registro.
+/// @param Inteiro. Latência, em nanossegundos.
+void registrarLatencia(AmostrasLatencia* latencias, int64_t latenciaNs);
+/// @brief Calcula um percentil das amostras retidas.
+/// @param AmostrasLatencia. Ponteiro usado no cálculo. Somente leitura.
+/// @param double. Percentil desejado, entre 0 e 100. Ex: 99.0.
+/// @returns Inteiro. Latência do percentil, em nanossegundos. Zero, se não houver amostras.
+int64_t percentilLatencia(const AmostrasLatencia* latencias, double percentil);
+
+#endif // TETRIS_TEMPO_H
@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include "tetris_terminal.h"
+#include "tetris_tempo.h"
+#ifdef _WIN32
+#include <Windows.h>
+#include <conio.h>
+#else
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
+#endif
+
+// **** Implementações das funções. ****
+
+#ifdef _WIN32
+// Plataforma Windows. O console já entrega as teclas sem eco via _getch.
+
+bool ativarModoBruto(void)
+{
+	return true;
+}
+
+void restaurarModoTerminal(void)
+{
+}
+
+bool aguardarTecla(int64_t prazoNs)
+{
+	while (!_kbhit())
+	{
+		int64_t restante = prazoNs - relogioMonotonicoNs();
+		if (restante <= 0)
+		{
+			return false;
+		}
+		// Sleep tem resolução de milissegundos. O prazo absoluto evita que o erro se acumule.
+		Sleep(restante >= 2000000 ? 1 : 0);
+	}
+	return true;
+}
+
+int lerTecla(void)
+{
+	return _kbhit() ? _getch() : -1;
+}
+
+#else
+
+/// @brief Configuração original do terminal, restaurada ao sair.
+static struct termios configuracaoOriginal;
+/// @brief Indica se o modo bruto está ativo.
+static volatile sig_atomic_t modoBrutoAtivo = 0;
+
+/// @brief Restaura o terminal e encerra, ao receber um sinal de interrupção(ex: Ctrl+C).
+static void tratarSinalEncerramento(int sinal)
+{
+	if (modoBrutoAtivo)
+	{
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &configuracaoOriginal);
+	}
+	_exit(128 + sinal);
+}
+
+bool ativarModoBruto(void)
+{
+	if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &configuracaoOriginal) != 0)
+	{
+		return false;
+	}
+
+	struct termios bruto = configuracaoOriginal;
+	// Sem modo canônico(não aguarda Enter) e sem eco. Os sinais(Ctrl+C) continuam habilitados.
+	bruto.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+	bruto.c_cc[VMIN] = 0;
+	bruto.c_cc[VTIME] = 0;
+
+	if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &bruto) != 0)
+	{
+		return false;
+	}
+
+	modoBrutoAtivo = 1;
+	atexit(restaurarModoTerminal);
+	signal(SIGINT, tratarSinalEncerramento);
+	signal(SIGTERM, tratarSinalEncerramento);
+
+	return true;
+}
+
+void restaurarModoTerminal(void)
+{
+	if (modoBrutoAtivo)
+	{
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &configuracaoOriginal);
+		modoBrutoAtivo = 0;
+	}
+}
+
+bool aguardarTecla(int64_t prazoNs)
+{
+	int64_t restante = prazoNs - relogioMonotonicoNs();
+	if (restante < 0)
+	{
+		restante = 0;
+	}
+
+	fd_set leitura;
+	FD_ZERO(&leitura);
+	FD_SET(STDIN_FILENO, &leitura);
+
+	struct timespec espera;
+	espera.tv_sec = (time_t)(restante / NS_POR_SEGUNDO);
+	espera.tv_nsec = (long)(restante % NS_POR_SEGUNDO);
+
+	// pselect aceita a espera com resolução de nanossegundos, e retorna assim que houver entrada.
+	return pselect(STDIN_FILENO + 1, &leitura, NULL, NULL, &espera, NULL) > 0;
+}
+
+int lerTecla(void)
+{
+	unsigned char c;
+	return read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef TETRIS_TERMINAL_H
+#define TETRIS_TERMINAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Desafio Tetris Stack
+// Controle do terminal para o modo tempo real: modo bruto(sem eco e sem aguardar Enter)
+// e leitura de teclas sem bloqueio.
+
+// **** Declarações das funções. ****
+
+/// @brief Coloca o terminal em modo bruto: cada tecla fica disponível imediatamente, sem eco.
+/// O modo original é restaurado automaticamente ao sair do programa.
+/// @returns Verdadeiro(true), em caso de sucesso. Caso contrário(ex: entrada não é um terminal), Falso(false).
+bool ativarModoBruto(void);
+/// @brief Restaura o modo original do terminal, se o modo bruto estiver ativo.
+void restaurarModoTerminal(void);
+/// @brief Aguarda até que haja uma tecla disponível, ou até o prazo informado.
+/// @param Inteiro. Prazo absoluto, em nanossegundos do relógio monotônico.
+/// @returns Verdadeiro(true) se houver tecla disponível. Falso(false) se o prazo venceu.
+bool aguardarTecla(int64_t prazoNs);
+/// @brief Lê uma tecla sem bloquear.
+/// @returns Inteiro. O código da tecla, ou -1 se não houver tecla disponível.
+int lerTecla(void);
+
+#endif // TETRIS_TERMINAL_H
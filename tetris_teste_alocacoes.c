@@ -0,0 +1,151 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "tetris_nucleo.h"
+#include "tetris_colunas.h"
+#include "tetris_diario.h"
+#include "tetris_gravacao.h"
+#include "tetris_memoria.h"
+#include "tetris_metricas.h"
+#include "tetris_ramo.h"
+#include "tetris_revisao.h"
+
+// Desafio Tetris Stack
+// Teste(ctest) do regime permanente sem alocações: uma sessão sem interface, com a gravação, a revisão,
+// o diário, a exportação em colunas, as métricas e os ramos ativos, é inicializada e depois conduzida por
+// ações sorteadas. Após iniciarRegimePermanente, nenhuma alocação de memória pode ocorrer. Compilado com
+// a contagem de alocações(TETRIS_CONTAR_ALOCACOES), mesmo que a opção não esteja habilitada no projeto.
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de ações da sessão: suficiente para escrever vários blocos de cada arquivo.
+#define TOTAL_ACOES_TESTE 300000
+
+/// @brief Ações aplicadas a cada ramo(e à sua bifurcação), e quantidade de rodadas de ramos.
+#define ACOES_POR_RAMO 50
+#define RODADAS_RAMOS 2000
+
+/// @brief Tamanho máximo do caminho de cada arquivo gerado.
+#define TAM_MAX_CAMINHO_TESTE 1024
+
+// **** Declarações das funções. ****
+
+/// @brief Ponto de entrada do programa.
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: DIRETORIO(onde os arquivos temporários são criados).
+/// @returns Inteiro. Zero, se não houver alocações em regime permanente. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, em caso de falha. Ex: EXIT_FAILURE.
+int main(int argc, char* argv[]);
+
+// **** Implementações das funções. ****
+
+int main(int argc, char* argv[]) {
+
+	reservarBuffersPadrao();
+	if (!contagemAlocacoesAtiva())
+	{
+		printf("Contagem de alocações não habilitada(TETRIS_CONTAR_ALOCACOES).\n");
+		return EXIT_FAILURE;
+	}
+
+	const char* diretorio = argc > 1 ? argv[1] : ".";
+	char gravacao[TAM_MAX_CAMINHO_TESTE], revisao[TAM_MAX_CAMINHO_TESTE];
+	char diario[TAM_MAX_CAMINHO_TESTE], colunas[TAM_MAX_CAMINHO_TESTE];
+	snprintf(gravacao, sizeof(gravacao), "%s/teste_alocacoes.grav", diretorio);
+	snprintf(revisao, sizeof(revisao), "%s/teste_alocacoes.rev", diretorio);
+	snprintf(diario, sizeof(diario), "%s/teste_alocacoes.diario", diretorio);
+	snprintf(colunas, sizeof(colunas), "%s/teste_alocacoes", diretorio);
+
+	// Inicialização: todas as estruturas dinâmicas são reservadas aqui.
+	static Gravador gravador;
+	static GravadorRevisao gravadorRevisao;
+	static Diario diarioAcoes;
+	static ExportadorColunas exportador;
+	MemoriaRamos memoria;
+	GeradorPecas gerador;
+	Sessao sessao;
+	inicializarGerador(&gerador, 1);
+	inicializarSessaoComGerador(&sessao, &gerador);
+	if (!abrirGravacao(&gravador, gravacao) || !abrirRevisao(&gravadorRevisao, revisao, &sessao, INTERVALO_PADRAO_QUADROS)
+		|| !abrirDiario(&diarioAcoes, diario, CAPACIDADE_PADRAO_DIARIO, INTERVALO_PADRAO_FSYNC_MS)
+		|| !abrirColunas(&exportador, colunas)
+		|| !inicializarMemoriaRamos(&memoria, 8, 4 * ACOES_POR_RAMO))
+	{
+		printf("Falha na inicialização dos arquivos de %s.\n", diretorio);
+		return EXIT_FAILURE;
+	}
+	gravarNovaPartida(&gravador, 1);
+	ativarMetricas(true);
+	printf("Inicialização: %" PRIu64 " alocações.\n", totalAlocacoes());
+
+	iniciarRegimePermanente();
+
+	// Sessão principal: ações sorteadas(splitmix64), registradas em todos os destinos.
+	uint64_t estado = 0x9E3779B97F4A7C15ULL;
+	for (int i = 0; i < TOTAL_ACOES_TESTE; i++)
+	{
+		uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		CodigoAcao acao = (CodigoAcao)(ACAO_JOGAR_PECA + (z >> 33) % (TOTAL_ACOES - 1));
+
+		RegistroAcao registro;
+		ResultadoAcao resultado = aplicarAcao(&sessao, acao, &registro);
+		gravarAcao(&gravador, acao);
+		gravarAcaoRevisao(&gravadorRevisao, &sessao, acao);
+		registrarAcaoDiario(&diarioAcoes, &sessao, acao);
+		registrarColunas(&exportador, &sessao, acao, resultado, &registro);
+		if (i % 1000 == 0)
+		{
+			gravarVerificacao(&gravador, sessao.ids.emitidos);
+		}
+	}
+
+	// Ramos: cada rodada cria um ramo, bifurca-o e libera ambos(os componentes voltam aos pools).
+	for (int r = 0; r < RODADAS_RAMOS; r++)
+	{
+		Ramo ramo, bifurcacao;
+		if (!criarRamo(&ramo, &memoria, &sessao, (uint64_t)r))
+		{
+			printf("Pool de ramos esgotado.\n");
+			return EXIT_FAILURE;
+		}
+		for (int i = 0; i < ACOES_POR_RAMO; i++)
+		{
+			aplicarAcaoRamo(&ramo, (CodigoAcao)(ACAO_JOGAR_PECA + (r + i) % (TOTAL_ACOES - 1)));
+		}
+		bifurcarRamo(&bifurcacao, &ramo);
+		for (int i = 0; i < ACOES_POR_RAMO; i++)
+		{
+			aplicarAcaoRamo(&bifurcacao, (CodigoAcao)(ACAO_JOGAR_PECA + (r * 7 + i) % (TOTAL_ACOES - 1)));
+		}
+		liberarRamo(&bifurcacao);
+		liberarRamo(&ramo);
+	}
+
+	uint64_t permanentes = alocacoesRegimePermanente();
+
+	bool sucesso = fecharGravacao(&gravador) & fecharRevisao(&gravadorRevisao) & fecharDiario(&diarioAcoes)
+		& fecharColunas(&exportador);
+	finalizarMemoriaRamos(&memoria);
+	remove(gravacao);
+	remove(revisao);
+	remove(diario);
+	for (int c = 0; c < TOTAL_COLUNAS; c++)
+	{
+		char caminho[TAM_MAX_CAMINHO_TESTE + 16];
+		snprintf(caminho, sizeof(caminho), "%s.%s", colunas, nomeColuna((CodigoColuna)c));
+		remove(caminho);
+	}
+
+	printf("Regime permanente: %d ações, %d rodadas de ramos, %" PRIu64 " alocações.\n",
+		TOTAL_ACOES_TESTE, RODADAS_RAMOS, permanentes);
+	if (!sucesso)
+	{
+		printf("Falha ao fechar os arquivos.\n");
+		return EXIT_FAILURE;
+	}
+	return permanentes == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
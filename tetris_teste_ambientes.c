@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "tetris_nucleo.h"
+#include "tetris_ambiente.h"
+
+// Desafio Tetris Stack
+// Teste(ctest) de equivalência dos ambientes vetorizados com o núcleo: cada ambiente avança em passo
+// com uma sessão(aplicarAcao) do mesmo gerador, e as observações, recompensas, pontuações e a ordem
+// das identificações devem ser iguais a cada passo, inclusive nas ações inválidas e nos reinícios de episódio,
+// nos dois modos de recompensa(por peça e por pontos).
+// As regras dos ambientes são reimplementadas sobre os vetores: uma mudança nas regras do núcleo que não
+// seja repetida nos ambientes falha aqui.
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de ambientes(e de sessões) e de passos.
+#define TOTAL_AMBIENTES_TESTE 64
+#define TOTAL_PASSOS_TESTE 20000
+
+/// @brief Passos de cada episódio: vários reinícios durante o teste.
+#define LIMITE_EPISODIO_TESTE 500
+
+/// @brief Pesos dos tipos de peça dos ambientes: a equivalência também cobre o gerador ponderado.
+static const uint16_t PESOS_TESTE[TOTAL_TIPOS_PECA] = { 4, 1, 2, 2 };
+
+/// @brief Códigos sorteados para as ações: de 0 a 7, incluindo os inválidos(0, 6 e 7).
+#define TOTAL_CODIGOS_TESTE 8
+
+// **** Declarações das funções. ****
+
+/// @brief Ponto de entrada do programa.
+/// @returns Inteiro. Zero, se os ambientes forem equivalentes ao núcleo. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, na primeira divergência. Ex: EXIT_FAILURE.
+int main(void);
+
+// **** Implementações das funções. ****
+
+/// @brief Escreve a observação de uma sessão, no formato de observarAmbientes.
+static void observarSessao(const Sessao* sessao, uint8_t* observacao)
+{
+	const Fila* fila = &sessao->fila;
+	for (int i = 0; i < TAM_MAX_FILA; i++)
+	{
+		observacao[i] = (uint8_t)(strchr(TIPOS_PECA, fila->itens[posicaoFila(fila, i)].tipo) - TIPOS_PECA);
+	}
+	for (int i = 0; i < TAM_MAX_PILHA; i++)
+	{
+		observacao[TAM_MAX_FILA + i] = i <= sessao->pilha.topo
+			? (uint8_t)(strchr(TIPOS_PECA, sessao->pilha.itens[i].tipo) - TIPOS_PECA + 1) : 0;
+	}
+	observacao[TAM_MAX_FILA + TAM_MAX_PILHA] = sessao->trocou ? 1 : 0;
+}
+
+/// @brief Recompensa esperada de uma ação aplicada à sessão, com as regras de avancarAmbientes.
+static float recompensaSessao(Sessao* sessao, int acao, ModoRecompensa modo)
+{
+	if (acao <= ACAO_SAIR || acao >= TOTAL_ACOES)
+	{
+		return RECOMPENSA_ACAO_CANCELADA;
+	}
+
+	RegistroAcao registro;
+	if (aplicarAcao(sessao, (CodigoAcao)acao, &registro) != RESULTADO_SUCESSO)
+	{
+		return RECOMPENSA_ACAO_CANCELADA;
+	}
+	if (modo == RECOMPENSA_POR_PONTOS)
+	{
+		return (float)registro.pontos;
+	}
+	return (acao == ACAO_JOGAR_PECA) | (acao == ACAO_USAR_PECA_RESERVADA) ? RECOMPENSA_PECA_UTILIZADA : 0.0f;
+}
+
+/// @brief Verifica se as identificações do ambiente e da sessão estão na mesma ordem relativa
+/// (os valores diferem, pois cada alocador reserva os seus próprios blocos).
+static bool mesmaOrdemIds(const Ambientes* ambientes, int ambiente, const Sessao* sessao)
+{
+	int64_t idsAmbiente[TAM_MAX_FILA + TAM_MAX_PILHA], idsSessao[TAM_MAX_FILA + TAM_MAX_PILHA];
+	int total = 0;
+	int inicio = ambientes->filaInicio[ambiente];
+	for (int i = 0; i < TAM_MAX_FILA; i++, total++)
+	{
+		int idx = (inicio + i) % TAM_MAX_FILA;
+		idsAmbiente[total] = ambientes->filaId[ambiente * TAM_MAX_FILA + idx];
+		idsSessao[total] = sessao->fila.itens[posicaoFila(&sessao->fila, i)].id;
+	}
+	for (int i = 0; i <= sessao->pilha.topo; i++, total++)
+	{
+		idsAmbiente[total] = ambientes->pilhaId[ambiente * TAM_MAX_PILHA + i];
+		idsSessao[total] = sessao->pilha.itens[i].id;
+	}
+
+	for (int i = 0; i < total; i++)
+	{
+		for (int j = i + 1; j < total; j++)
+		{
+			if ((idsAmbiente[i] < idsAmbiente[j]) != (idsSessao[i] < idsSessao[j]))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/// @brief Compara o estado completo de um ambiente com o da sessão correspondente.
+static bool equivalentes(const Ambientes* ambientes, int ambiente, const uint8_t* observacao, const Sessao* sessao)
+{
+	uint8_t esperada[TAM_OBSERVACAO_AMBIENTE];
+	observarSessao(sessao, esperada);
+
+	const Pontuacao* p = &ambientes->pontuacoes[ambiente];
+	const Pontuacao* q = &sessao->pontuacao;
+	return memcmp(observacao, esperada, TAM_OBSERVACAO_AMBIENTE) == 0
+		&& ambientes->pilhaTopo[ambiente] == sessao->pilha.topo
+		&& p->pontos == q->pontos && p->linhas == q->linhas && p->nivel == q->nivel && p->combo == q->combo
+		&& p->ultimoTipo == q->ultimoTipo && p->dificilAnterior == q->dificilAnterior
+		&& mesmaOrdemIds(ambientes, ambiente, sessao);
+}
+
+/// @brief Avança os ambientes e as sessões em passo, com o modo de recompensa informado.
+/// @returns Verdadeiro(true), se os ambientes forem equivalentes às sessões. Caso contrário, Falso(false).
+static bool verificarModo(ModoRecompensa modo)
+{
+	static Ambientes ambientes;
+	static GeradorPecas geradores[TOTAL_AMBIENTES_TESTE];
+	static Sessao sessoes[TOTAL_AMBIENTES_TESTE];
+	static uint8_t acoes[TOTAL_AMBIENTES_TESTE], terminados[TOTAL_AMBIENTES_TESTE];
+	static uint8_t observacoes[TOTAL_AMBIENTES_TESTE * TAM_OBSERVACAO_AMBIENTE];
+	static float recompensas[TOTAL_AMBIENTES_TESTE];
+
+	if (!criarAmbientes(&ambientes, TOTAL_AMBIENTES_TESTE, 42, LIMITE_EPISODIO_TESTE, PESOS_TESTE))
+	{
+		printf("Falha ao criar os ambientes.\n");
+		return false;
+	}
+	ambientes.modoRecompensa = modo;
+
+	// Cada sessão usa um gerador com a mesma semente e os mesmos pesos do ambiente correspondente.
+	observarAmbientes(&ambientes, TOTAL_AMBIENTES_TESTE, observacoes);
+	for (int i = 0; i < TOTAL_AMBIENTES_TESTE; i++)
+	{
+		inicializarGerador(&geradores[i], ambientes.geradores[i].semente);
+		definirPesosGerador(&geradores[i], PESOS_TESTE);
+		inicializarSessaoComGerador(&sessoes[i], &geradores[i]);
+		if (!equivalentes(&ambientes, i, &observacoes[i * TAM_OBSERVACAO_AMBIENTE], &sessoes[i]))
+		{
+			printf("Divergência no estado inicial do ambiente %d.\n", i);
+			destruirAmbientes(&ambientes);
+			return false;
+		}
+	}
+
+	uint64_t estado = 0x9E3779B97F4A7C15ULL;
+	int64_t pontosRecebidos = 0;
+	for (int passo = 0; passo < TOTAL_PASSOS_TESTE; passo++)
+	{
+		for (int i = 0; i < TOTAL_AMBIENTES_TESTE; i++)
+		{
+			// xorshift64: ações reproduzíveis entre execuções.
+			estado ^= estado << 13;
+			estado ^= estado >> 7;
+			estado ^= estado << 17;
+			acoes[i] = (uint8_t)(estado % TOTAL_CODIGOS_TESTE);
+		}
+
+		avancarAmbientes(&ambientes, acoes, TOTAL_AMBIENTES_TESTE, observacoes, recompensas, terminados);
+
+		for (int i = 0; i < TOTAL_AMBIENTES_TESTE; i++)
+		{
+			float recompensa = recompensaSessao(&sessoes[i], acoes[i], modo);
+			pontosRecebidos += recompensas[i] > 0.0f ? (int64_t)recompensas[i] : 0;
+			if (terminados[i])
+			{
+				// Reinício do episódio: a sequência de peças continua no mesmo gerador.
+				inicializarSessaoComGerador(&sessoes[i], &geradores[i]);
+			}
+			if (recompensa != recompensas[i] || terminados[i] != ((passo + 1) % LIMITE_EPISODIO_TESTE == 0)
+				|| !equivalentes(&ambientes, i, &observacoes[i * TAM_OBSERVACAO_AMBIENTE], &sessoes[i]))
+			{
+				printf("Divergência no passo %d, ambiente %d, ação %d(modo %d).\n", passo, i, acoes[i], (int)modo);
+				destruirAmbientes(&ambientes);
+				return false;
+			}
+		}
+	}
+
+	printf("Equivalentes(modo %d): %d ambientes, %d passos, %lld de recompensa positiva.\n", (int)modo,
+		TOTAL_AMBIENTES_TESTE, TOTAL_PASSOS_TESTE, (long long)pontosRecebidos);
+	destruirAmbientes(&ambientes);
+	return true;
+}
+
+int main(void) {
+
+	return verificarModo(RECOMPENSA_POR_PECA) && verificarModo(RECOMPENSA_POR_PONTOS) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
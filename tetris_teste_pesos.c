@@ -0,0 +1,153 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Teste(ctest) da distribuição ponderada dos tipos de peça(definirPesosGerador): as frequências sorteadas
+// devem ficar próximas dos pesos, os tipos de peso zero nunca são sorteados, a geração em lote repete o
+// sorteio peça a peça, e os pesos NULL restauram a sequência uniforme.
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de peças sorteadas para cada distribuição.
+#define TOTAL_SORTEIOS_TESTE (1 << 20)
+
+/// @brief Tolerância das frequências, em desvios-padrão da binomial.
+#define DESVIOS_TOLERADOS 6.0
+
+/// @brief Peças de cada lote de gerarPecas.
+#define TAM_LOTE_TESTE 1000
+
+/// @brief Quantidade de distribuições testadas.
+#define TOTAL_DISTRIBUICOES_TESTE 5
+
+/// @brief Distribuições testadas(pesos na ordem de TIPOS_PECA).
+static const uint16_t DISTRIBUICOES_TESTE[TOTAL_DISTRIBUICOES_TESTE][TOTAL_TIPOS_PECA] = {
+	{ 1, 1, 1, 1 },
+	{ 4, 1, 2, 2 },
+	{ 0, 0, 0, 7 },
+	{ 3, 0, 0, 1 },
+	{ 65535, 1, 1, 1 }
+};
+
+// **** Declarações das funções. ****
+
+/// @brief Ponto de entrada do programa.
+/// @returns Inteiro. Zero, se todas as verificações passarem. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, na primeira falha. Ex: EXIT_FAILURE.
+int main(void);
+
+// **** Implementações das funções. ****
+
+/// @brief Sorteia peças com os pesos informados e compara as frequências com os pesos.
+/// @returns Verdadeiro(true), se as frequências estiverem dentro da tolerância. Caso contrário, Falso(false).
+static bool verificarFrequencias(const uint16_t pesos[TOTAL_TIPOS_PECA], uint64_t semente)
+{
+	GeradorPecas gerador;
+	inicializarGerador(&gerador, semente);
+	if (!definirPesosGerador(&gerador, pesos))
+	{
+		return false;
+	}
+
+	uint64_t contagens[TOTAL_TIPOS_PECA] = { 0 };
+	for (int i = 0; i < TOTAL_SORTEIOS_TESTE; i++)
+	{
+		contagens[sortearCodigoPeca(&gerador)]++;
+	}
+
+	double total = 0.0;
+	for (int t = 0; t < TOTAL_TIPOS_PECA; t++)
+	{
+		total += pesos[t];
+	}
+
+	bool sucesso = true;
+	for (int t = 0; t < TOTAL_TIPOS_PECA; t++)
+	{
+		double probabilidade = pesos[t] / total;
+		double esperado = probabilidade * TOTAL_SORTEIOS_TESTE;
+		double tolerancia = DESVIOS_TOLERADOS * sqrt(esperado * (1.0 - probabilidade));
+		// Peso zero: nenhum sorteio(tolerância zero).
+		bool dentro = fabs((double)contagens[t] - esperado) <= tolerancia;
+		printf("  %c: peso %5u, %8llu sorteios(esperado %.0f).\n", TIPOS_PECA[t], pesos[t],
+			(unsigned long long)contagens[t], esperado);
+		sucesso &= dentro;
+	}
+	return sucesso;
+}
+
+/// @brief Verifica se a geração em lote(gerarPecas) sorteia os mesmos tipos que o sorteio peça a peça.
+static bool verificarLote(const uint16_t pesos[TOTAL_TIPOS_PECA], uint64_t semente)
+{
+	GeradorPecas lote, unitario;
+	inicializarGerador(&lote, semente);
+	inicializarGerador(&unitario, semente);
+	definirPesosGerador(&lote, pesos);
+	definirPesosGerador(&unitario, pesos);
+
+	AlocadorIds ids;
+	inicializarAlocadorIds(&ids);
+	Peca pecas[TAM_LOTE_TESTE];
+	gerarPecas(pecas, TAM_LOTE_TESTE, &ids, &lote);
+	for (int i = 0; i < TAM_LOTE_TESTE; i++)
+	{
+		if (pecas[i].tipo != TIPOS_PECA[sortearCodigoPeca(&unitario)])
+		{
+			return false;
+		}
+	}
+	return lote.contador == unitario.contador;
+}
+
+int main(void) {
+
+	for (int d = 0; d < TOTAL_DISTRIBUICOES_TESTE; d++)
+	{
+		const uint16_t* pesos = DISTRIBUICOES_TESTE[d];
+		printf("Distribuição %d:\n", d);
+		if (!verificarFrequencias(pesos, 1000 + (uint64_t)d))
+		{
+			printf("Frequências fora da tolerância.\n");
+			return EXIT_FAILURE;
+		}
+		if (!verificarLote(pesos, 2000 + (uint64_t)d))
+		{
+			printf("A geração em lote diverge do sorteio peça a peça.\n");
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Pesos todos zero: recusados, com o gerador inalterado.
+	GeradorPecas gerador, referencia;
+	inicializarGerador(&gerador, 7);
+	definirPesosGerador(&gerador, DISTRIBUICOES_TESTE[1]);
+	referencia = gerador;
+	const uint16_t zeros[TOTAL_TIPOS_PECA] = { 0 };
+	if (definirPesosGerador(&gerador, zeros) || memcmp(&gerador, &referencia, sizeof(gerador)) != 0)
+	{
+		printf("Pesos todos zero não foram recusados.\n");
+		return EXIT_FAILURE;
+	}
+
+	// Pesos NULL: a mesma sequência de um gerador recém-inicializado(uniforme).
+	GeradorPecas uniforme;
+	inicializarGerador(&gerador, 7);
+	inicializarGerador(&uniforme, 7);
+	definirPesosGerador(&gerador, DISTRIBUICOES_TESTE[2]);
+	definirPesosGerador(&gerador, NULL);
+	for (int i = 0; i < TAM_LOTE_TESTE; i++)
+	{
+		if (sortearCodigoPeca(&gerador) != sortearCodigoPeca(&uniforme))
+		{
+			printf("Pesos NULL não restauraram a sequência uniforme.\n");
+			return EXIT_FAILURE;
+		}
+	}
+
+	printf("Distribuições ponderadas verificadas.\n");
+	return EXIT_SUCCESS;
+}
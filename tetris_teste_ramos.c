@@ -0,0 +1,273 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "tetris_nucleo.h"
+#include "tetris_ramo.h"
+
+// Desafio Tetris Stack
+// Teste(ctest) da cópia na escrita dos ramos(tetris_ramo.h): após a bifurcação, as ações de um ramo não
+// alteram a fila, a pilha nem o histórico do outro; ramos irmãos, bifurcados no mesmo ponto, recebem
+// as mesmas peças futuras(inclusive as identificações); e, liberados todos os ramos, nenhum componente
+// permanece em uso nos pools.
+
+// **** Definições de constantes. ****
+
+/// @brief Semente do gerador da sessão de origem e semente das peças futuras dos ramos.
+#define SEMENTE_SESSAO_TESTE 35
+#define SEMENTE_RAMOS_TESTE 3500
+
+/// @brief Capacidade dos pools: filas e pilhas(cada), e nós de histórico.
+#define CAPACIDADE_COMPONENTES_TESTE 8
+#define CAPACIDADE_NOS_TESTE 64
+
+/// @brief Capacidade do vetor de histórico das fotografias.
+#define TAM_HISTORICO_TESTE 32
+
+/// @brief Peças jogadas pelos ramos irmãos, após a primeira ação(distinta em cada irmão).
+#define TOTAL_PECAS_IRMAOS_TESTE 16
+
+/// @brief Ações aplicadas ao ramo raiz antes da bifurcação(histórico e pilha não vazios).
+static const CodigoAcao ACOES_PREFIXO_TESTE[] = { ACAO_JOGAR_PECA, ACAO_RESERVAR_PECA };
+
+/// @brief Ações aplicadas à bifurcação: todas alteram a fila ou a pilha, e todas devem ter sucesso.
+static const CodigoAcao ACOES_BIFURCACAO_TESTE[] = {
+	ACAO_RESERVAR_PECA, ACAO_RESERVAR_PECA, ACAO_TROCAR_PECAS_RESERVADAS,
+	ACAO_TROCAR_PECA_RESERVADA, ACAO_USAR_PECA_RESERVADA, ACAO_JOGAR_PECA
+};
+
+/// @brief Ações aplicadas ao ramo raiz, após as da bifurcação.
+static const CodigoAcao ACOES_RAIZ_TESTE[] = {
+	ACAO_TROCAR_PECA_RESERVADA, ACAO_JOGAR_PECA, ACAO_USAR_PECA_RESERVADA, ACAO_RESERVAR_PECA
+};
+
+#define TOTAL_ITENS(vetor) ((int)(sizeof(vetor) / sizeof((vetor)[0])))
+
+// **** Declarações de estruturas. ****
+
+/// @brief Cópia do estado observável de um ramo, para a comparação após as ações do outro ramo.
+typedef struct {
+	Fila fila;
+	Pilha pilha;
+	CodigoAcao historico[TAM_HISTORICO_TESTE];
+	int totalHistorico;
+} Fotografia;
+
+// **** Declarações das funções. ****
+
+/// @brief Ponto de entrada do programa.
+/// @returns Inteiro. Zero, se todas as verificações passarem. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, na primeira falha. Ex: EXIT_FAILURE.
+int main(void);
+
+// **** Implementações das funções. ****
+
+/// @brief Compara duas peças pelo tipo e pela identificação.
+static bool pecasIguais(Peca a, Peca b)
+{
+	return a.tipo == b.tipo && a.id == b.id;
+}
+
+/// @brief Compara duas filas elemento a elemento, a partir do início(as posições internas podem diferir).
+static bool filasIguais(const Fila* a, const Fila* b)
+{
+	if (a->total != b->total)
+	{
+		return false;
+	}
+	for (int i = 0; i < a->total; i++)
+	{
+		if (!pecasIguais(a->itens[posicaoFila(a, i)], b->itens[posicaoFila(b, i)]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// @brief Compara duas pilhas elemento a elemento, da base ao topo.
+static bool pilhasIguais(const Pilha* a, const Pilha* b)
+{
+	if (a->topo != b->topo)
+	{
+		return false;
+	}
+	for (int i = 0; i <= a->topo; i++)
+	{
+		if (!pecasIguais(a->itens[i], b->itens[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/// @brief Copia a fila, a pilha e o histórico atuais do ramo.
+static void fotografarRamo(const Ramo* ramo, Fotografia* foto)
+{
+	foto->fila = ramo->fila->fila;
+	foto->pilha = ramo->pilha->pilha;
+	foto->totalHistorico = historicoRamo(ramo, foto->historico, TAM_HISTORICO_TESTE);
+}
+
+/// @brief Verifica se a fila, a pilha e o histórico do ramo são os da fotografia.
+static bool conferirFotografia(const Ramo* ramo, const Fotografia* foto)
+{
+	CodigoAcao historico[TAM_HISTORICO_TESTE];
+	int total = historicoRamo(ramo, historico, TAM_HISTORICO_TESTE);
+	return filasIguais(&ramo->fila->fila, &foto->fila)
+		&& pilhasIguais(&ramo->pilha->pilha, &foto->pilha)
+		&& total == foto->totalHistorico
+		&& memcmp(historico, foto->historico, (size_t)total * sizeof(CodigoAcao)) == 0;
+}
+
+/// @brief Aplica as ações a um ramo, conferindo a cada ação que o outro ramo permanece como na fotografia.
+/// @returns Verdadeiro(true), se todas as ações tiverem sucesso e o outro ramo não mudar. Caso contrário, Falso(false).
+static bool aplicarIsolado(Ramo* ramo, const CodigoAcao* acoes, int total, const Ramo* outro, const Fotografia* fotoOutro)
+{
+	for (int i = 0; i < total; i++)
+	{
+		ResultadoAcao resultado = aplicarAcaoRamo(ramo, acoes[i]);
+		if (resultado != RESULTADO_SUCESSO)
+		{
+			printf("Ação %d(%d) cancelada: resultado %d.\n", i, (int)acoes[i], (int)resultado);
+			return false;
+		}
+		if (!conferirFotografia(outro, fotoOutro))
+		{
+			printf("Ação %d(%d) alterou o outro ramo.\n", i, (int)acoes[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+/// @brief Bifurca o ramo e altera os dois lados, um de cada vez, verificando o isolamento entre eles.
+static bool verificarIsolamento(Ramo* raiz)
+{
+	Ramo bifurcacao;
+	bifurcarRamo(&bifurcacao, raiz);
+	if (raiz->fila->referencias != 2 || raiz->pilha->referencias != 2 || raiz->historico->referencias != 2)
+	{
+		printf("A bifurcação não compartilhou os componentes.\n");
+		liberarRamo(&bifurcacao);
+		return false;
+	}
+
+	Fotografia fotoRaiz, fotoBifurcacao;
+	fotografarRamo(raiz, &fotoRaiz);
+	bool sucesso = aplicarIsolado(&bifurcacao, ACOES_BIFURCACAO_TESTE, TOTAL_ITENS(ACOES_BIFURCACAO_TESTE),
+		raiz, &fotoRaiz);
+
+	// A bifurcação deve ter mudado(caso contrário, a verificação acima nada provaria), e o prefixo
+	// do seu histórico é o histórico da raiz.
+	fotografarRamo(&bifurcacao, &fotoBifurcacao);
+	if (sucesso && (filasIguais(&fotoBifurcacao.fila, &fotoRaiz.fila) || pilhasIguais(&fotoBifurcacao.pilha, &fotoRaiz.pilha)
+		|| fotoBifurcacao.totalHistorico != fotoRaiz.totalHistorico + TOTAL_ITENS(ACOES_BIFURCACAO_TESTE)
+		|| memcmp(fotoBifurcacao.historico, fotoRaiz.historico, (size_t)fotoRaiz.totalHistorico * sizeof(CodigoAcao)) != 0))
+	{
+		printf("A bifurcação não registrou as suas ações.\n");
+		sucesso = false;
+	}
+	if (sucesso && (raiz->fila->referencias != 1 || raiz->pilha->referencias != 1 || raiz->historico->referencias != 2))
+	{
+		printf("Contagens de referências incorretas após a cópia na escrita.\n");
+		sucesso = false;
+	}
+
+	sucesso = sucesso && aplicarIsolado(raiz, ACOES_RAIZ_TESTE, TOTAL_ITENS(ACOES_RAIZ_TESTE),
+		&bifurcacao, &fotoBifurcacao);
+
+	liberarRamo(&bifurcacao);
+	return sucesso;
+}
+
+/// @brief Bifurca dois irmãos no mesmo ponto, com primeiras ações distintas, e compara as peças geradas
+/// a cada ação seguinte(o final da fila), inclusive as identificações.
+static bool verificarIrmaos(const Ramo* raiz)
+{
+	Ramo a, b;
+	bifurcarRamo(&a, raiz);
+	bifurcarRamo(&b, raiz);
+
+	// Jogar e reservar consomem, cada uma, uma peça do gerador.
+	bool sucesso = aplicarAcaoRamo(&a, ACAO_JOGAR_PECA) == RESULTADO_SUCESSO
+		&& aplicarAcaoRamo(&b, ACAO_RESERVAR_PECA) == RESULTADO_SUCESSO;
+	for (int i = 0; sucesso && i <= TOTAL_PECAS_IRMAOS_TESTE; i++)
+	{
+		const Fila* filaA = &a.fila->fila;
+		const Fila* filaB = &b.fila->fila;
+		if (!pecasIguais(filaA->itens[posicaoFila(filaA, filaA->total - 1)], filaB->itens[posicaoFila(filaB, filaB->total - 1)]))
+		{
+			printf("Os irmãos receberam peças diferentes na posição %d.\n", i);
+			sucesso = false;
+		}
+		else if (i < TOTAL_PECAS_IRMAOS_TESTE)
+		{
+			// Ações intercaladas: o avanço de um irmão não pode afetar o outro.
+			sucesso = aplicarAcaoRamo(&b, ACAO_JOGAR_PECA) == RESULTADO_SUCESSO
+				&& aplicarAcaoRamo(&a, ACAO_JOGAR_PECA) == RESULTADO_SUCESSO;
+		}
+	}
+
+	liberarRamo(&a);
+	liberarRamo(&b);
+	return sucesso;
+}
+
+int main(void) {
+
+	GeradorPecas gerador;
+	inicializarGerador(&gerador, SEMENTE_SESSAO_TESTE);
+	Sessao sessao;
+	inicializarSessaoComGerador(&sessao, &gerador);
+
+	MemoriaRamos memoria;
+	Ramo raiz;
+	if (!inicializarMemoriaRamos(&memoria, CAPACIDADE_COMPONENTES_TESTE, CAPACIDADE_NOS_TESTE))
+	{
+		printf("Sem memória para os pools.\n");
+		return EXIT_FAILURE;
+	}
+	if (!criarRamo(&raiz, &memoria, &sessao, SEMENTE_RAMOS_TESTE))
+	{
+		printf("Pool de ramos esgotado.\n");
+		finalizarMemoriaRamos(&memoria);
+		return EXIT_FAILURE;
+	}
+
+	bool sucesso = true;
+	for (int i = 0; sucesso && i < TOTAL_ITENS(ACOES_PREFIXO_TESTE); i++)
+	{
+		sucesso = aplicarAcaoRamo(&raiz, ACOES_PREFIXO_TESTE[i]) == RESULTADO_SUCESSO;
+	}
+	if (!sucesso)
+	{
+		printf("Ações iniciais da raiz canceladas.\n");
+	}
+
+	sucesso = sucesso && verificarIsolamento(&raiz);
+	sucesso = sucesso && verificarIrmaos(&raiz);
+
+	// Com os ramos bifurcados já liberados, somente os componentes da raiz permanecem em uso.
+	if (sucesso && (memoria.filas.emUso != 1 || memoria.pilhas.emUso != 1))
+	{
+		printf("Componentes dos ramos liberados permanecem em uso.\n");
+		sucesso = false;
+	}
+	liberarRamo(&raiz);
+	if (sucesso && (memoria.filas.emUso != 0 || memoria.pilhas.emUso != 0 || memoria.nos.emUso != 0))
+	{
+		printf("Componentes em uso após liberarRamo: %u filas, %u pilhas, %u nós.\n",
+			memoria.filas.emUso, memoria.pilhas.emUso, memoria.nos.emUso);
+		sucesso = false;
+	}
+	finalizarMemoriaRamos(&memoria);
+
+	if (!sucesso)
+	{
+		return EXIT_FAILURE;
+	}
+	printf("Ramos isolados, irmãos com as mesmas peças e pools vazios após a liberação.\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,594 @@
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+// Se estivermos no windows, vamos incluir usar uma saída de console com padrão adequado para utf-8.
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "tetris_nucleo.h"
+#include "tetris_tempo.h"
+#include "tetris_versus.h"
+
+// Desafio Tetris Stack
+// Torneio entre as estratégias registradas, em partidas versus(tetris_versus.h) sem interface.
+// Formatos: todos contra todos(padrão), ou suíço(--suico RODADAS), com pareamento pela pontuação das rodadas.
+// Cada confronto joga a mesma quantidade de partidas, alternando os lados. A semente de cada partida
+// deriva somente da semente do torneio e do número da partida: o torneio é reproduzível bit a bit,
+// independentemente da quantidade de threads.
+//
+// As partidas são executadas em lotes, divididos entre as threads(OpenMP, se houver). Os resultados de
+// cada lote são gravados e agregados em ordem, após o lote.
+//
+// Arquivo de resultados(--resultados ARQUIVO), em little-endian:
+//   cabeçalho(16 bytes): assinatura "TTOR", versão(1 byte), quantidade de estratégias(1 byte),
+//                        reservado(2 bytes), semente do torneio(8 bytes).
+//   partidas(8 bytes cada, em ordem): estratégia do jogador 0(1 byte), estratégia do jogador 1(1 byte),
+//                        vencedor(1 byte: 0, 1, ou 0xFF em caso de empate), rodada(1 byte), passos(4 bytes).
+// Os índices das estratégias seguem a ordem do registro(ver estrategiasTorneio).
+
+// **** Definições de constantes. ****
+
+/// @brief Versão do formato do arquivo de resultados.
+#define VERSAO_RESULTADOS 1
+
+/// @brief Tamanho do cabeçalho do arquivo de resultados, em bytes.
+#define TAM_CABECALHO_RESULTADOS 16
+
+/// @brief Tamanho de cada partida no arquivo de resultados, em bytes.
+#define TAM_PARTIDA_RESULTADOS 8
+
+/// @brief Quantidade de partidas de cada lote, entre as threads.
+#define TAM_LOTE_TORNEIO 65536
+
+/// @brief Valores padrão das opções.
+#define PARTIDAS_PADRAO 1000
+#define LIMITE_PASSOS_PADRAO 10000
+
+/// @brief Valor crítico da normal para os intervalos de confiança de 95%.
+#define Z_CONFIANCA 1.959964
+
+// **** Declarações de estruturas. ****
+
+/// @brief Estratégia registrada no torneio.
+typedef struct {
+	const char* nome;
+	Estrategia estrategia;
+	/// @brief Se a estratégia usa um estado de sorteio(uint64_t) como contexto.
+	bool sorteia;
+} EstrategiaRegistrada;
+
+/// @brief Confronto entre duas estratégias, em uma rodada.
+typedef struct {
+	int a;
+	int b;
+} Confronto;
+
+/// @brief Resultado de uma partida, do ponto de vista dos lados(jogador 0 e jogador 1).
+typedef struct {
+	uint8_t estrategias[2];
+	int8_t vencedor;
+	int32_t passos;
+} PartidaTorneio;
+
+/// @brief Desempenho agregado de uma estratégia.
+typedef struct {
+	int64_t vitorias;
+	int64_t empates;
+	int64_t derrotas;
+	/// @brief Pontos do formato suíço, em meios pontos(vitória no confronto 2, empate 1).
+	int meiosPontos;
+} Desempenho;
+
+// **** Declarações das funções. ****
+
+/// @brief Estratégia que sempre joga a peça da frente da fila.
+CodigoAcao estrategiaJogadora(const Jogador* proprio, const Jogador* oponente, void* contexto);
+/// @brief Estratégia que reserva peças enquanto houver espaço na pilha, e então usa a peça do topo.
+CodigoAcao estrategiaReservista(const Jogador* proprio, const Jogador* oponente, void* contexto);
+
+/// @brief Mistura um número de 64 bits(finalizador do splitmix64).
+/// @param Inteiro. Valor a ser misturado.
+/// @returns Inteiro. Valor misturado.
+uint64_t misturarSemente(uint64_t valor);
+/// @brief Pareia as estratégias de uma rodada do formato suíço, pela pontuação atual: cada estratégia
+/// enfrenta a próxima da classificação que ainda não enfrentou(ou a próxima, se já enfrentou todas).
+/// Com uma quantidade ímpar, a última da classificação folga(e recebe a vitória da rodada).
+/// @param Desempenho. Desempenhos atuais. Somente leitura.
+/// @param Booleano. Matriz de confrontos já disputados(total x total).
+/// @param Confronto. Vetor a conter os confrontos da rodada.
+/// @returns Inteiro. Quantidade de confrontos.
+int parearSuico(const Desempenho* desempenhos, bool* enfrentados, Confronto* confrontos);
+/// @brief Executa os confrontos de uma rodada, em lotes, e agrega e grava os resultados em ordem.
+/// @param Confronto. Confrontos da rodada. Somente leitura.
+/// @param Inteiro. Quantidade de confrontos.
+/// @param Inteiro. Rodada(a partir de 0).
+/// @param Inteiro. Número da primeira partida da rodada no torneio(para as sementes).
+/// @param Desempenho. Vetor via referência, com os desempenhos a atualizar.
+/// @param Inteiro. Matriz(total x total) via referência, com as vitórias de cada estratégia sobre cada outra.
+/// @param Arquivo. Arquivo de resultados, ou NULL.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se houver falha na gravação.
+bool executarRodada(const Confronto* confrontos, int totalConfrontos, int rodada, int64_t primeiraPartida,
+	Desempenho* desempenhos, int64_t* vitoriasContra, FILE* arquivo);
+/// @brief Calcula o intervalo de confiança de Wilson(95%) de uma taxa.
+/// @param Double. Taxa observada(de 0 a 1).
+/// @param Inteiro. Quantidade de amostras.
+/// @param Double. Ponteiro via referência, para o limite inferior.
+/// @param Double. Ponteiro via referência, para o limite superior.
+void intervaloWilson(double taxa, int64_t amostras, double* inferior, double* superior);
+/// @brief Exibe a classificação final, com as taxas de pontos e os intervalos de confiança,
+/// e a matriz de taxas de pontos entre as estratégias.
+void mostrarClassificacao(const Desempenho* desempenhos, const int64_t* vitoriasContra, const int64_t* jogosContra);
+/// @brief Exibe um texto em UTF-8 alinhado em uma coluna, pela quantidade de caracteres(não de bytes).
+/// @param Texto. Conteúdo a ser exibido.
+/// @param Inteiro. Largura da coluna. Positiva, alinhado à esquerda. Negativa, alinhado à direita.
+void mostrarColuna(const char* texto, int largura);
+
+/// @brief Ponto de entrada do programa.
+/// @param argc Quantidade de argumentos da linha de comando.
+/// @param argv Argumentos da linha de comando. Ex: --partidas N, --suico RODADAS, --semente N,
+/// --limite-passos N, --resultados ARQUIVO.
+/// @returns Inteiro. Zero, em caso de sucesso. Ex: EXIT_SUCCESS.
+/// Ou diferente de Zero, em caso de falha. Ex: EXIT_FAILURE.
+int main(int argc, char* argv[]);
+
+// **** Variáveis internas. ****
+
+/// @brief Estratégias registradas. Novas estratégias são incluídas aqui(até 255).
+static const EstrategiaRegistrada estrategiasTorneio[] = {
+	{ "gulosa", estrategiaGulosa, false },
+	{ "aleatória", estrategiaAleatoria, true },
+	{ "jogadora", estrategiaJogadora, false },
+	{ "reservista", estrategiaReservista, false },
+};
+
+/// @brief Quantidade de estratégias registradas.
+#define TOTAL_ESTRATEGIAS ((int)(sizeof(estrategiasTorneio) / sizeof(estrategiasTorneio[0])))
+
+/// @brief Opções do torneio.
+static uint64_t sementeTorneio = 1;
+static int partidasPorConfronto = PARTIDAS_PADRAO;
+static int limitePassos = LIMITE_PASSOS_PADRAO;
+
+/// @brief Resultados do lote atual. Estático, pelo tamanho.
+static PartidaTorneio lote[TAM_LOTE_TORNEIO];
+
+// **** Implementações das funções. ****
+
+int main(int argc, char* argv[]) {
+
+	// Configurações de caracteres para ajuste de ortografia para saída do console(UTF-8).
+#ifdef _WIN32
+	// Plataforma Windows.
+	SetConsoleOutputCP(CP_UTF8);
+#endif
+
+	int rodadasSuico = 0;
+	const char* arquivoResultados = NULL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--partidas") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+		{
+			partidasPorConfronto = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--suico") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+		{
+			rodadasSuico = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc)
+		{
+			sementeTorneio = strtoull(argv[++i], NULL, 10);
+			continue;
+		}
+		if (strcmp(argv[i], "--limite-passos") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+		{
+			limitePassos = atoi(argv[++i]);
+			continue;
+		}
+		if (strcmp(argv[i], "--resultados") == 0 && i + 1 < argc)
+		{
+			arquivoResultados = argv[++i];
+			continue;
+		}
+		printf("Uso: %s [--partidas N] [--suico RODADAS] [--semente N] [--limite-passos N] [--resultados ARQUIVO]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE* arquivo = NULL;
+	if (arquivoResultados != NULL)
+	{
+		arquivo = fopen(arquivoResultados, "wb");
+		uint8_t cabecalho[TAM_CABECALHO_RESULTADOS] = { 'T', 'T', 'O', 'R', VERSAO_RESULTADOS, (uint8_t)TOTAL_ESTRATEGIAS };
+		for (int i = 0; i < 8; i++)
+		{
+			cabecalho[8 + i] = (uint8_t)(sementeTorneio >> (8 * i));
+		}
+		if (arquivo == NULL || fwrite(cabecalho, 1, sizeof(cabecalho), arquivo) != sizeof(cabecalho))
+		{
+			printf("\n==== ⚠️  Não foi possível criar o arquivo de resultados %s. ====\n", arquivoResultados);
+			if (arquivo != NULL)
+			{
+				fclose(arquivo);
+			}
+			return EXIT_FAILURE;
+		}
+	}
+
+	int threads = 1;
+#ifdef _OPENMP
+	threads = omp_get_max_threads();
+#endif
+	printf("==== Torneio %s: %d estratégias, %d partidas por confronto, semente %" PRIu64 ", %d threads. ====\n",
+		rodadasSuico > 0 ? "suíço" : "todos contra todos", TOTAL_ESTRATEGIAS, partidasPorConfronto,
+		sementeTorneio, threads);
+	fflush(stdout);
+
+	Desempenho desempenhos[TOTAL_ESTRATEGIAS];
+	int64_t vitoriasContra[TOTAL_ESTRATEGIAS * TOTAL_ESTRATEGIAS];
+	int64_t jogosContra[TOTAL_ESTRATEGIAS * TOTAL_ESTRATEGIAS];
+	bool enfrentados[TOTAL_ESTRATEGIAS * TOTAL_ESTRATEGIAS];
+	Confronto confrontos[TOTAL_ESTRATEGIAS * (TOTAL_ESTRATEGIAS - 1) / 2];
+	memset(desempenhos, 0, sizeof(desempenhos));
+	memset(vitoriasContra, 0, sizeof(vitoriasContra));
+	memset(jogosContra, 0, sizeof(jogosContra));
+	memset(enfrentados, 0, sizeof(enfrentados));
+
+	bool sucesso = true;
+	int64_t partidas = 0;
+	int64_t inicioNs = relogioMonotonicoNs();
+	int rodadas = rodadasSuico > 0 ? rodadasSuico : 1;
+	for (int rodada = 0; rodada < rodadas && sucesso; rodada++)
+	{
+		int totalConfrontos = 0;
+		if (rodadasSuico > 0)
+		{
+			totalConfrontos = parearSuico(desempenhos, enfrentados, confrontos);
+		}
+		else
+		{
+			for (int a = 0; a < TOTAL_ESTRATEGIAS; a++)
+			{
+				for (int b = a + 1; b < TOTAL_ESTRATEGIAS; b++)
+				{
+					confrontos[totalConfrontos].a = a;
+					confrontos[totalConfrontos].b = b;
+					totalConfrontos++;
+				}
+			}
+		}
+
+		for (int c = 0; c < totalConfrontos; c++)
+		{
+			int a = confrontos[c].a, b = confrontos[c].b;
+			jogosContra[a * TOTAL_ESTRATEGIAS + b] += partidasPorConfronto;
+			jogosContra[b * TOTAL_ESTRATEGIAS + a] += partidasPorConfronto;
+		}
+
+		sucesso = executarRodada(confrontos, totalConfrontos, rodada, partidas, desempenhos, vitoriasContra, arquivo);
+		partidas += (int64_t)totalConfrontos * partidasPorConfronto;
+	}
+	int64_t duracaoNs = relogioMonotonicoNs() - inicioNs;
+
+	if (arquivo != NULL && fclose(arquivo) != 0)
+	{
+		sucesso = false;
+	}
+	if (!sucesso)
+	{
+		printf("\n==== ⚠️  Não foi possível gravar o arquivo de resultados %s. ====\n", arquivoResultados);
+		return EXIT_FAILURE;
+	}
+
+	mostrarClassificacao(desempenhos, vitoriasContra, jogosContra);
+	printf("\nPartidas: %" PRId64 ". Duração: %.3f s(%.0f partidas por segundo).\n", partidas, duracaoNs / 1e9,
+		duracaoNs > 0 ? partidas * 1e9 / duracaoNs : 0.0);
+
+	return EXIT_SUCCESS;
+}
+
+uint64_t misturarSemente(uint64_t valor)
+{
+	valor += 0x9E3779B97F4A7C15ULL;
+	valor = (valor ^ (valor >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	valor = (valor ^ (valor >> 27)) * 0x94D049BB133111EBULL;
+	return valor ^ (valor >> 31);
+}
+
+int parearSuico(const Desempenho* desempenhos, bool* enfrentados, Confronto* confrontos)
+{
+	// Classificação pelos pontos, com desempate pelo índice(ordenação por inserção, estável).
+	int ordem[TOTAL_ESTRATEGIAS];
+	for (int i = 0; i < TOTAL_ESTRATEGIAS; i++)
+	{
+		int j = i;
+		while (j > 0 && desempenhos[ordem[j - 1]].meiosPontos < desempenhos[i].meiosPontos)
+		{
+			ordem[j] = ordem[j - 1];
+			j--;
+		}
+		ordem[j] = i;
+	}
+
+	bool pareada[TOTAL_ESTRATEGIAS] = { false };
+	int total = 0;
+	for (int i = 0; i < TOTAL_ESTRATEGIAS; i++)
+	{
+		int a = ordem[i];
+		if (pareada[a])
+		{
+			continue;
+		}
+
+		int oponente = -1, repetido = -1;
+		for (int j = i + 1; j < TOTAL_ESTRATEGIAS && oponente < 0; j++)
+		{
+			int b = ordem[j];
+			if (pareada[b])
+			{
+				continue;
+			}
+			if (!enfrentados[a * TOTAL_ESTRATEGIAS + b])
+			{
+				oponente = b;
+			}
+			else if (repetido < 0)
+			{
+				repetido = b;
+			}
+		}
+		if (oponente < 0)
+		{
+			oponente = repetido;
+		}
+		if (oponente < 0)
+		{
+			// Folga: ímpar, sem oponente restante.
+			continue;
+		}
+
+		pareada[a] = pareada[oponente] = true;
+		enfrentados[a * TOTAL_ESTRATEGIAS + oponente] = enfrentados[oponente * TOTAL_ESTRATEGIAS + a] = true;
+		confrontos[total].a = a;
+		confrontos[total].b = oponente;
+		total++;
+	}
+	return total;
+}
+
+bool executarRodada(const Confronto* confrontos, int totalConfrontos, int rodada, int64_t primeiraPartida,
+	Desempenho* desempenhos, int64_t* vitoriasContra, FILE* arquivo)
+{
+	int64_t totalPartidas = (int64_t)totalConfrontos * partidasPorConfronto;
+	int64_t vitoriasConfronto[TOTAL_ESTRATEGIAS * (TOTAL_ESTRATEGIAS - 1) / 2][2];
+	memset(vitoriasConfronto, 0, sizeof(vitoriasConfronto));
+
+	for (int64_t inicio = 0; inicio < totalPartidas; inicio += TAM_LOTE_TORNEIO)
+	{
+		int quantidade = (int)(totalPartidas - inicio < TAM_LOTE_TORNEIO ? totalPartidas - inicio : TAM_LOTE_TORNEIO);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+		for (int i = 0; i < quantidade; i++)
+		{
+			int64_t numero = inicio + i;
+			const Confronto* confronto = &confrontos[numero / partidasPorConfronto];
+			// Os lados alternam a cada partida do confronto, pois o jogador 0 age primeiro em cada passo.
+			int invertido = (int)(numero % partidasPorConfronto) & 1;
+			int lados[2] = { invertido ? confronto->b : confronto->a, invertido ? confronto->a : confronto->b };
+
+			uint64_t semente = misturarSemente(sementeTorneio ^ misturarSemente((uint64_t)(primeiraPartida + numero)));
+			uint64_t sorteios[2];
+			Estrategia estrategias[2];
+			void* contextos[2];
+			for (int lado = 0; lado < 2; lado++)
+			{
+				const EstrategiaRegistrada* registrada = &estrategiasTorneio[lados[lado]];
+				sorteios[lado] = misturarSemente(semente + 1 + (uint64_t)lado) | 1;
+				estrategias[lado] = registrada->estrategia;
+				contextos[lado] = registrada->sorteia ? &sorteios[lado] : NULL;
+			}
+
+			Versus versus;
+			inicializarVersus(&versus, semente);
+			ResultadoVersus resultado = executarPartidaVersus(&versus, estrategias, contextos, limitePassos);
+
+			PartidaTorneio* partida = &lote[i];
+			partida->estrategias[0] = (uint8_t)lados[0];
+			partida->estrategias[1] = (uint8_t)lados[1];
+			partida->vencedor = (int8_t)resultado.vencedor;
+			partida->passos = resultado.passos;
+		}
+
+		// Agregação e gravação em ordem: o resultado não depende da divisão entre as threads.
+		uint8_t registros[TAM_PARTIDA_RESULTADOS * 512];
+		int pendentes = 0;
+		for (int i = 0; i < quantidade; i++)
+		{
+			const PartidaTorneio* partida = &lote[i];
+			int confronto = (int)((inicio + i) / partidasPorConfronto);
+			int e0 = partida->estrategias[0], e1 = partida->estrategias[1];
+			if (partida->vencedor < 0)
+			{
+				desempenhos[e0].empates++;
+				desempenhos[e1].empates++;
+			}
+			else
+			{
+				int vencedora = partida->vencedor == 0 ? e0 : e1;
+				int perdedora = partida->vencedor == 0 ? e1 : e0;
+				desempenhos[vencedora].vitorias++;
+				desempenhos[perdedora].derrotas++;
+				vitoriasContra[vencedora * TOTAL_ESTRATEGIAS + perdedora]++;
+				vitoriasConfronto[confronto][vencedora == confrontos[confronto].a ? 0 : 1]++;
+			}
+
+			if (arquivo == NULL)
+			{
+				continue;
+			}
+			uint8_t* registro = &registros[pendentes * TAM_PARTIDA_RESULTADOS];
+			registro[0] = partida->estrategias[0];
+			registro[1] = partida->estrategias[1];
+			registro[2] = (uint8_t)partida->vencedor;
+			registro[3] = (uint8_t)rodada;
+			for (int b = 0; b < 4; b++)
+			{
+				registro[4 + b] = (uint8_t)((uint32_t)partida->passos >> (8 * b));
+			}
+			if (++pendentes * TAM_PARTIDA_RESULTADOS == (int)sizeof(registros) || i == quantidade - 1)
+			{
+				size_t tamanho = (size_t)pendentes * TAM_PARTIDA_RESULTADOS;
+				if (fwrite(registros, 1, tamanho, arquivo) != tamanho)
+				{
+					return false;
+				}
+				pendentes = 0;
+			}
+		}
+	}
+
+	// Pontos do formato suíço: o confronto é vencido por quem vencer mais partidas.
+	for (int c = 0; c < totalConfrontos; c++)
+	{
+		int a = confrontos[c].a, b = confrontos[c].b;
+		int64_t va = vitoriasConfronto[c][0], vb = vitoriasConfronto[c][1];
+		desempenhos[a].meiosPontos += va > vb ? 2 : (va == vb ? 1 : 0);
+		desempenhos[b].meiosPontos += vb > va ? 2 : (va == vb ? 1 : 0);
+	}
+	// Folga no formato suíço(quantidade ímpar): vitória da rodada.
+	if (2 * totalConfrontos < TOTAL_ESTRATEGIAS)
+	{
+		bool pareada[TOTAL_ESTRATEGIAS] = { false };
+		for (int c = 0; c < totalConfrontos; c++)
+		{
+			pareada[confrontos[c].a] = pareada[confrontos[c].b] = true;
+		}
+		for (int i = 0; i < TOTAL_ESTRATEGIAS; i++)
+		{
+			desempenhos[i].meiosPontos += pareada[i] ? 0 : 2;
+		}
+	}
+
+	return true;
+}
+
+void intervaloWilson(double taxa, int64_t amostras, double* inferior, double* superior)
+{
+	if (amostras == 0)
+	{
+		*inferior = 0.0;
+		*superior = 1.0;
+		return;
+	}
+	double z2 = Z_CONFIANCA * Z_CONFIANCA;
+	double n = (double)amostras;
+	double denominador = 1.0 + z2 / n;
+	double centro = (taxa + z2 / (2.0 * n)) / denominador;
+	double margem = Z_CONFIANCA * sqrt(taxa * (1.0 - taxa) / n + z2 / (4.0 * n * n)) / denominador;
+	*inferior = centro - margem;
+	*superior = centro + margem;
+}
+
+void mostrarClassificacao(const Desempenho* desempenhos, const int64_t* vitoriasContra, const int64_t* jogosContra)
+{
+	// Taxa de pontos: vitória vale 1 e empate vale meio ponto.
+	double taxas[TOTAL_ESTRATEGIAS];
+	int ordem[TOTAL_ESTRATEGIAS];
+	for (int i = 0; i < TOTAL_ESTRATEGIAS; i++)
+	{
+		const Desempenho* d = &desempenhos[i];
+		int64_t jogos = d->vitorias + d->empates + d->derrotas;
+		taxas[i] = jogos > 0 ? (d->vitorias + 0.5 * d->empates) / jogos : 0.0;
+
+		int j = i;
+		while (j > 0 && taxas[ordem[j - 1]] < taxas[i])
+		{
+			ordem[j] = ordem[j - 1];
+			j--;
+		}
+		ordem[j] = i;
+	}
+
+	printf("\n==== Classificação ====\n");
+	mostrarColuna("Estratégia", 12);
+	mostrarColuna("Vitórias", -11);
+	printf(" %10s %10s %8s %17s\n", "Empates", "Derrotas", "Taxa", "IC 95%");
+	for (int k = 0; k < TOTAL_ESTRATEGIAS; k++)
+	{
+		int i = ordem[k];
+		const Desempenho* d = &desempenhos[i];
+		double inferior, superior;
+		intervaloWilson(taxas[i], d->vitorias + d->empates + d->derrotas, &inferior, &superior);
+		mostrarColuna(estrategiasTorneio[i].nome, 12);
+		printf(" %10" PRId64 " %10" PRId64 " %10" PRId64 " %7.2f%% [%6.2f%%, %6.2f%%]\n",
+			d->vitorias, d->empates, d->derrotas, 100.0 * taxas[i], 100.0 * inferior, 100.0 * superior);
+	}
+
+	// Taxa de pontos da estratégia da linha contra a da coluna.
+	printf("\n==== Confrontos(taxa de pontos da linha contra a coluna) ====\n");
+	mostrarColuna("", 12);
+	for (int k = 0; k < TOTAL_ESTRATEGIAS; k++)
+	{
+		mostrarColuna(estrategiasTorneio[ordem[k]].nome, -12);
+	}
+	printf("\n");
+	for (int k = 0; k < TOTAL_ESTRATEGIAS; k++)
+	{
+		int i = ordem[k];
+		mostrarColuna(estrategiasTorneio[i].nome, 12);
+		for (int m = 0; m < TOTAL_ESTRATEGIAS; m++)
+		{
+			int j = ordem[m];
+			int64_t jogos = jogosContra[i * TOTAL_ESTRATEGIAS + j];
+			if (i == j || jogos == 0)
+			{
+				printf(" %11s", "-");
+				continue;
+			}
+			int64_t vitorias = vitoriasContra[i * TOTAL_ESTRATEGIAS + j];
+			int64_t empates = jogos - vitorias - vitoriasContra[j * TOTAL_ESTRATEGIAS + i];
+			printf(" %10.2f%%", 100.0 * (vitorias + 0.5 * empates) / jogos);
+		}
+		printf("\n");
+	}
+}
+
+void mostrarColuna(const char* texto, int largura)
+{
+	int caracteres = 0;
+	for (const char* c = texto; *c != '\0'; c++)
+	{
+		// Os bytes de continuação(10xxxxxx) não iniciam caracteres.
+		caracteres += ((unsigned char)*c & 0xC0) != 0x80;
+	}
+	int preenchimento = (largura < 0 ? -largura : largura) - caracteres;
+	preenchimento = preenchimento > 0 ? preenchimento : 0;
+	if (largura < 0)
+	{
+		printf("%*s%s", preenchimento, "", texto);
+	}
+	else
+	{
+		printf("%s%*s", texto, preenchimento, "");
+	}
+}
+
+// **** Estratégias registradas ****
+
+CodigoAcao estrategiaJogadora(const Jogador* proprio, const Jogador* oponente, void* contexto)
+{
+	return ACAO_JOGAR_PECA;
+}
+
+CodigoAcao estrategiaReservista(const Jogador* proprio, const Jogador* oponente, void* contexto)
+{
+	return pilhaCheia(&proprio->sessao.pilha) ? ACAO_USAR_PECA_RESERVADA : ACAO_RESERVAR_PECA;
+}
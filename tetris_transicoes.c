@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tetris_transicoes.h"
+#include "tetris_memoria.h"
+
+// **** Implementações das funções. ****
+
+/// @brief Deslocamento do índice da pilha pela quantidade de peças: 4^0 + 4^1 + ... + 4^(total - 1).
+static inline int32_t deslocamentoPilha(int total)
+{
+	return ((1 << (2 * total)) - 1) / 3;
+}
+
+/// @brief Recupera o código de um tipo de peça(índice em TIPOS_PECA), ou -1 se desconhecido.
+static int codigoTipo(char tipo)
+{
+	const char* posicao = tipo != '\0' ? strchr(TIPOS_PECA, tipo) : NULL;
+	return posicao != NULL ? (int)(posicao - TIPOS_PECA) : -1;
+}
+
+int32_t indexarEstado(const Sessao* sessao)
+{
+	const Fila* fila = &sessao->fila;
+	const Pilha* pilha = &sessao->pilha;
+	if (fila->total != TAM_MAX_FILA)
+	{
+		return -1;
+	}
+
+	int32_t codigoFila = 0;
+	for (int i = 0, idx = fila->inicio; i < TAM_MAX_FILA; i++, idx = avancarFila(idx))
+	{
+		int codigo = codigoTipo(fila->itens[idx].tipo);
+		if (codigo < 0)
+		{
+			return -1;
+		}
+		codigoFila |= codigo << (2 * i);
+	}
+
+	int totalPilha = pilha->topo + 1;
+	int32_t codigoPilha = 0;
+	for (int i = 0; i < totalPilha; i++)
+	{
+		int codigo = codigoTipo(pilha->itens[i].tipo);
+		if (codigo < 0)
+		{
+			return -1;
+		}
+		codigoPilha |= codigo << (2 * i);
+	}
+
+	int32_t indicePilha = deslocamentoPilha(totalPilha) + codigoPilha;
+	return (indicePilha * TOTAL_CONFIGURACOES_FILA + codigoFila) * 2 + (sessao->trocou ? 1 : 0);
+}
+
+void decodificarEstado(int32_t estado, EstadoTipos* tipos)
+{
+	tipos->trocou = estado & 1;
+	estado >>= 1;
+	int32_t codigoFila = estado % TOTAL_CONFIGURACOES_FILA;
+	int32_t indicePilha = estado / TOTAL_CONFIGURACOES_FILA;
+
+	for (int i = 0; i < TAM_MAX_FILA; i++)
+	{
+		tipos->fila[i] = TIPOS_PECA[(codigoFila >> (2 * i)) & 3];
+	}
+
+	int total = 0;
+	while (total < TAM_MAX_PILHA && indicePilha >= deslocamentoPilha(total + 1))
+	{
+		total++;
+	}
+	int32_t codigoPilha = indicePilha - deslocamentoPilha(total);
+	tipos->totalPilha = total;
+	for (int i = 0; i < TAM_MAX_PILHA; i++)
+	{
+		tipos->pilha[i] = i < total ? TIPOS_PECA[(codigoPilha >> (2 * i)) & 3] : '\0';
+	}
+}
+
+bool gerarTabelaTransicoes(TabelaTransicoes* tabela)
+{
+	tabela->sucessores = alocarMemoria((size_t)TOTAL_ESTADOS * TOTAL_ACOES_TABELA * sizeof(int32_t));
+	if (tabela->sucessores == NULL)
+	{
+		return false;
+	}
+
+	// Um único alocador para todas as sessões montadas: as identificações não participam do estado.
+	AlocadorIds ids;
+	inicializarAlocadorIds(&ids);
+
+	for (int32_t estado = 0; estado < TOTAL_ESTADOS; estado++)
+	{
+		EstadoTipos tipos;
+		decodificarEstado(estado, &tipos);
+
+		for (int acao = ACAO_JOGAR_PECA; acao < TOTAL_ACOES; acao++)
+		{
+			// Sessão montada a partir do estado. A peça gerada(se houver) é substituída pela de código 0.
+			Sessao sessao;
+			GeradorPecas gerador;
+			memset(&sessao, 0, sizeof(sessao));
+			inicializarGerador(&gerador, 0);
+			sessao.gerador = &gerador;
+			sessao.ids = ids;
+			sessao.trocou = tipos.trocou;
+			inicializarPontuacao(&sessao.pontuacao);
+			sessao.fila.inicio = 0;
+			sessao.fila.total = TAM_MAX_FILA;
+			for (int i = 0; i < TAM_MAX_FILA; i++)
+			{
+				sessao.fila.itens[i].tipo = tipos.fila[i];
+			}
+			sessao.pilha.topo = tipos.totalPilha - 1;
+			for (int i = 0; i < tipos.totalPilha; i++)
+			{
+				sessao.pilha.itens[i].tipo = tipos.pilha[i];
+			}
+
+			RegistroAcao registro;
+			ResultadoAcao resultado = aplicarAcao(&sessao, (CodigoAcao)acao, &registro);
+			ids = sessao.ids;
+
+			int32_t* entrada = &tabela->sucessores[estado * TOTAL_ACOES_TABELA + (acao - ACAO_JOGAR_PECA)];
+			if (resultado != RESULTADO_SUCESSO)
+			{
+				*entrada = -(int32_t)resultado;
+				continue;
+			}
+			if (registro.reposta)
+			{
+				sessao.fila.itens[posicaoFila(&sessao.fila, TAM_MAX_FILA - 1)].tipo = TIPOS_PECA[0];
+			}
+			*entrada = indexarEstado(&sessao);
+		}
+	}
+
+	return true;
+}
+
+void liberarTabelaTransicoes(TabelaTransicoes* tabela)
+{
+	liberarMemoria(tabela->sucessores);
+	tabela->sucessores = NULL;
+}
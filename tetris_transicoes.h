@@ -0,0 +1,87 @@
+#ifndef TETRIS_TRANSICOES_H
+#define TETRIS_TRANSICOES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Tabela de transições pré-calculada sobre o espaço de estados dos tipos das peças: a fila(sempre cheia
+// nas sessões), a pilha(de 0 a TAM_MAX_PILHA peças) e a flag de troca. As identificações e a pontuação
+// não fazem parte do estado.
+//
+// Hash perfeito(e mínimo) de cada estado, com os códigos dos tipos(índices em TIPOS_PECA) em base 4:
+//   fila:   soma de codigo(posição i a partir da frente) * 4^i            (de 0 a 4^TAM_MAX_FILA - 1)
+//   pilha:  deslocamento[total] + soma de codigo(posição j a partir da base) * 4^j (de 0 a 84)
+//   estado: (pilha * 4^TAM_MAX_FILA + fila) * 2 + trocou                   (de 0 a TOTAL_ESTADOS - 1)
+//
+// A tabela é gerada aplicando cada ação do núcleo(aplicarAcao) a cada estado: as regras são as mesmas
+// das sessões. A peça gerada por jogar e reservar ocupa a última posição da fila, com o peso
+// PASSO_PECA_GERADA no índice: a tabela guarda o sucessor com a peça de código 0, e o código da peça
+// gerada é somado na consulta(ver transicaoEstado).
+
+// **** Definições de constantes. ****
+
+/// @brief Quantidade de configurações da fila(4^TAM_MAX_FILA).
+#define TOTAL_CONFIGURACOES_FILA (1 << (2 * TAM_MAX_FILA))
+
+/// @brief Quantidade de configurações da pilha(1 + 4 + 16 + 64, com TAM_MAX_PILHA 3).
+#define TOTAL_CONFIGURACOES_PILHA (((1 << (2 * (TAM_MAX_PILHA + 1))) - 1) / 3)
+
+/// @brief Quantidade total de estados.
+#define TOTAL_ESTADOS (TOTAL_CONFIGURACOES_PILHA * TOTAL_CONFIGURACOES_FILA * 2)
+
+/// @brief Peso da última posição da fila(peça gerada) no índice do estado.
+#define PASSO_PECA_GERADA ((TOTAL_CONFIGURACOES_FILA / 4) * 2)
+
+/// @brief Quantidade de ações da tabela(de ACAO_JOGAR_PECA a ACAO_TROCAR_PECAS_RESERVADAS).
+#define TOTAL_ACOES_TABELA (TOTAL_ACOES - 1)
+
+// **** Declarações de estruturas. ****
+
+/// @brief Tabela de transições: TOTAL_ESTADOS x TOTAL_ACOES_TABELA entradas. Cada entrada é o índice do
+/// sucessor(com a peça gerada de código 0), ou o motivo do cancelamento negativo(-ResultadoAcao).
+typedef struct {
+	int32_t* sucessores;
+} TabelaTransicoes;
+
+/// @brief Estado decodificado: os tipos das peças, na ordem da fila(a partir da frente) e da pilha(a partir da base).
+typedef struct {
+	char fila[TAM_MAX_FILA];
+	char pilha[TAM_MAX_PILHA];
+	int totalPilha;
+	bool trocou;
+} EstadoTipos;
+
+// **** Declarações das funções. ****
+
+/// @brief Gera a tabela de transições, aplicando todas as ações a todos os estados.
+/// @param TabelaTransicoes. Ponteiro via referência, a conter a tabela.
+/// @returns Verdadeiro(true), em caso de sucesso. Falso(false), se não houver memória.
+bool gerarTabelaTransicoes(TabelaTransicoes* tabela);
+/// @brief Libera a memória da tabela de transições.
+/// @param TabelaTransicoes. Ponteiro via referência, a ser finalizado.
+void liberarTabelaTransicoes(TabelaTransicoes* tabela);
+/// @brief Calcula o índice do estado de uma sessão.
+/// @param Sessao. Ponteiro da sessão. Somente leitura.
+/// @returns Inteiro. Índice do estado, ou -1 se a fila não estiver cheia(fora do espaço de estados).
+int32_t indexarEstado(const Sessao* sessao);
+/// @brief Decodifica o índice de um estado.
+/// @param Inteiro. Índice do estado(de 0 a TOTAL_ESTADOS - 1).
+/// @param EstadoTipos. Ponteiro via referência, a conter o estado decodificado.
+void decodificarEstado(int32_t estado, EstadoTipos* tipos);
+
+/// @brief Aplica uma ação a um estado, com uma única consulta à tabela.
+/// @param TabelaTransicoes. Ponteiro da tabela. Somente leitura.
+/// @param Inteiro. Índice do estado.
+/// @param CodigoAcao. Ação a ser aplicada(de ACAO_JOGAR_PECA a ACAO_TROCAR_PECAS_RESERVADAS).
+/// @param Inteiro. Código do tipo da peça gerada(de 0 a 3), se a ação gerar uma peça(jogar e reservar).
+/// @returns Inteiro. Índice do sucessor, ou o motivo do cancelamento negativo(-ResultadoAcao).
+static inline int32_t transicaoEstado(const TabelaTransicoes* tabela, int32_t estado, CodigoAcao acao, int codigoGerado)
+{
+	int32_t sucessor = tabela->sucessores[estado * TOTAL_ACOES_TABELA + (acao - ACAO_JOGAR_PECA)];
+	bool gera = (sucessor >= 0) & ((acao == ACAO_JOGAR_PECA) | (acao == ACAO_RESERVAR_PECA));
+	return sucessor + (int32_t)gera * codigoGerado * PASSO_PECA_GERADA;
+}
+
+#endif // TETRIS_TRANSICOES_H
@@ -0,0 +1,294 @@
+#include <string.h>
+#include "tetris_versus.h"
+
+// **** Definições de constantes. ****
+
+/// @brief Linhas de ataque por classe da linha: simples, com peça 'I' e com giro T.
+static const uint8_t ataqueLinha[3] = { 1, 2, 3 };
+
+/// @brief Linhas de ataque adicionais por etapa do combo(a última entrada vale para as etapas seguintes).
+static const uint8_t ataqueCombo[] = { 0, 0, 1, 1, 1, 2, 2, 3, 3, 4 };
+
+/// @brief Total de entradas de ataqueCombo.
+#define TOTAL_ATAQUE_COMBO ((int)(sizeof(ataqueCombo) / sizeof(ataqueCombo[0])))
+
+/// @brief Células de cada peça.
+#define CELULAS_PECA 4
+
+/// @brief Células preenchíveis de cada linha pelas colocações(a última coluna é o poço).
+#define CELULAS_LINHA (LARGURA_TABULEIRO - 1)
+
+// **** Implementações das funções. ****
+
+/// @brief Sorteia um número de 64 bits(xorshift64*). O estado deve ser diferente de zero.
+static inline uint64_t sortearVersus(uint64_t* estado)
+{
+	uint64_t x = *estado;
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*estado = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+/// @brief Preenche as células de uma peça colocada sem linha.
+/// @returns Verdadeiro(true), se o tabuleiro comportou a peça. Falso(false), se excedeu a altura.
+static bool colocarPecaTabuleiro(Tabuleiro* tabuleiro)
+{
+	int restantes = CELULAS_PECA;
+	while (restantes > 0)
+	{
+		if (tabuleiro->celulas == 0)
+		{
+			if (tabuleiro->altura == ALTURA_TABULEIRO)
+			{
+				return false;
+			}
+			tabuleiro->linhas[tabuleiro->altura++] = 0;
+		}
+
+		int livres = CELULAS_LINHA - tabuleiro->celulas;
+		int preenchidas = restantes < livres ? restantes : livres;
+		uint16_t mascara = (uint16_t)(((1u << preenchidas) - 1) << tabuleiro->celulas);
+		tabuleiro->linhas[tabuleiro->altura - 1] |= mascara;
+		tabuleiro->celulas = (tabuleiro->celulas + preenchidas) % CELULAS_LINHA;
+		restantes -= preenchidas;
+	}
+	return true;
+}
+
+/// @brief Elimina a linha do topo do tabuleiro, se houver.
+static void eliminarLinhaTabuleiro(Tabuleiro* tabuleiro)
+{
+	if (tabuleiro->altura > 0)
+	{
+		tabuleiro->linhas[--tabuleiro->altura] = 0;
+	}
+	tabuleiro->celulas = 0;
+}
+
+bool inserirLixo(Tabuleiro* tabuleiro, int linhas, int buraco)
+{
+	if (linhas <= 0)
+	{
+		return true;
+	}
+
+	bool comportou = tabuleiro->altura + linhas <= ALTURA_TABULEIRO;
+	if (!comportou)
+	{
+		// As linhas que excedem a altura são descartadas: o jogador já foi derrotado.
+		linhas = ALTURA_TABULEIRO - tabuleiro->altura;
+	}
+
+	// Deslocamento das linhas para cima, e o lixo ocupa as linhas do fundo.
+	memmove(&tabuleiro->linhas[linhas], &tabuleiro->linhas[0], (size_t)tabuleiro->altura * sizeof(uint16_t));
+	uint16_t lixo = (uint16_t)(LINHA_CHEIA_TABULEIRO & ~(1u << buraco));
+	for (int i = 0; i < linhas; i++)
+	{
+		tabuleiro->linhas[i] = lixo;
+	}
+	tabuleiro->altura += linhas;
+
+	return comportou;
+}
+
+/// @brief Insere um ataque no final da fila de ataques do jogador.
+static void receberAtaque(Jogador* jogador, int linhas, int buraco)
+{
+	FilaAtaques* ataques = &jogador->ataques;
+	if (ataques->total == TAM_MAX_ATAQUES)
+	{
+		// Fila cheia: o ataque é somado ao último.
+		Ataque* ultimo = &ataques->itens[(ataques->inicio + ataques->total - 1) % TAM_MAX_ATAQUES];
+		int soma = ultimo->linhas + linhas;
+		ultimo->linhas = (uint8_t)(soma < UINT8_MAX ? soma : UINT8_MAX);
+	}
+	else
+	{
+		Ataque* novo = &ataques->itens[(ataques->inicio + ataques->total) % TAM_MAX_ATAQUES];
+		novo->linhas = (uint8_t)linhas;
+		novo->buraco = (uint8_t)buraco;
+		ataques->total++;
+	}
+	ataques->linhas += linhas;
+}
+
+/// @brief Cancela o lixo pendente do jogador, a partir do ataque mais antigo.
+/// @returns Inteiro. Linhas de ataque restantes, após o cancelamento.
+static int cancelarAtaques(Jogador* jogador, int linhas)
+{
+	FilaAtaques* ataques = &jogador->ataques;
+	while (linhas > 0 && ataques->total > 0)
+	{
+		Ataque* primeiro = &ataques->itens[ataques->inicio];
+		int canceladas = linhas < primeiro->linhas ? linhas : primeiro->linhas;
+		primeiro->linhas = (uint8_t)(primeiro->linhas - canceladas);
+		ataques->linhas -= canceladas;
+		linhas -= canceladas;
+		if (primeiro->linhas == 0)
+		{
+			ataques->inicio = (ataques->inicio + 1) % TAM_MAX_ATAQUES;
+			ataques->total--;
+		}
+	}
+	return linhas;
+}
+
+/// @brief Insere o lixo pendente do jogador no tabuleiro, até MAX_LIXO_POR_COLOCACAO linhas.
+/// @returns Verdadeiro(true), se o tabuleiro comportou o lixo. Falso(false), se excedeu a altura.
+static bool aplicarAtaques(Jogador* jogador)
+{
+	// O lixo entra por baixo: a linha do topo em construção é preservada.
+	FilaAtaques* ataques = &jogador->ataques;
+	int limite = MAX_LIXO_POR_COLOCACAO;
+	while (limite > 0 && ataques->total > 0)
+	{
+		Ataque* primeiro = &ataques->itens[ataques->inicio];
+		int linhas = primeiro->linhas < limite ? primeiro->linhas : limite;
+		if (!inserirLixo(&jogador->tabuleiro, linhas, primeiro->buraco))
+		{
+			return false;
+		}
+		primeiro->linhas = (uint8_t)(primeiro->linhas - linhas);
+		ataques->linhas -= linhas;
+		limite -= linhas;
+		if (primeiro->linhas == 0)
+		{
+			ataques->inicio = (ataques->inicio + 1) % TAM_MAX_ATAQUES;
+			ataques->total--;
+		}
+	}
+	return true;
+}
+
+/// @brief Calcula as linhas de ataque de uma colocação com linha, a partir da pontuação anterior e atual.
+static int calcularAtaque(const Pontuacao* anterior, const Pontuacao* atual, char tipo, bool giroT)
+{
+	int classe = giroT ? 2 : (tipo == 'I' ? 1 : 0);
+	int ataque = ataqueLinha[classe];
+	// Costas com costas: linha difícil após outra linha difícil.
+	if (classe != 0 && anterior->dificilAnterior)
+	{
+		ataque++;
+	}
+	ataque += ataqueCombo[atual->combo < TOTAL_ATAQUE_COMBO ? atual->combo : TOTAL_ATAQUE_COMBO - 1];
+	return ataque;
+}
+
+void inicializarVersus(Versus* versus, uint64_t semente)
+{
+	memset(versus, 0, sizeof(*versus));
+	for (int i = 0; i < 2; i++)
+	{
+		Jogador* jogador = &versus->jogadores[i];
+		// Mesma sequência de peças para os dois jogadores.
+		inicializarGerador(&jogador->gerador, semente);
+		inicializarSessaoComGerador(&jogador->sessao, &jogador->gerador);
+	}
+	versus->sorteio = semente ^ 0x9E3779B97F4A7C15ULL;
+	if (versus->sorteio == 0)
+	{
+		versus->sorteio = 1;
+	}
+}
+
+ResultadoAcao aplicarAcaoVersus(Versus* versus, int indice, CodigoAcao acao)
+{
+	Jogador* jogador = &versus->jogadores[indice];
+	Jogador* oponente = &versus->jogadores[1 - indice];
+	Pontuacao anterior = jogador->sessao.pontuacao;
+	RegistroAcao registro;
+
+	ResultadoAcao resultado = aplicarAcao(&jogador->sessao, acao, &registro);
+	if (versus->observador != NULL)
+	{
+		versus->observador(versus->contextoObservador, &jogador->sessao, acao, resultado, &registro);
+	}
+	bool colocou = resultado == RESULTADO_SUCESSO
+		&& (acao == ACAO_JOGAR_PECA || acao == ACAO_USAR_PECA_RESERVADA);
+	if (!colocou)
+	{
+		return resultado;
+	}
+
+	if (jogador->sessao.pontuacao.linhas == anterior.linhas)
+	{
+		// Sem linha: a peça ocupa o tabuleiro, e o lixo pendente entra.
+		if (!colocarPecaTabuleiro(&jogador->tabuleiro) || !aplicarAtaques(jogador))
+		{
+			jogador->derrotado = true;
+		}
+		return resultado;
+	}
+
+	eliminarLinhaTabuleiro(&jogador->tabuleiro);
+
+	bool giroT = acao == ACAO_USAR_PECA_RESERVADA && registro.removida.tipo == 'T';
+	int ataque = calcularAtaque(&anterior, &jogador->sessao.pontuacao, registro.removida.tipo, giroT);
+	ataque = cancelarAtaques(jogador, ataque);
+	if (ataque > 0)
+	{
+		int buraco = (int)(sortearVersus(&versus->sorteio) % LARGURA_TABULEIRO);
+		receberAtaque(oponente, ataque, buraco);
+		jogador->linhasEnviadas += ataque;
+	}
+
+	return resultado;
+}
+
+ResultadoVersus executarPartidaVersus(Versus* versus, Estrategia estrategias[2], void* contextos[2], int limitePassos)
+{
+	Jogador* jogadores = versus->jogadores;
+
+	while (versus->passos < limitePassos && !jogadores[0].derrotado && !jogadores[1].derrotado)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			CodigoAcao acao = estrategias[i](&jogadores[i], &jogadores[1 - i], contextos[i]);
+			aplicarAcaoVersus(versus, i, acao);
+		}
+		versus->passos++;
+	}
+
+	ResultadoVersus resultado;
+	resultado.passos = versus->passos;
+	resultado.vencedor = -1;
+	if (jogadores[0].derrotado != jogadores[1].derrotado)
+	{
+		resultado.vencedor = jogadores[0].derrotado ? 1 : 0;
+	}
+	for (int i = 0; i < 2; i++)
+	{
+		resultado.pontos[i] = jogadores[i].sessao.pontuacao.pontos;
+		resultado.linhasEnviadas[i] = jogadores[i].linhasEnviadas;
+	}
+	return resultado;
+}
+
+// **** Estratégias de referência. ****
+
+CodigoAcao estrategiaAleatoria(const Jogador* proprio, const Jogador* oponente, void* contexto)
+{
+	return (CodigoAcao)(ACAO_JOGAR_PECA + (int)(sortearVersus((uint64_t*)contexto) % (TOTAL_ACOES - 1)));
+}
+
+CodigoAcao estrategiaGulosa(const Jogador* proprio, const Jogador* oponente, void* contexto)
+{
+	const Sessao* sessao = &proprio->sessao;
+	char ultimo = sessao->pontuacao.ultimoTipo;
+
+	if (sessao->fila.total > 0 && sessao->fila.itens[sessao->fila.inicio].tipo == ultimo)
+	{
+		return ACAO_JOGAR_PECA;
+	}
+	if (!pilhaVazia(&sessao->pilha) && sessao->pilha.itens[sessao->pilha.topo].tipo == ultimo)
+	{
+		return ACAO_USAR_PECA_RESERVADA;
+	}
+	if (!pilhaCheia(&sessao->pilha))
+	{
+		return ACAO_RESERVAR_PECA;
+	}
+	return ACAO_JOGAR_PECA;
+}
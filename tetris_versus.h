@@ -0,0 +1,143 @@
+#ifndef TETRIS_VERSUS_H
+#define TETRIS_VERSUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "tetris_nucleo.h"
+
+// Desafio Tetris Stack
+// Partidas versus entre duas estratégias, sem interface. Cada jogador possui a sua sessão(fila, pilha e
+// pontuação) e um tabuleiro em bitboard(uma palavra de 16 bits por linha, de baixo para cima).
+//
+// Regras do tabuleiro, sobre as colocações da pontuação(ver tetris_pontuacao.h):
+//   sem linha: as 4 células da peça preenchem a linha do topo, da esquerda para a direita, até a coluna
+//              LARGURA_TABULEIRO - 2(a última coluna é o poço, e a linha nunca se completa sozinha).
+//              Em seguida, o lixo pendente entra no tabuleiro.
+//   com linha: a linha do topo é eliminada, e o ataque(ver tabelas em tetris_versus.c) cancela primeiro
+//              o lixo pendente do próprio jogador. O restante vai para a fila de ataque do oponente.
+//   lixo:      linhas cheias com um buraco, inseridas por baixo(deslocamento das linhas do bitboard).
+//   derrota:   o tabuleiro excede ALTURA_TABULEIRO linhas.
+// Os dois jogadores recebem a mesma sequência de peças(mesma semente), e agem alternadamente, um passo cada.
+
+// **** Definições de constantes. ****
+
+#define LARGURA_TABULEIRO 10
+#define ALTURA_TABULEIRO 24
+
+/// @brief Máscara de uma linha com todas as colunas preenchidas.
+#define LINHA_CHEIA_TABULEIRO ((uint16_t)((1u << LARGURA_TABULEIRO) - 1))
+
+/// @brief Quantidade máxima de ataques pendentes na fila de cada jogador. Os excedentes são somados ao último.
+#define TAM_MAX_ATAQUES 16
+
+/// @brief Quantidade máxima de linhas de lixo inseridas por colocação. O restante continua pendente.
+#define MAX_LIXO_POR_COLOCACAO 8
+
+// **** Declarações de estruturas. ****
+
+/// @brief Tabuleiro em bitboard: bit c da linha l indica a célula(coluna c, linha l), com a linha 0 no fundo.
+typedef struct {
+	uint16_t linhas[ALTURA_TABULEIRO];
+	/// @brief Quantidade de linhas ocupadas.
+	int altura;
+	/// @brief Células preenchidas na linha do topo pelas colocações(0 se a próxima colocação inicia uma linha).
+	int celulas;
+} Tabuleiro;
+
+/// @brief Um ataque recebido: quantidade de linhas de lixo e a coluna do buraco.
+typedef struct {
+	uint8_t linhas;
+	uint8_t buraco;
+} Ataque;
+
+/// @brief Fila circular de ataques recebidos, ainda não inseridos no tabuleiro.
+typedef struct {
+	Ataque itens[TAM_MAX_ATAQUES];
+	int inicio;
+	int total;
+	/// @brief Soma das linhas pendentes.
+	int linhas;
+} FilaAtaques;
+
+/// @brief Estado de um jogador na partida.
+typedef struct {
+	Sessao sessao;
+	GeradorPecas gerador;
+	Tabuleiro tabuleiro;
+	FilaAtaques ataques;
+	int32_t linhasEnviadas;
+	bool derrotado;
+} Jogador;
+
+/// @brief Estratégia: escolhe a próxima ação de um jogador.
+/// @param Jogador. Ponteiro do jogador. Somente leitura.
+/// @param Jogador. Ponteiro do oponente. Somente leitura.
+/// @param void. Contexto da estratégia(pode ser NULL).
+/// @returns CodigoAcao. Ação a ser aplicada(de 1 a 5).
+typedef CodigoAcao (*Estrategia)(const Jogador* proprio, const Jogador* oponente, void* contexto);
+
+/// @brief Observador das ações aplicadas às sessões da partida(ex: exportação em colunas).
+/// @param void. Contexto do observador.
+/// @param Sessao. Ponteiro da sessão do jogador, após a ação. Somente leitura.
+/// @param CodigoAcao. Ação aplicada.
+/// @param ResultadoAcao. Resultado da ação.
+/// @param RegistroAcao. Detalhes da ação(preenchidos somente com sucesso). Somente leitura.
+typedef void (*ObservadorVersus)(void* contexto, const Sessao* sessao, CodigoAcao acao, ResultadoAcao resultado,
+	const RegistroAcao* registro);
+
+/// @brief Resultado de uma partida.
+typedef struct {
+	/// @brief Índice do vencedor(0 ou 1), ou -1 em caso de empate(derrota simultânea ou limite de passos).
+	int vencedor;
+	int passos;
+	int64_t pontos[2];
+	int32_t linhasEnviadas[2];
+} ResultadoVersus;
+
+/// @brief Partida versus em andamento. As sessões referenciam os geradores dos jogadores: a partida
+/// não deve ser copiada após a inicialização.
+typedef struct {
+	Jogador jogadores[2];
+	/// @brief Estado do sorteio das colunas dos buracos do lixo.
+	uint64_t sorteio;
+	int passos;
+	/// @brief Observador opcional das ações(NULL após a inicialização), e o seu contexto.
+	ObservadorVersus observador;
+	void* contextoObservador;
+} Versus;
+
+// **** Declarações das funções. ****
+
+/// @brief Inicializa uma partida versus.
+/// @param Versus. Ponteiro via referência, para efetuar a inicialização.
+/// @param Inteiro. Semente da partida(peças e buracos do lixo).
+void inicializarVersus(Versus* versus, uint64_t semente);
+/// @brief Aplica uma ação a um jogador, e efetua as consequências no tabuleiro e nos ataques.
+/// @param Versus. Ponteiro via referência, da partida.
+/// @param Inteiro. Índice do jogador(0 ou 1).
+/// @param CodigoAcao. Ação a ser aplicada.
+/// @returns ResultadoAcao. Resultado da ação na sessão do jogador.
+ResultadoAcao aplicarAcaoVersus(Versus* versus, int jogador, CodigoAcao acao);
+/// @brief Executa uma partida completa, sem interface.
+/// @param Versus. Ponteiro via referência, da partida(já inicializada).
+/// @param Estrategia. Estratégias dos jogadores 0 e 1.
+/// @param void. Contextos das estratégias dos jogadores 0 e 1(podem ser NULL).
+/// @param Inteiro. Quantidade máxima de passos(uma ação de cada jogador por passo).
+/// @returns ResultadoVersus. Resultado da partida.
+ResultadoVersus executarPartidaVersus(Versus* versus, Estrategia estrategias[2], void* contextos[2], int limitePassos);
+/// @brief Insere linhas de lixo por baixo do tabuleiro.
+/// @param Tabuleiro. Ponteiro via referência, do tabuleiro.
+/// @param Inteiro. Quantidade de linhas.
+/// @param Inteiro. Coluna do buraco.
+/// @returns Verdadeiro(true), se o tabuleiro comportou o lixo. Falso(false), se excedeu a altura(derrota).
+bool inserirLixo(Tabuleiro* tabuleiro, int linhas, int buraco);
+
+// **** Estratégias de referência. ****
+
+/// @brief Estratégia aleatória. Contexto: ponteiro para o estado do sorteio(uint64_t, diferente de zero).
+CodigoAcao estrategiaAleatoria(const Jogador* proprio, const Jogador* oponente, void* contexto);
+/// @brief Estratégia gulosa: coloca a peça que completa uma linha, se houver(na frente da fila ou no topo
+/// da pilha). Caso contrário, reserva a peça da frente enquanto houver espaço na pilha. Sem contexto.
+CodigoAcao estrategiaGulosa(const Jogador* proprio, const Jogador* oponente, void* contexto);
+
+#endif // TETRIS_VERSUS_H